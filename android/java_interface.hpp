@@ -10,10 +10,10 @@ extern "C" {
 /*
  * Class:     cz_fmo_Lib
  * Method:    detectionStart
- * Signature: (IIIZLcz/fmo/Lib/Callback;)V
+ * Signature: (IIIZFZLcz/fmo/Lib/Callback;)V
  */
 JNIEXPORT void JNICALL Java_cz_fmo_Lib_detectionStart
-  (JNIEnv *, jclass, jint, jint, jint, jboolean, jobject);
+  (JNIEnv *, jclass, jint, jint, jint, jboolean, jfloat, jboolean, jobject);
 
 /*
  * Class:     cz_fmo_Lib
@@ -1,25 +1,64 @@
 #include "env.hpp"
 #include "java_classes.hpp"
+#include <algorithm>
 #include <atomic>
 #include <fmo/exchange.hpp>
 #include <fmo/processing.hpp>
 #include <fmo/stats.hpp>
 #include <iomanip>
 #include <thread>
+#include <vector>
 
 namespace {
     struct {
         std::mutex mutex;
         JavaVM* javaVM;
         std::atomic<bool> stop;
-        std::unique_ptr<fmo::Exchange<fmo::Image>> exchange;
+        std::thread thread;
+        std::unique_ptr<fmo::TripleExchange<fmo::Image>> exchange;
         Reference<Callback> callbackRef;
-        fmo::Image image;
         fmo::Dims dims;
         fmo::Format format;
         fmo::Algorithm::Config config;
+        std::mutex sharedMutex;
+        std::vector<jbyteArray> shared; ///< global references to arrays adopted by images
+        bool copyFrames;                ///< unless adoption was requested or after recycling
     } global;
 
+    /// Checks whether an image still refers to the array.
+    bool isShared(JNIEnv* env, jbyteArray array) {
+        std::lock_guard<std::mutex> lock(global.sharedMutex);
+        for (auto ref : global.shared) {
+            if (env->IsSameObject(ref, array)) return true;
+        }
+        return false;
+    }
+
+    /// Hands an adopted array back to Java. Called by whichever thread drops the image; a thread
+    /// that is not attached to the VM is attached for the duration of the call.
+    void releaseArray(jbyteArray array, jbyte* data) {
+        {
+            std::lock_guard<std::mutex> lock(global.sharedMutex);
+            auto& shared = global.shared;
+            shared.erase(std::remove(shared.begin(), shared.end(), array), shared.end());
+        }
+
+        auto release = [array, data](JNIEnv* env) {
+            env->ReleaseByteArrayElements(array, data, JNI_ABORT);
+            env->DeleteGlobalRef(array);
+        };
+
+        JNIEnv* env = nullptr;
+        jint status = global.javaVM->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6);
+        if (status == JNI_EDETACHED) {
+            Env attached{global.javaVM, "Lib release"};
+            release(attached.get());
+        } else {
+            FMO_ASSERT(status == JNI_OK, "GetEnv failed");
+            release(env);
+        }
+    }
+
     std::string statsString(const fmo::SectionStats& stats) {
         auto q = stats.quantilesMs();
         std::ostringstream oss;
@@ -29,21 +68,41 @@ namespace {
         return oss.str();
     }
 
+    std::string exchangeString(const fmo::TripleExchange<fmo::Image>& exchange,
+                               const fmo::Stats& latency) {
+        std::ostringstream oss;
+        oss << "handoff: " << std::fixed << std::setprecision(1)
+            << (double(latency.quantiles().q50) / 1e3) << " us, dropped "
+            << exchange.numDropped() << " of " << exchange.numSent();
+        return oss.str();
+    }
+
+    std::string stagesString(const fmo::Profiler& profiler) {
+        std::ostringstream oss;
+        profiler.print(oss);
+        return oss.str();
+    }
+
     void threadImpl() {
         Env threadEnv{global.javaVM, "Lib"};
         JNIEnv* env = threadEnv.get();
         fmo::FrameStats frameStats;
         frameStats.reset(30);
         fmo::SectionStats sectionStats;
+        fmo::Stats latencyStats{100};
+        int64_t sendNs = 0;
         fmo::Image input{global.format, global.dims};
         fmo::Algorithm::Output output;
         auto explorer = fmo::Algorithm::make(global.config, global.format, global.dims);
+        explorer->setProfiling(true);
+        int numSwitches = 0;
         Callback callback = global.callbackRef.get(env);
         callback.log("Detection started");
 
         while (!global.stop) {
-            global.exchange->swapReceive(input);
+            if (!global.exchange->swapReceive(input, &sendNs)) break;
             if (global.stop) break;
+            latencyStats.add(fmo::nanoTime() - sendNs);
 
             frameStats.tick();
             sectionStats.start();
@@ -54,6 +113,19 @@ namespace {
             if (statsUpdated) {
                 std::string stats = statsString(sectionStats);
                 callback.log(stats.c_str());
+                std::string handoff = exchangeString(*global.exchange, latencyStats);
+                callback.log(handoff.c_str());
+                std::string stages = stagesString(explorer->getProfiler());
+                callback.log(stages.c_str());
+            }
+
+            auto& governor = explorer->getGovernor();
+            if (governor.numSwitches() != numSwitches) {
+                numSwitches = governor.numSwitches();
+                std::ostringstream oss;
+                oss << "Processing level " << governor.lastSwitch().oldLevel << " -> "
+                    << governor.lastSwitch().newLevel;
+                callback.log(oss.str().c_str());
             }
 
             if (!output.detections.empty()) {
@@ -75,23 +147,31 @@ namespace {
     bool running() { return bool(global.exchange); }
 }
 
+/// @param adoptFrames Whether camera arrays are handed to the detection thread without copying.
+/// An adopted array is held until the algorithm drops the image, which may take several frames,
+/// so the caller may only pass this if it re-queues a camera buffer once the array has been
+/// released, never right after onPreviewFrame() returns. Otherwise, frames are copied.
 void Java_cz_fmo_Lib_detectionStart(JNIEnv* env, jclass, jint width, jint height, jint procRes,
-                                    jboolean gray, jobject cbObj) {
+                                    jboolean gray, jfloat latencyBudget, jboolean adoptFrames,
+                                    jobject cbObj) {
     initJavaClasses(env);
 
     std::unique_lock<std::mutex> lock(global.mutex);
+    if (running()) return;
     global.config.maxImageHeight = procRes;
+    global.config.latencyBudget = latencyBudget;
     global.format = (gray != 0) ? fmo::Format::GRAY : fmo::Format::YUV420SP;
     global.dims = {width, height};
     env->GetJavaVM(&global.javaVM);
     global.stop = false;
-    global.exchange.reset(new fmo::Exchange<fmo::Image>(global.format, global.dims));
+    global.copyFrames = (adoptFrames == 0);
+    // only the freshest frame is worth detecting in, and the camera thread must never block;
+    // unlike fmo::Queue, which locks a mutex and hands out frames in order, the exchange
+    // publishes with a single CAS and always delivers the latest frame
+    global.exchange.reset(new fmo::TripleExchange<fmo::Image>(global.format, global.dims));
     global.callbackRef = {env, cbObj};
 
-    std::thread thread(threadImpl);
-    thread.detach();
-
-    global.image.resize(global.format, global.dims);
+    global.thread = std::thread(threadImpl);
 }
 
 void Java_cz_fmo_Lib_detectionStop(JNIEnv* env, jclass) {
@@ -99,14 +179,44 @@ void Java_cz_fmo_Lib_detectionStop(JNIEnv* env, jclass) {
     if (!running()) return;
     global.stop = true;
     global.exchange->exit();
+
+    // the detection thread releases its image and the callback before it ends; destroying the
+    // exchange releases the arrays held by its buffers
+    global.thread.join();
+    global.exchange.reset();
+    FMO_ASSERT(global.shared.empty(), "camera arrays leaked");
 }
 
 void Java_cz_fmo_Lib_detectionFrame(JNIEnv* env, jclass, jbyteArray dataYUV420SP) {
     std::unique_lock<std::mutex> lock(global.mutex);
     if (!running()) return;
+
+    // adoption relies on the caller not re-queuing arrays that an image still refers to; if such
+    // an array arrives again, the contract has been broken, and frames are copied from then on
+    if (!global.copyFrames && isShared(env, dataYUV420SP)) {
+        global.copyFrames = true;
+        Callback callback = global.callbackRef.get(env);
+        callback.log("Camera buffers re-queued while in use, copying frames");
+    }
+
     jbyte* dataJ = env->GetByteArrayElements(dataYUV420SP, nullptr);
     uint8_t* data = reinterpret_cast<uint8_t*>(dataJ);
-    global.image.assign(global.format, global.dims, data);
-    global.exchange->swapSend(global.image);
-    env->ReleaseByteArrayElements(dataYUV420SP, dataJ, JNI_ABORT);
+    if (global.copyFrames) {
+        global.exchange->sendBuffer().assign(global.format, global.dims, data);
+        global.exchange->send();
+        env->ReleaseByteArrayElements(dataYUV420SP, dataJ, JNI_ABORT);
+        return;
+    }
+
+    // hand the array over without copying; it is released by whichever thread drops the image
+    auto array = static_cast<jbyteArray>(env->NewGlobalRef(dataYUV420SP));
+    {
+        std::lock_guard<std::mutex> sharedLock(global.sharedMutex);
+        global.shared.push_back(array);
+    }
+    auto release = [array, dataJ](uint8_t*) { releaseArray(array, dataJ); };
+
+    // publishing the back buffer never waits for the detection thread
+    global.exchange->sendBuffer().adopt(global.format, global.dims, data, release);
+    global.exchange->send();
 }
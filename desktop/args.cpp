@@ -1,5 +1,6 @@
 #include "args.hpp"
 #include <iostream>
+#include <sstream>
 
 namespace {
     using doc_t = const char* const;
@@ -26,27 +27,38 @@ namespace {
                     "used at all, this option must be used as many times as --input.";
     doc_t baselineDoc = "<path> File with previously saved results (via --eval-dir) for "
                         "comparison. When used, the playback will pause to demonstrate where the "
-                        "results differ. Must be used with --gt.";
+                        "results differ. Must be used with --gt or --scene.";
     doc_t cameraDoc = "<int> Input camera device ID. When this option is used, stream from the "
                       "specified camera will be used as input. Using ID 0 selects the default "
                       "camera, if available. Must not be used with --input, --wait, --fast, "
                       "--frame, --pause.";
-    doc_t yuvDoc = "Feed image data into the algorithm in YCbCr color space.";
+    doc_t sceneDoc = "<int> Use a generated scene with the specified number of fast-moving objects "
+                     "as the input. The ground truth is generated as well, which enables quality "
+                     "evaluation. Must not be used with --input, --camera, --gt.";
+    doc_t sceneSizeDoc = "<string> Dimensions of the generated scene, e.g. 1920x1080. Must be used "
+                         "with --scene.";
+    doc_t sceneFramesDoc = "<int> Number of frames of the generated scene. Must be used with "
+                           "--scene.";
+    doc_t sceneSeedDoc = "<int> Seed that determines the background, the initial positions and "
+                         "the motion of the objects in the generated scene. Must be used with "
+                         "--scene.";
+    doc_t yuvDoc = "Process image data in YCbCr color space. The conversion is performed while "
+                   "the input is being downscaled.";
     doc_t recordDirDoc = "<dir> Output directory to save video to. A new video file will be "
                          "created, storing the unmodified input video. The name of the video file "
                          "will be determined by system time. The directory must exist.";
     doc_t evalDirDoc = "<dir> Directory to save evaluation report to. A single file text file will "
                        "be created there with a unique name based on timestamp. Must be used with "
-                       "--gt.";
+                       "--gt or --scene.";
     doc_t texDoc = "Format tables in the evaluation report so that they can be used in the TeX "
                    "typesetting system. Must be used with --eval-dir.";
     doc_t detectDirDoc = "<dir> Directory to save detection output to. A single XML file will be "
                          "created there with a unique name based on timestamp.";
     doc_t scoreFileDoc = "<file> File to write a numeric evaluation score to.";
     doc_t pauseFpDoc = "Playback will pause whenever a detection is deemed a false positive. Must "
-                       "be used with --gt.";
+                       "be used with --gt or --scene.";
     doc_t pauseFnDoc = "Playback will pause whenever a detection is deemed a false negative. Must "
-                       "be used with --gt.";
+                       "be used with --gt or --scene.";
     doc_t pauseRgDoc = "Playback will pause whenever a regression is detected, i.e. whenever a "
                        "frame is evaluated as false and baseline is true. Must be used with "
                        "--baseline.";
@@ -62,10 +74,24 @@ namespace {
                     "with --camera, --headless.";
     doc_t waitDoc = "<ms> Specifies the frame time in milliseconds, allowing for slow playback. "
                     "Must not be used with --camera, --headless.";
+    doc_t profileDoc = "Measure the duration of each processing stage of the algorithm. A "
+                       "breakdown and the memory held by the algorithm are printed after each "
+                       "input has been processed.";
+    doc_t traceFileDoc = "<file> Record a timeline of processing stages, kernel jobs and video "
+                         "encoding, and write it to a file in the Chrome trace-event format, "
+                         "viewable at chrome://tracing.";
+    doc_t profileCountersDoc = "Add hardware performance counters (cycles, instructions per "
+                               "cycle, last-level cache misses) to the breakdown printed by "
+                               "--profile. Only the processing thread is counted. Implies "
+                               "--profile.";
+    doc_t hugePagesDoc = "Back large image buffers, e.g. full-resolution frames, with 2 MB huge "
+                         "pages where the operating system permits it. Reduces TLB misses with "
+                         "high-resolution inputs.";
     doc_t paramDocI = "<int>";
     doc_t paramDocB = "<flag>";
     doc_t paramDocF = "<float>";
     doc_t paramDocUint8 = "<uint8>";
+    doc_t paramDocS = "<string>";
 }
 
 Args::Args(int argc, char** argv)
@@ -73,6 +99,10 @@ Args::Args(int argc, char** argv)
       gts(),
       names(),
       camera(-1),
+      scene(0),
+      sceneSize("1280x720"),
+      sceneFrames(300),
+      sceneSeed(1),
       yuv(false),
       recordDir("."),
       pauseFn(false),
@@ -87,6 +117,9 @@ Args::Args(int argc, char** argv)
       headless(false),
       demo(false),
       debug(false),
+      profile(false),
+      profileCounters(false),
+      hugePages(false),
       params(),
       mParser(),
       mHelp(false),
@@ -104,6 +137,7 @@ Args::Args(int argc, char** argv)
     mParser.add("--headless", headlessDoc, headless);
     mParser.add("--demo", demoDoc, demo);
     mParser.add("--debug", debugDoc, debug);
+    mParser.add("--huge-pages", hugePagesDoc, hugePages);
     mParser.add("\nInput:");
     mParser.add("--include", includeDoc, [this](const std::string& path) { mParser.parse(path); });
     mParser.add("--input", inputDoc, inputs);
@@ -111,6 +145,10 @@ Args::Args(int argc, char** argv)
     mParser.add("--name", nameDoc, names);
     mParser.add("--baseline", baselineDoc, baseline);
     mParser.add("--camera", cameraDoc, camera);
+    mParser.add("--scene", sceneDoc, scene);
+    mParser.add("--scene-size", sceneSizeDoc, sceneSize);
+    mParser.add("--scene-frames", sceneFramesDoc, sceneFrames);
+    mParser.add("--scene-seed", sceneSeedDoc, sceneSeed);
     mParser.add("--yuv", yuvDoc, yuv);
     mParser.add("\nOutput:");
     mParser.add("--record-dir", recordDirDoc, recordDir);
@@ -118,6 +156,12 @@ Args::Args(int argc, char** argv)
     mParser.add("--tex", texDoc, tex);
     mParser.add("--detect-dir", detectDirDoc, detectDir);
     mParser.add("--score-file", scoreFileDoc, scoreFile);
+    mParser.add("--profile", profileDoc, profile);
+    mParser.add("--profile-counters", profileCountersDoc, [this]() {
+        profile = true;
+        profileCounters = true;
+    });
+    mParser.add("--trace-file", traceFileDoc, traceFile);
     mParser.add("\nPlayback control:");
     mParser.add("--pause-fp", pauseFpDoc, pauseFp);
     mParser.add("--pause-fn", pauseFnDoc, pauseFn);
@@ -139,6 +183,11 @@ Args::Args(int argc, char** argv)
     mParser.add("--p-max-gap-x", paramDocF, params.maxGapX);
     mParser.add("--p-min-gap-y", paramDocF, params.minGapY);
     mParser.add("--p-max-image-height", paramDocI, params.maxImageHeight);
+    mParser.add("--p-latency-budget", paramDocF, params.latencyBudget);
+    mParser.add("--p-latency-hysteresis", paramDocF, params.latencyHysteresis);
+    mParser.add("--p-lean-memory", paramDocB, params.leanMemory);
+    mParser.add("--p-flight-recorder-threshold", paramDocF, params.flightRecorderThreshold);
+    mParser.add("--p-flight-recorder-dir", paramDocS, params.flightRecorderDir);
     mParser.add("--p-min-strip-height", paramDocI, params.minStripHeight);
     mParser.add("--p-min-strips-in-object", paramDocI, params.minStripsInObject);
     mParser.add("--p-min-strip-area", paramDocF, params.minStripArea);
@@ -200,9 +249,30 @@ Args::Args(int argc, char** argv)
     validate();
 }
 
+fmo::Dims Args::sceneDims() const {
+    fmo::Dims dims{0, 0};
+    char x = 0;
+    std::istringstream in{sceneSize};
+    in >> dims.width >> x >> dims.height;
+    if (!in || x != 'x' || dims.width < 2 || dims.height < 2) { return {0, 0}; }
+    return dims;
+}
+
 void Args::validate() const {
-    if (inputs.empty() && camera == -1) {
-        throw std::runtime_error("one of --input, --camera must be specified");
+    if (inputs.empty() && camera == -1 && scene == 0) {
+        throw std::runtime_error("one of --input, --camera, --scene must be specified");
+    }
+    if (scene != 0) {
+        if (!inputs.empty() || camera != -1) {
+            throw std::runtime_error("--scene cannot be used with --input or --camera");
+        }
+        if (!gts.empty()) { throw std::runtime_error("--scene cannot be used with --gt"); }
+        if (scene < 0 || sceneFrames < 1) {
+            throw std::runtime_error("--scene and --scene-frames must be positive");
+        }
+        if (sceneDims().width == 0) {
+            throw std::runtime_error("--scene-size must have the form WxH, e.g. 1280x720");
+        }
     }
     if (camera != -1) {
         if (!inputs.empty()) { throw std::runtime_error("--camera cannot be used with --input"); }
@@ -225,12 +295,16 @@ void Args::validate() const {
             throw std::runtime_error("there must be one --name for each --input");
         }
     }
-    if (gts.empty()) {
+    if (gts.empty() && scene == 0) {
         if (pauseFn || pauseFp) {
-            throw std::runtime_error("--pause-fn|fp must be used with --gt");
+            throw std::runtime_error("--pause-fn|fp must be used with --gt or --scene");
+        }
+        if (!evalDir.empty()) {
+            throw std::runtime_error("--eval-dir must be used with --gt or --scene");
+        }
+        if (!baseline.empty()) {
+            throw std::runtime_error("--baseline must be used with --gt or --scene");
         }
-        if (!evalDir.empty()) { throw std::runtime_error("--eval-dir must be used with --gt"); }
-        if (!baseline.empty()) { throw std::runtime_error("--baseline must be used with --gt"); }
     }
     if (baseline.empty()) {
         if (pauseRg || pauseIm) {
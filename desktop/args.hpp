@@ -13,6 +13,10 @@ struct Args {
     std::vector<std::string> gts;    ///< paths to ground truth text files, enables evaluation
     std::vector<std::string> names;  ///< names of inputs to be displayed in the report table
     int camera;                      ///< camera ID to use as input
+    int scene;                       ///< number of objects in a generated scene to use as input
+    std::string sceneSize;           ///< dimensions of the generated scene
+    int sceneFrames;                 ///< number of frames of the generated scene
+    int sceneSeed;                   ///< random seed of the generated scene
     bool yuv;                        ///< force YCbCr color space
     std::string recordDir;           ///< directory to save recording to
     bool pauseFn;                    ///< pause when a false negative is encountered
@@ -22,6 +26,7 @@ struct Args {
     std::string evalDir;             ///< path to evaluation results directory
     std::string detectDir;           ///< path to detection output directory
     std::string scoreFile;           ///< path to evaluation score file
+    std::string traceFile;           ///< path to trace output file, enables tracing
     std::string baseline;            ///< path to previously saved results file, enables comparison
     int frame;                       ///< frame number to pause at
     int wait;                        ///< frame time in milliseconds
@@ -29,8 +34,15 @@ struct Args {
     bool headless;                   ///< don't draw GUI unless the playback is paused
     bool demo;                       ///< force demo visualizer
     bool debug;                      ///< force debug visualizer
+    bool profile;                    ///< measure and print processing stage durations
+    bool profileCounters;            ///< add hardware performance counters to the profile
+    bool hugePages;                  ///< back large image buffers with huge pages
     fmo::Algorithm::Config params;   ///< algorithm parameters
 
+    /// Parses the dimensions of the generated scene. Returns zero dimensions if the value of
+    /// --scene-size is malformed.
+    fmo::Dims sceneDims() const;
+
     /// Print all parameters to a stream, separated by the provided character.
     void printParameters(std::ostream& out, char sep) const { mParser.printValues(out, sep); }
 
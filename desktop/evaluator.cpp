@@ -210,7 +210,17 @@ Evaluator::~Evaluator() {
 Evaluator::Evaluator(const std::string& gtFilename, fmo::Dims dims, Results& results,
                      const Results& baseline) {
     mGt.loadGroundTruth(gtFilename, dims);
-    mName = extractSequenceName(gtFilename);
+    init(extractSequenceName(gtFilename), results, baseline);
+}
+
+Evaluator::Evaluator(std::istream& gt, const std::string& name, fmo::Dims dims,
+                     Results& results, const Results& baseline) {
+    mGt.loadGroundTruth(gt, dims);
+    init(name, results, baseline);
+}
+
+void Evaluator::init(const std::string& name, Results& results, const Results& baseline) {
+    mName = name;
     mFile = &results.newFile(mName);
     mFile->frames.reserve(mGt.numFrames());
 
@@ -234,18 +244,6 @@ void Evaluator::evaluateFrame(const fmo::Algorithm::Output& dt, int frameNum, Ev
         throw std::runtime_error("movie length inconsistent with GT");
     }
 
-    auto iou = [this](const fmo::PointSet& ps1, const fmo::PointSet& ps2) {
-        int intersection = 0;
-        int union_ = 0;
-        auto mismatch = [&](fmo::Pos) { union_++; };
-        auto match = [&](fmo::Pos) {
-            intersection++;
-            union_++;
-        };
-        fmo::pointSetCompare(ps1, ps2, mismatch, mismatch, match);
-        return double(intersection) / double(union_);
-    };
-
     auto& gt = mGt.get(mFrameNum);
 
     // try each GT object with each detected object, store max IOU
@@ -254,11 +252,11 @@ void Evaluator::evaluateFrame(const fmo::Algorithm::Output& dt, int frameNum, Ev
     out.iouGt.resize(gt.size(), 0.);
     for (size_t i = 0; i < out.iouDt.size(); i++) {
         auto& dtScore = out.iouDt[i];
-        dt.detections[i]->getPoints(mPointsCache);
+        dt.detections[i]->getSpans(mSpansCache);
         for (size_t j = 0; j < out.iouGt.size(); j++) {
             auto& gtScore = out.iouGt[j];
             auto& gtSet = gt[j];
-            auto score = iou(gtSet, mPointsCache);
+            auto score = fmo::spanSetIou(gtSet, mSpansCache);
             gtScore = std::max(gtScore, score);
             dtScore = std::max(dtScore, score);
         }
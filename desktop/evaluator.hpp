@@ -125,6 +125,11 @@ struct Evaluator {
     Evaluator(const std::string& gtFilename, fmo::Dims dims, Results& results,
               const Results& baseline);
 
+    /// Reads the ground truth from a stream instead of a file. The results are stored under the
+    /// provided sequence name.
+    Evaluator(std::istream& gt, const std::string& name, fmo::Dims dims, Results& results,
+              const Results& baseline);
+
     /// Decides whether the algorithm has been successful by comparing the objects it has provided
     /// with the ground truth. The frames must be provided in an increasing order, starting with
     /// frame number 1.
@@ -134,13 +139,15 @@ struct Evaluator {
     const ObjectSet& gt() const { return mGt; }
 
 private:
+    void init(const std::string& name, Results& results, const Results& baseline);
+
     // data
     int mFrameNum = 0;
     FileResults* mFile;
     const FileResults* mBaseline;
     ObjectSet mGt;
     std::string mName;
-    fmo::PointSet mPointsCache;
+    fmo::SpanSet mSpansCache;
 };
 
 /// Extracts filename from path.
@@ -1,11 +1,16 @@
 #include "loop.hpp"
+#include <fmo/trace.hpp>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
 
 int main(int argc, char** argv) try {
     Status s{argc, argv};
 
+    if (s.args.hugePages) { fmo::setAllocPolicy(fmo::AllocPolicy::HUGE_PAGES); }
+    if (!s.args.traceFile.empty()) { fmo::Trace::enable(true); }
     if (!s.args.baseline.empty()) { s.baseline.load(s.args.baseline); }
-    if (s.haveCamera()) { s.args.inputs.emplace_back(); }
+    if (s.haveCamera() || s.haveScene()) { s.args.inputs.emplace_back(); }
     if (!s.args.detectDir.empty()) { s.rpt.reset(new DetectionReport(s.args.detectDir, s.date)); }
 
     // select visualizer
@@ -34,6 +39,13 @@ int main(int argc, char** argv) try {
     report.write(std::cout);
     if (!s.args.evalDir.empty()) { report.save(s.args.evalDir); }
     if (!s.args.scoreFile.empty()) { report.saveScore(s.args.scoreFile); }
+
+    if (!s.args.traceFile.empty()) {
+        fmo::Trace::enable(false);
+        std::ofstream out{s.args.traceFile};
+        if (!out) { throw std::runtime_error("failed to open trace file"); }
+        fmo::Trace::writeJson(out);
+    }
 } catch (std::exception& e) {
     std::cerr << "error: " << e.what() << '\n';
     std::cerr << "tip: use --help to see a list of available commands\n";
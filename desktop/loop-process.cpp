@@ -2,26 +2,53 @@
 #include "objectset.hpp"
 #include "video.hpp"
 #include <fmo/processing.hpp>
+#include <fmo/scene.hpp>
 #include <fmo/stats.hpp>
+#include <fmo/trace.hpp>
+#include <iostream>
+#include <sstream>
 
 namespace {
     const std::vector<fmo::PointSet> noObjects;
 }
 
 void processVideo(Status& s, size_t inputNum) {
-    // open input
-    auto input = (!s.haveCamera()) ? VideoInput::makeFromFile(s.args.inputs.at(inputNum))
-                                   : VideoInput::makeFromCamera(s.args.camera);
-    auto dims = input->dims();
-    float fps = input->fps();
-    s.inputName = (!s.haveCamera()) ? extractFilename(s.args.inputs.at(inputNum))
-                                    : "camera " + std::to_string(s.args.camera);
+    // open input, or set up a generated scene
+    std::unique_ptr<VideoInput> input;
+    std::unique_ptr<fmo::SceneGenerator> scene;
+    fmo::Dims dims;
+    float fps;
+    if (s.haveScene()) {
+        fmo::SceneGenerator::Config config;
+        config.dims = s.args.sceneDims();
+        config.numObjects = s.args.scene;
+        config.seed = uint32_t(s.args.sceneSeed);
+        scene = std::make_unique<fmo::SceneGenerator>(config);
+        dims = config.dims;
+        fps = 30.f;
+        s.inputName = "scene-" + std::to_string(s.args.scene);
+    } else {
+        input = (!s.haveCamera()) ? VideoInput::makeFromFile(s.args.inputs.at(inputNum))
+                                  : VideoInput::makeFromCamera(s.args.camera);
+        dims = input->dims();
+        fps = input->fps();
+        s.inputName = (!s.haveCamera()) ? extractFilename(s.args.inputs.at(inputNum))
+                                        : "camera " + std::to_string(s.args.camera);
+    }
 
     // open GT
     std::unique_ptr<Evaluator> evaluator;
     if (!s.args.gts.empty()) {
         evaluator =
             std::make_unique<Evaluator>(s.args.gts.at(inputNum), dims, s.results, s.baseline);
+    } else if (scene) {
+        // simulate the scene in advance to obtain its ground truth
+        fmo::SceneGenerator simulation{scene->config()};
+        std::vector<std::vector<fmo::SpanSet>> truth(size_t(s.args.sceneFrames));
+        for (auto& objects : truth) { simulation.next(objects); }
+        std::stringstream gt;
+        fmo::writeGroundTruth(gt, dims, truth);
+        evaluator = std::make_unique<Evaluator>(gt, s.inputName, dims, s.results, s.baseline);
     }
 
     // write sequence
@@ -35,14 +62,25 @@ void processVideo(Status& s, size_t inputNum) {
     }
 
     // setup caches
-    fmo::Format format = s.args.yuv ? fmo::Format::YUV : fmo::Format::BGR;
+    // with --yuv, the algorithm converts the input while decimating it
+    fmo::Algorithm::Config params = s.args.params;
+    if (s.args.yuv) { params.processingFormat = fmo::Format::YUV; }
     std::vector<fmo::PointSet> objectVec;
     objectVec.resize(1);
-    auto algorithm = fmo::Algorithm::make(s.args.params, format, dims);
-    fmo::Region frame;
-    fmo::Image frameCopy{format, dims};
+    auto algorithm = fmo::Algorithm::make(params, fmo::Format::BGR, dims);
+    algorithm->setProfiling(s.args.profile);
+    if (s.args.profileCounters && !algorithm->setProfilingCounters(true)) {
+        std::cerr << "warning: hardware performance counters are not available\n";
+    }
+    fmo::FramePool framePool{fmo::Format::BGR, dims};
+    fmo::Frame frame;
+    fmo::Region captured;
+    const fmo::Mat* source = nullptr;
     fmo::Algorithm::Output outputCache;
+    std::vector<fmo::SpanSet> sceneTruth;
     EvalResult evalResult;
+    int numSwitches = 0;
+    int numDumps = 0;
     s.inFrameNum = 1;
     s.outFrameNum = 1 + algorithm->getOutputOffset();
 
@@ -60,20 +98,51 @@ void processVideo(Status& s, size_t inputNum) {
             }
         }
 
-        // read video
+        // read video, or render the next frame of the scene
         if (allowNewFrames) {
-            frame = input->receiveFrame();
-            if (frame.data() == nullptr) {
-                // end the loop unconditionally when a new frame is needed but is not available
-                break;
+            fmo::TraceSpan span{"receiveFrame"};
+            if (scene) {
+                frame = framePool.publish(
+                    [&](fmo::Image& image) { scene->next(image, sceneTruth); });
+                source = &frame.image();
+            } else {
+                frame.reset();
+                captured = input->receiveFrame();
+                if (captured.data() == nullptr) {
+                    // end the loop unconditionally when a new frame is needed but is not available
+                    break;
+                }
+                source = &captured;
             }
         }
 
-        // process
-        fmo::convert(frame, frameCopy, format);
-        algorithm->setInputSwap(frameCopy);
+        // the debug image needs a copy of the input; keep one only if the frame may be shown
+        bool seeking = s.haveFrame() && s.args.frame != s.inFrameNum;
+        bool mayPause = s.args.pauseFn || s.args.pauseFp || s.args.pauseRg || s.args.pauseIm;
+        bool shown = !seeking && (!s.args.headless || s.paused || mayPause);
+        algorithm->setKeepInput(shown && s.visualizer->showsDebugImage());
+
+        // process, letting the algorithm read the frame in place
+        algorithm->setInputView(*source);
         algorithm->getOutput(outputCache);
 
+        // report changes of the processing level
+        auto& governor = algorithm->getGovernor();
+        if (governor.numSwitches() != numSwitches) {
+            numSwitches = governor.numSwitches();
+            auto& sw = governor.lastSwitch();
+            std::cout << s.inputName << ": frame " << s.inFrameNum << ": processing level "
+                      << sw.oldLevel << " -> " << sw.newLevel << " (q95 " << sw.q95Ms << " ms)\n";
+        }
+
+        // report frames captured by the flight recorder
+        auto& flightRecorder = algorithm->getFlightRecorder();
+        if (flightRecorder.numDumps() != numDumps) {
+            numDumps = flightRecorder.numDumps();
+            std::cout << s.inputName << ": frame " << s.inFrameNum << ": slow frame saved to "
+                      << flightRecorder.lastDump() << '\n';
+        }
+
         // evaluate
         if (evaluator) {
             if (s.outFrameNum >= 1) {
@@ -103,7 +172,21 @@ void processVideo(Status& s, size_t inputNum) {
         // skip visualization if in headless mode (but not paused)
         if (s.args.headless && !s.paused) continue;
 
+        // publish a captured frame only when it is shown; it is shared by the visualizer and the
+        // recorders without further copies
+        if (!frame) {
+            frame = framePool.publish([&](fmo::Image& image) { fmo::copy(captured, image); });
+        }
+
         // visualize
+        fmo::TraceSpan span{"visualize"};
         s.visualizer->visualize(s, frame, evaluator.get(), evalResult, *algorithm);
     }
+
+    // print the duration of processing stages and the memory held by the algorithm
+    if (s.args.profile) {
+        std::cout << s.inputName << ":\n";
+        algorithm->getProfiler().print(std::cout);
+        std::cout << "image memory: " << (algorithm->getMemoryUsage() >> 10) << " KiB\n";
+    }
 }
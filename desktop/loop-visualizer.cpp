@@ -10,7 +10,7 @@ DebugVisualizer::DebugVisualizer(Status& s) {
     s.window.setBottomLine("[esc] quit | [space] pause | [enter] step | [,][.] jump 10 frames");
 }
 
-void DebugVisualizer::visualize(Status& s, const fmo::Region&, const Evaluator* evaluator,
+void DebugVisualizer::visualize(Status& s, const fmo::Frame&, const Evaluator* evaluator,
                                 const EvalResult& evalResult, fmo::Algorithm& algorithm) {
     // draw the debug image provided by the algorithm
     fmo::copy(algorithm.getDebugImage(), mVis);
@@ -19,22 +19,22 @@ void DebugVisualizer::visualize(Status& s, const fmo::Region&, const Evaluator*
 
     // get pixel coordinates of detected objects
     algorithm.getOutput(mOutputCache);
-    mObjectPoints.clear();
+    mObjectSpans.clear();
     for (auto& detection : mOutputCache.detections) {
-        mObjectPoints.emplace_back();
-        detection->getPoints(mObjectPoints.back());
+        mObjectSpans.emplace_back();
+        detection->getSpans(mObjectSpans.back());
     }
+    fmo::spanSetMerge(begin(mObjectSpans), end(mObjectSpans), mSpansCache);
 
     // draw detected points vs. ground truth
     if (evaluator != nullptr) {
         s.window.print(evalResult.str());
         auto& gt = evaluator->gt().get(s.outFrameNum);
-        fmo::pointSetMerge(begin(mObjectPoints), end(mObjectPoints), mPointsCache);
-        fmo::pointSetMerge(begin(gt), end(gt), mGtPointsCache);
-        drawPointsGt(mPointsCache, mGtPointsCache, mVis);
+        fmo::spanSetMerge(begin(gt), end(gt), mGtSpansCache);
+        drawSpansGt(mSpansCache, mGtSpansCache, mVis);
         s.window.setTextColor(good(evalResult.eval) ? Colour::green() : Colour::red());
     } else {
-        drawPoints(mPointsCache, mVis, Colour::lightMagenta());
+        drawSpans(mSpansCache, mVis, Colour::lightMagenta());
     }
 
     // display
@@ -149,7 +149,7 @@ void DemoVisualizer::drawSegments(fmo::Image& im) {
     }
 }
 
-void DemoVisualizer::visualize(Status& s, const fmo::Region& frame, const Evaluator*,
+void DemoVisualizer::visualize(Status& s, const fmo::Frame& frame, const Evaluator*,
                                const EvalResult&, fmo::Algorithm& algorithm) {
     // estimate FPS
     mStats.tick();
@@ -166,7 +166,7 @@ void DemoVisualizer::visualize(Status& s, const fmo::Region& frame, const Evalua
     mForcedEvent = false;
 
     // draw input image as background
-    fmo::copy(frame, mVis);
+    fmo::copy(frame.image(), mVis);
 
     // iterate over detected fast-moving objects
     for (auto& detection : mOutput.detections) { onDetection(s, *detection); }
@@ -186,8 +186,9 @@ void DemoVisualizer::visualize(Status& s, const fmo::Region& frame, const Evalua
     if (command == Command::AUTOMATIC_MODE) {
         if (mManual) { mManual.reset(nullptr); }
         if (!mAutomatic) {
-            mAutomatic = std::make_unique<AutomaticRecorder>(s.args.recordDir, frame.format(),
-                                                             frame.dims(), fpsEstimate());
+            auto& image = frame.image();
+            mAutomatic = std::make_unique<AutomaticRecorder>(s.args.recordDir, image.format(),
+                                                             image.dims(), fpsEstimate());
             updateHelp(s);
         }
     }
@@ -202,8 +203,9 @@ void DemoVisualizer::visualize(Status& s, const fmo::Region& frame, const Evalua
         if (mManual) {
             mManual.reset(nullptr);
         } else if (!mAutomatic) {
-            mManual = std::make_unique<ManualRecorder>(s.args.recordDir, frame.format(),
-                                                       frame.dims(), fpsEstimate());
+            auto& image = frame.image();
+            mManual = std::make_unique<ManualRecorder>(s.args.recordDir, image.format(),
+                                                       image.dims(), fpsEstimate());
         }
     }
     if (command == Command::PLAY_SOUNDS) { s.sound = !s.sound; }
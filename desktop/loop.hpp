@@ -7,6 +7,7 @@
 #include "report.hpp"
 #include "window.hpp"
 #include <fmo/algorithm.hpp>
+#include <fmo/frame.hpp>
 #include <fmo/retainer.hpp>
 #include <fmo/stats.hpp>
 
@@ -33,6 +34,7 @@ struct Status {
 
     Status(int argc, char** argv) : args(argc, argv) {}
     bool haveCamera() const { return args.camera != -1; }
+    bool haveScene() const { return args.scene != 0; }
     bool haveWait() const { return args.wait != -1; }
     bool haveFrame() const { return args.frame != -1; }
     void unsetFrame() { args.frame = -1; }
@@ -41,28 +43,34 @@ struct Status {
 void processVideo(Status& s, size_t inputNum);
 
 struct Visualizer {
-    virtual void visualize(Status& s, const fmo::Region& frame, const Evaluator* evaluator,
+    /// Checks whether the visualizer shows Algorithm::getDebugImage(), which draws the input only
+    /// if the algorithm keeps a copy of it, see Algorithm::setKeepInput().
+    virtual bool showsDebugImage() const { return false; }
+
+    virtual void visualize(Status& s, const fmo::Frame& frame, const Evaluator* evaluator,
                            const EvalResult& evalResult, fmo::Algorithm& algorithm) = 0;
 };
 
 struct DebugVisualizer : public Visualizer {
     DebugVisualizer(Status& s);
 
-    virtual void visualize(Status& s, const fmo::Region& frame, const Evaluator* evaluator,
+    virtual bool showsDebugImage() const override { return true; }
+
+    virtual void visualize(Status& s, const fmo::Frame& frame, const Evaluator* evaluator,
                            const EvalResult& evalResult, fmo::Algorithm& algorithm) override;
 
 private:
     fmo::Image mVis;
     fmo::Algorithm::Output mOutputCache;
-    fmo::Retainer<fmo::PointSet, 6> mObjectPoints;
-    fmo::PointSet mPointsCache;
-    fmo::PointSet mGtPointsCache;
+    fmo::Retainer<fmo::SpanSet, 6> mObjectSpans;
+    fmo::SpanSet mSpansCache;
+    fmo::SpanSet mGtSpansCache;
 };
 
 struct DemoVisualizer : public Visualizer {
     DemoVisualizer(Status& s);
 
-    virtual void visualize(Status& s, const fmo::Region& frame, const Evaluator* evaluator,
+    virtual void visualize(Status& s, const fmo::Frame& frame, const Evaluator* evaluator,
                            const EvalResult& evalResult, fmo::Algorithm& algorithm) override;
 
 private:
@@ -7,11 +7,18 @@
 
 void ObjectSet::loadGroundTruth(const std::string& filename, fmo::Dims dims) try {
     std::ios::sync_with_stdio(false);
+    std::ifstream in{filename};
+    if (!in) throw std::runtime_error("failed to parse file");
+    loadGroundTruth(in, dims);
+} catch (std::exception& e) {
+    std::cerr << "while loading file '" << filename << "'\n";
+    throw e;
+}
+
+void ObjectSet::loadGroundTruth(std::istream& in, fmo::Dims dims) {
     mFrames.clear();
 
     auto fail = []() { throw std::runtime_error("failed to parse file"); };
-    std::ifstream in{filename};
-    if (!in) fail();
     int aNumFrames, numObjects;
     in >> mDims.width >> mDims.height >> aNumFrames >> mOffset >> numObjects;
     if (!in) fail();
@@ -20,13 +27,15 @@ void ObjectSet::loadGroundTruth(const std::string& filename, fmo::Dims dims) try
         throw std::runtime_error("dimensions inconsistent with video");
     }
 
-    auto addPoints =
-        [ npt = dims.width * dims.height, dims ](fmo::PointSet & set, int first, int last) {
+    auto addSpans =
+        [ npt = dims.width * dims.height, dims ](fmo::SpanSet & set, int first, int last) {
         last = std::min(last, npt);
-        for (; first < last; first++) {
+        while (first < last) {
             int x = first % dims.width;
             int y = first / dims.width;
-            set.push_back({x, y});
+            int xEnd = std::min(dims.width, x + (last - first));
+            set.push_back({y, x, xEnd});
+            first += xEnd - x;
         }
     };
 
@@ -42,7 +51,7 @@ void ObjectSet::loadGroundTruth(const std::string& filename, fmo::Dims dims) try
         }
 
         auto& ptr = at(frameNum);
-        if (!ptr) { ptr = std::make_unique<std::vector<fmo::PointSet>>(); }
+        if (!ptr) { ptr = std::make_unique<std::vector<fmo::SpanSet>>(); }
         ptr->emplace_back();
         auto& set = ptr->back();
 
@@ -51,22 +60,20 @@ void ObjectSet::loadGroundTruth(const std::string& filename, fmo::Dims dims) try
         for (int j = 0; j < numRuns; j++) {
             int runLength;
             in >> runLength;
-            if (white) { addPoints(set, pos, pos + runLength); }
+            if (white) { addSpans(set, pos, pos + runLength); }
             pos += runLength;
             white = !white;
         }
 
-        if (white) { addPoints(set, pos, mDims.width * mDims.height); }
+        if (white) { addSpans(set, pos, mDims.width * mDims.height); }
+        fmo::spanSetNormalize(set);
 
         if (!in) fail();
     }
-} catch (std::exception& e) {
-    std::cerr << "while loading file '" << filename << "'\n";
-    throw e;
 }
 
-const std::vector<fmo::PointSet>& ObjectSet::get(int frameNum) const {
-    static const std::vector<fmo::PointSet> empty;
+const std::vector<fmo::SpanSet>& ObjectSet::get(int frameNum) const {
+    static const std::vector<fmo::SpanSet> empty;
     frameNum += mOffset;
     if (frameNum < 1 || frameNum > numFrames()) return empty;
     auto& ptr = at(frameNum);
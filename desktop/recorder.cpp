@@ -1,37 +1,50 @@
 #include "recorder.hpp"
 #include <cstdint>
 #include <fmo/assert.hpp>
-#include <fmo/processing.hpp>
-#include <fmo/region.hpp>
+#include <fmo/trace.hpp>
+#include <iostream>
 
 // RecordingThread
 
-RecordingThread::RecordingThread(const std::string& dir, fmo::Format format, fmo::Dims dims,
-                                 float fps)
-    : mFormat(format),
-      mDims(dims),
-      mVideoOutput(VideoOutput::makeInDirectory(dir, dims, fps)),
-      mStop(false),
-      mExchange(format, dims),
+RecordingThread::RecordingThread(const std::string& dir, fmo::Dims dims, float fps)
+    : mVideoOutput(VideoOutput::makeInDirectory(dir, dims, fps)),
+      mQueue(queueConfig()),
       mThread(threadImpl, this) {}
 
 RecordingThread::~RecordingThread() {
-    mStop = true;
-    mExchange.exit();
+    // let the thread write the remaining frames
+    mQueue.exit();
     mThread.join();
+
+    auto stats = mQueue.stats();
+    if (stats.dropped != 0) {
+        std::cerr << "Recorder: dropped " << stats.dropped << " of "
+                  << (stats.enqueued + stats.dropped) << " frames\n";
+    }
+}
+
+fmo::QueueConfig RecordingThread::queueConfig() {
+    // a recording must not have gaps, absorb encoder hiccups and then slow the producer down
+    fmo::QueueConfig cfg;
+    cfg.capacity = 8;
+    cfg.policy = fmo::QueuePolicy::BLOCK;
+    return cfg;
 }
 
 void RecordingThread::threadImpl(RecordingThread* self) {
-    fmo::Image input{self->mFormat, self->mDims};
+    fmo::Frame input;
 
-    while (!self->mStop) {
-        self->mExchange.swapReceive(input);
-        if (self->mStop) return;
-        self->mVideoOutput->sendFrame(input);
+    while (self->mQueue.swapReceive(input)) {
+        fmo::TraceSpan span{"encodeFrame"};
+        self->mVideoOutput->sendFrame(input.image());
+        input.reset();
     }
 }
 
-void RecordingThread::swapSend(fmo::Image& input) { mExchange.swapSend(input); }
+void RecordingThread::send(const fmo::Frame& input) {
+    fmo::Frame reference = input;
+    mQueue.swapSend(reference);
+}
 
 // AutomaticRecorder
 
@@ -41,11 +54,11 @@ AutomaticRecorder::AutomaticRecorder(std::string dir, fmo::Format format, fmo::D
         throw std::runtime_error("Recorder: YUV420SP not supported");
     }
 
-    for (int i = 0; i < NUM_FRAMES; i++) { mImages.emplace_back(mFormat, mDims); }
-    mHead = begin(mImages);
+    mFrames.resize(NUM_FRAMES);
+    mHead = begin(mFrames);
 }
 
-void AutomaticRecorder::frame(const fmo::Mat& input, bool event) {
+void AutomaticRecorder::frame(const fmo::Frame& input, bool event) {
     mFrameNum++;
 
     // stop recording if at the mark
@@ -53,19 +66,19 @@ void AutomaticRecorder::frame(const fmo::Mat& input, bool event) {
 
     // start or extend recording if there was an event
     if (event) {
-        if (!mThread) { mThread = std::make_unique<RecordingThread>(mDir, mFormat, mDims, mFps); }
+        if (!mThread) { mThread = std::make_unique<RecordingThread>(mDir, mDims, mFps); }
         mStopAt = mHead;
     }
 
     // advance head
     mHead++;
-    if (mHead == end(mImages)) { mHead = begin(mImages); }
+    if (mHead == end(mFrames)) { mHead = begin(mFrames); }
 
     // write the oldest frame to file if recording
-    if (mThread && mFrameNum > NUM_FRAMES) { mThread->swapSend(*mHead); }
+    if (mThread && mFrameNum > NUM_FRAMES) { mThread->send(*mHead); }
 
-    // rewrite the oldest frame with the input frame
-    fmo::copy(input, *mHead);
+    // replace the oldest frame with the input frame, no image data is copied
+    *mHead = input;
 }
 
 AutomaticRecorder::~AutomaticRecorder() {
@@ -78,9 +91,6 @@ AutomaticRecorder::~AutomaticRecorder() {
 ManualRecorder::~ManualRecorder() = default;
 
 ManualRecorder::ManualRecorder(std::string dir, fmo::Format format, fmo::Dims dims, float fps)
-    : mImage{format, dims}, mThread{dir, format, dims, fps} {}
+    : mThread{dir, dims, fps} {}
 
-void ManualRecorder::frame(const fmo::Mat& input) {
-    fmo::copy(input, mImage);
-    mThread.swapSend(mImage);
-}
+void ManualRecorder::frame(const fmo::Frame& input) { mThread.send(input); }
@@ -2,42 +2,39 @@
 #define FMO_DESKTOP_RECORDER_HPP
 
 #include "video.hpp"
-#include <atomic>
-#include <fmo/exchange.hpp>
-#include <fmo/image.hpp>
+#include <fmo/frame.hpp>
+#include <fmo/queue.hpp>
 #include <memory>
 #include <thread>
 
 struct RecordingThread {
-    RecordingThread(const std::string& dir, fmo::Format format, fmo::Dims dims, float fps);
+    RecordingThread(const std::string& dir, fmo::Dims dims, float fps);
     ~RecordingThread();
-    void swapSend(fmo::Image& input);
+    void send(const fmo::Frame& input);
 
 private:
+    static fmo::QueueConfig queueConfig();
     static void threadImpl(RecordingThread* self);
 
-    const fmo::Format mFormat;
-    const fmo::Dims mDims;
     std::unique_ptr<VideoOutput> mVideoOutput;
-    std::atomic<bool> mStop;
-    fmo::Exchange<fmo::Image> mExchange;
+    fmo::Queue<fmo::Frame> mQueue;
     std::thread mThread;
 };
 
 struct AutomaticRecorder {
     ~AutomaticRecorder();
     AutomaticRecorder(std::string dir, fmo::Format format, fmo::Dims dims, float fps);
-    void frame(const fmo::Mat& input, bool event);
+    void frame(const fmo::Frame& input, bool event);
     bool isRecording() const { return bool(mThread); }
 
 private:
-    using FrameIterator = std::vector<fmo::Image>::iterator;
+    using FrameIterator = std::vector<fmo::Frame>::iterator;
     static constexpr int NUM_FRAMES = 60;     ///< number of frames stored
     const std::string mDir;                   ///< directory to save videos to
     const fmo::Format mFormat;                ///< image format
     const fmo::Dims mDims;                    ///< image dimensions
     const float mFps;                         ///< frames per second setting
-    std::vector<fmo::Image> mImages;          ///< frame headers
+    std::vector<fmo::Frame> mFrames;          ///< shared references to recent frames
     FrameIterator mHead;                      ///< last written frame
     FrameIterator mStopAt;                    ///< frame to stop recording at
     std::unique_ptr<RecordingThread> mThread; ///< video encoding in a separate thread
@@ -47,10 +44,9 @@ private:
 struct ManualRecorder {
     ~ManualRecorder();
     ManualRecorder(std::string dir, fmo::Format format, fmo::Dims dims, float fps);
-    void frame(const fmo::Mat& input);
+    void frame(const fmo::Frame& input);
 
 private:
-    fmo::Image mImage;
     RecordingThread mThread;
 };
 
@@ -24,7 +24,10 @@ namespace {
         cv::Vec3b color;
         cv::Mat mat;
 
-        void operator()(fmo::Pos pt) { mat.at<cv::Vec3b>({pt.x, pt.y}) = color; }
+        void operator()(const fmo::Span& span) {
+            cv::Vec3b* row = mat.ptr<cv::Vec3b>(span.y);
+            std::fill(row + span.xBegin, row + span.xEnd, color);
+        }
     };
 }
 
@@ -162,19 +165,17 @@ Command Window::encodeKey(int keyCode) {
     };
 }
 
-void drawPoints(const fmo::PointSet& points, fmo::Mat& target, Colour colour) {
+void drawSpans(const fmo::SpanSet& spans, fmo::Mat& target, Colour colour) {
     FMO_ASSERT(target.format() == fmo::Format::BGR, "bad format");
-    cv::Mat mat = target.wrap();
-    cv::Vec3b vec = {colour.b, colour.g, colour.r};
-
-    for (auto& pt : points) { mat.at<cv::Vec3b>({pt.x, pt.y}) = vec; }
+    PutColor put{toCv(colour), target.wrap()};
+    for (auto& span : spans) { put(span); }
 }
 
-void drawPointsGt(const fmo::PointSet& ps, const fmo::PointSet& gt, fmo::Mat& target) {
+void drawSpansGt(const fmo::SpanSet& ss, const fmo::SpanSet& gt, fmo::Mat& target) {
     FMO_ASSERT(target.format() == fmo::Format::BGR, "bad format");
     cv::Mat mat = target.wrap();
     PutColor c1{toCv(colourFp), mat};
     PutColor c2{toCv(colourFn), mat};
     PutColor c3{toCv(colourTp), mat};
-    fmo::pointSetCompare(ps, gt, c1, c2, c3);
+    fmo::spanSetCompare(ss, gt, c1, c2, c3);
 }
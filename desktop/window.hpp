@@ -77,10 +77,10 @@ private:
     std::string mBottomLine;
 };
 
-/// Visualize a given set of points painting it onto the target image with the specified color.
-void drawPoints(const fmo::PointSet& points, fmo::Mat& target, Colour colour);
+/// Visualize a given set of spans painting it onto the target image with the specified color.
+void drawSpans(const fmo::SpanSet& spans, fmo::Mat& target, Colour colour);
 
-/// Visualize result point set in comparison with the ground truth point set.
-void drawPointsGt(const fmo::PointSet& ps, const fmo::PointSet& gt, fmo::Mat& target);
+/// Visualize result span set in comparison with the ground truth span set.
+void drawSpansGt(const fmo::SpanSet& ss, const fmo::SpanSet& gt, fmo::Mat& target);
 
 #endif // FMO_DESKTOP_WINDOW_HPP
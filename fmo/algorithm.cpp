@@ -1,4 +1,5 @@
 #include <fmo/algorithm.hpp>
+#include <fmo/processing.hpp>
 #include <map>
 
 namespace fmo {
@@ -10,6 +11,12 @@ namespace fmo {
           maxGapX(0.020f),
           minGapY(0.046f),
           maxImageHeight(300),
+          processingFormat(Format::UNKNOWN),
+          leanMemory(false),
+          latencyBudget(0.f),
+          latencyHysteresis(0.2f),
+          flightRecorderThreshold(0.f),
+          flightRecorderDir("."),
           minStripHeight(2),
           minStripsInObject(4),
           minStripArea(0.43f),
@@ -46,6 +53,21 @@ namespace fmo {
           maxMotion(0.50f),
           pointSetSourceResolution(false) {}
 
+    void Algorithm::setInputView(const Mat& input) {
+        copy(input, mInputCopy);
+        setInputSwap(mInputCopy);
+    }
+
+    size_t Algorithm::getMemoryUsage() const {
+        return mImagePool.numFreeBytes() + mInputCopy.capacity();
+    }
+
+    void Algorithm::Detection::getSpans(SpanSet& out) const {
+        PointSet points;
+        getPoints(points);
+        spanSetFromPoints(points, out);
+    }
+
     using AlgorithmRegistry = std::map<std::string, Algorithm::Factory>;
 
     AlgorithmRegistry& getRegistry() {
@@ -0,0 +1,103 @@
+#include <fmo/allocator.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FMO_HAVE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace fmo {
+    namespace {
+        std::atomic<int> globalPolicy{int(AllocPolicy::MALLOC)};
+        thread_local int threadPolicy = -1; ///< set by ScopedAllocPolicy, -1 if not overridden
+    }
+
+    void setAllocPolicy(AllocPolicy policy) { globalPolicy = int(policy); }
+
+    AllocPolicy getAllocPolicy() { return AllocPolicy(globalPolicy.load()); }
+
+    namespace detail {
+        AllocPolicy currentAllocPolicy() {
+            return (threadPolicy == -1) ? getAllocPolicy() : AllocPolicy(threadPolicy);
+        }
+
+        ScopedAllocPolicy::ScopedAllocPolicy(AllocPolicy policy) : mPrevious(threadPolicy) {
+            threadPolicy = int(policy);
+        }
+
+        ScopedAllocPolicy::~ScopedAllocPolicy() { threadPolicy = mPrevious; }
+
+#if defined(FMO_HAVE_MMAP)
+        namespace {
+            const size_t HUGE_PAGE = size_t(2) << 20;
+
+            /// Stored at the end of the first page of a mapping, right before the block.
+            struct PageHeader {
+                void* base;
+                size_t length;
+                uint64_t marker; ///< the last byte must be zero, see alloc::free()
+            };
+
+            size_t roundUp(size_t value, size_t multiple) {
+                return ((value + multiple - 1) / multiple) * multiple;
+            }
+
+            void* mapAnonymous(size_t length, int flags) {
+                void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+                return (base == MAP_FAILED) ? nullptr : base;
+            }
+
+            /// Maps memory aligned to huge pages, so that transparent huge pages can back it.
+            void* mapAligned(size_t length) {
+                auto* raw = (uint8_t*)mapAnonymous(length + HUGE_PAGE, 0);
+                if (raw == nullptr) return nullptr;
+                auto* base = (uint8_t*)roundUp(uintptr_t(raw), HUGE_PAGE);
+                auto* end = base + length;
+                if (base != raw) munmap(raw, size_t(base - raw));
+                munmap(end, size_t(raw + length + HUGE_PAGE - end));
+#if defined(MADV_HUGEPAGE)
+                madvise(base, length, MADV_HUGEPAGE);
+#endif
+                return base;
+            }
+        }
+
+        void* pageMalloc(size_t bytes, AllocPolicy policy) {
+            // the first page of the mapping holds the header
+            const size_t page = size_t(sysconf(_SC_PAGESIZE));
+            size_t length = roundUp(page + bytes, page);
+            void* base = nullptr;
+
+            if (policy == AllocPolicy::HUGE_PAGES) {
+                // try explicit huge pages first, these require pages reserved by the system
+                length = roundUp(length, HUGE_PAGE);
+#if defined(MAP_HUGETLB)
+                base = mapAnonymous(length, MAP_HUGETLB);
+#endif
+                if (base == nullptr) { base = mapAligned(length); }
+            } else {
+                base = mapAnonymous(length, 0);
+            }
+
+            if (base == nullptr) return nullptr;
+            mappedAllocations().fetch_add(1, std::memory_order_relaxed);
+            auto* ptr = (uint8_t*)base + page;
+            auto* header = (PageHeader*)ptr - 1;
+            header->base = base;
+            header->length = length;
+            header->marker = 0;
+            return ptr;
+        }
+
+        void pageFree(void* ptr) {
+            auto* header = (PageHeader*)ptr - 1;
+            munmap(header->base, header->length);
+        }
+#else
+        void* pageMalloc(size_t, AllocPolicy) { return nullptr; }
+
+        void pageFree(void*) {}
+#endif
+    }
+}
@@ -1,15 +1,30 @@
 #include "include-opencv.hpp"
 #include "include-simd.hpp"
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <fmo/agglomerator-impl.hpp>
 #include <fmo/algorithm.hpp>
 #include <fmo/benchmark.hpp>
 #include <fmo/subsampler.hpp>
 #include <fmo/differentiator.hpp>
 #include <fmo/image.hpp>
+#include <fmo/perfcounters.hpp>
 #include <fmo/processing.hpp>
+#include <fmo/scene.hpp>
 #include <fmo/stats.hpp>
 #include <fmo/strip.hpp>
+#include <fmo/trace.hpp>
+#include <istream>
+#include <map>
+#include <memory>
+#include <ostream>
 #include <random>
+#include <sstream>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 namespace fmo {
     namespace {
@@ -17,7 +32,7 @@ namespace fmo {
 
         template <typename Arg1, typename... Args>
         void log(log_t logFunc, const char* format, Arg1 arg1, Args... args) {
-            char buf[81];
+            char buf[256];
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wformat-security"
@@ -35,6 +50,18 @@ namespace fmo {
         return instance;
     }
 
+    void registerMedianV1Benchmarks();
+
+    /// Adds the benchmarks of algorithm stages, which are defined in the libraries of the
+    /// respective algorithms.
+    void registerBuiltInBenchmarks() {
+        static bool registered = false;
+        if (registered) return;
+        registered = true;
+
+        registerMedianV1Benchmarks();
+    }
+
     void techInfo(log_t logFunc) {
 #if defined(__thumb__) || defined(_M_ARM)
         log(logFunc, "Arch: ARM");
@@ -63,43 +90,824 @@ namespace fmo {
         log(logFunc, "\nCores: %d / Threads: %d\n", cv::getNumberOfCPUs(), cv::getNumThreads());
     }
 
-    void Registry::runAll(log_t logFunc, stop_t stopFunc) const {
-        fmo::SectionStats stats;
+    namespace {
+        /// Reports the values of hardware performance counters averaged over a number of calls.
+        void logCounters(log_t logFunc, const PerfCounters::Values& delta, int64_t numCalls,
+                         int64_t numPixels) {
+            double cycles = double(delta[PerfCounters::CYCLES]);
+            double ipc = double(delta[PerfCounters::INSTRUCTIONS]) / std::max(cycles, 1.);
+            if (numPixels == 0) {
+                log(logFunc, "  IPC %.2f, %.0f kcycles/call\n", ipc, cycles / numCalls / 1e3);
+                return;
+            }
+
+            double pixels = double(numCalls) * double(numPixels);
+            double bytes = double(delta[PerfCounters::LLC_MISSES]) * PerfCounters::CACHE_LINE;
+            log(logFunc, "  IPC %.2f, %.2f cycles/px, %.2f B/px, %.3f L1D miss/px, ", ipc,
+                cycles / pixels, bytes / pixels, delta[PerfCounters::L1D_MISSES] / pixels);
+            log(logFunc, "%.4f br miss/px\n", delta[PerfCounters::BRANCH_MISSES] / pixels);
+        }
+    }
+
+    namespace {
+        /// Restricts the calling thread to a single CPU and restores the original affinity upon
+        /// destruction. Threads of the OpenCV pool are not affected.
+        struct CpuPin {
+            CpuPin(int cpu) {
+#if defined(__linux__)
+                if (cpu < 0 || cpu >= CPU_SETSIZE) return;
+                if (sched_getaffinity(0, sizeof(mOriginal), &mOriginal) != 0) return;
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                mPinned = sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+                (void)cpu;
+#endif
+            }
+
+            ~CpuPin() {
+#if defined(__linux__)
+                if (mPinned) sched_setaffinity(0, sizeof(mOriginal), &mOriginal);
+#endif
+            }
+
+            bool pinned() const { return mPinned; }
+
+        private:
+            bool mPinned = false;
+#if defined(__linux__)
+            cpu_set_t mOriginal;
+#endif
+        };
+
+        /// Sets the number of OpenCV threads and restores the original number upon destruction.
+        struct ThreadsGuard {
+            ThreadsGuard(int numThreads) : mOriginal(cv::getNumThreads()) {
+                if (numThreads > 0) cv::setNumThreads(numThreads);
+            }
+
+            ~ThreadsGuard() { cv::setNumThreads(mOriginal); }
+
+        private:
+            const int mOriginal;
+        };
+
+        bool selected(const char* name, const std::vector<std::string>& filters) {
+            if (filters.empty()) return true;
+            for (auto& filter : filters) {
+                if (std::strstr(name, filter.c_str()) != nullptr) return true;
+            }
+            return false;
+        }
+
+        template <typename T>
+        std::vector<T> axisValues(bool used, const std::vector<T>& values, T fallback) {
+            if (used && !values.empty()) return values;
+            return {values.empty() ? fallback : values.front()};
+        }
+
+        /// Lists all combinations of the parameters that a benchmark depends on. The other
+        /// parameters receive the first value listed in the options.
+        std::vector<BenchParams> combinations(const BenchOptions& options, int axes) {
+            auto dimsVec = axisValues<Dims>(axes & BenchParams::DIMS, options.resolutions,
+                                            {1920, 1080});
+            auto formats = axisValues(axes & BenchParams::FORMAT, options.formats, Format::GRAY);
+            auto heights = axisValues(axes & BenchParams::HEIGHT, options.processingHeights, 300);
+            auto threads = axisValues(axes & BenchParams::THREADS, options.threads, 0);
+            auto counts = axisValues(axes & BenchParams::COUNT, options.counts, 0);
+
+            std::vector<BenchParams> result;
+            for (auto dims : dimsVec) {
+                for (auto format : formats) {
+                    for (auto height : heights) {
+                        for (auto numThreads : threads) {
+                            for (auto count : counts) {
+                                result.push_back({dims, format, height, numThreads, count});
+                            }
+                        }
+                    }
+                }
+            }
+            return result;
+        }
+
+        /// Describes the parameters that a benchmark depends on, e.g. " [1920x1080 GRAY t4]" or
+        /// " [n1000]".
+        std::string describe(int axes, const BenchParams& params) {
+            std::string result;
+            auto append = [&](const std::string& str) {
+                result += result.empty() ? " [" : " ";
+                result += str;
+            };
+
+            if (axes & BenchParams::DIMS) {
+                append(std::to_string(params.dims.width) + "x" +
+                       std::to_string(params.dims.height));
+            }
+            if (axes & BenchParams::FORMAT) append(formatName(params.format));
+            if (axes & BenchParams::HEIGHT) append("h" + std::to_string(params.processingHeight));
+            if (axes & BenchParams::THREADS) append("t" + std::to_string(params.numThreads));
+            if (axes & BenchParams::COUNT) append("n" + std::to_string(params.count));
+            if (!result.empty()) result += "]";
+            return result;
+        }
+
+        /// Fills in the number of calls and the duration statistics, given the samples.
+        void summarize(BenchResult& result) {
+            Histogram histogram;
+            for (auto ns : result.samplesNs) { histogram.add(ns); }
+            result.numCalls = int64_t(histogram.count());
+            result.q50Ms = histogram.quantile(0.50) / 1e6;
+            result.q95Ms = histogram.quantile(0.95) / 1e6;
+            result.q99Ms = histogram.quantile(0.99) / 1e6;
+            result.meanMs = histogram.mean() / 1e6;
+            result.minMs = histogram.min() / 1e6;
+            result.maxMs = histogram.max() / 1e6;
+        }
+
+        /// Minimum number of measured calls if sampling is cut short by BenchOptions::maxSeconds.
+        constexpr int MIN_SAMPLES = 10;
+
+        /// Calls the function repeatedly, measuring the duration of each call after a warm-up,
+        /// which may include one-time initialization. Sampling stops early once the measured calls
+        /// exceed the time budget, so that large inputs remain practical to benchmark.
+        void measure(const char* name, const std::function<void()>& func,
+                     const BenchOptions& options, const PerfCounters& counters, stop_t stopFunc,
+                     BenchResult& result) {
+            PerfCounters::Values start;
+            PerfCounters::Values end;
+            result.samplesNs.clear();
+            result.samplesNs.reserve(size_t(options.numSamples));
+
+            for (int i = 0; i < options.warmUp; i++) {
+                if (stopFunc()) { throw std::runtime_error("stopped"); }
+                TraceSpan span{name};
+                func();
+            }
+
+            const int64_t budgetNs = int64_t(options.maxSeconds * 1e9);
+            int64_t totalNs = 0;
+            counters.read(start);
+            for (int i = 0; i < options.numSamples; i++) {
+                if (stopFunc()) { throw std::runtime_error("stopped"); }
+                if (budgetNs > 0 && totalNs > budgetNs && i >= MIN_SAMPLES) break;
+                int64_t startNs = nanoTime();
+                {
+                    TraceSpan span{name};
+                    func();
+                }
+                result.samplesNs.push_back(nanoTime() - startNs);
+                totalNs += result.samplesNs.back();
+            }
+            counters.read(end);
+            summarize(result);
+            result.haveCounters = counters.available();
+            int64_t numCounted = result.numCalls;
+
+            if (result.haveCounters && cv::getNumThreads() > 1) {
+                // only the calling thread is counted, so the work that cv::parallel_for_() would
+                // hand over to the pool is kept in it during a separate, shorter pass
+                ThreadsGuard single{1};
+                numCounted = std::min(result.numCalls, int64_t(MIN_SAMPLES));
+                counters.read(start);
+                for (int64_t i = 0; i < numCounted; i++) {
+                    if (stopFunc()) { throw std::runtime_error("stopped"); }
+                    func();
+                }
+                counters.read(end);
+            }
+
+            for (size_t i = 0; i < end.size(); i++) {
+                end[i] -= start[i];
+                result.counters[i] = double(end[i]) / double(std::max(numCounted, int64_t(1)));
+            }
+        }
+
+        void logResult(log_t logFunc, const BenchResult& result) {
+            log(logFunc, "%s%s: %.2f / %.1f / %.0f\n", result.name.c_str(),
+                describe(result.axes, result.params).c_str(), result.q50Ms, result.q95Ms,
+                result.q99Ms);
+
+            if (result.haveCounters && result.numCalls > 0) {
+                PerfCounters::Values total;
+                for (size_t i = 0; i < total.size(); i++) {
+                    total[i] = int64_t(result.counters[i] * double(result.numCalls));
+                }
+                logCounters(logFunc, total, result.numCalls, result.numPixels);
+            }
+        }
+
+        /// Reports how the duration of a benchmark grows with the item count, separately for each
+        /// combination of the other parameters.
+        void logScaling(log_t logFunc, const std::vector<BenchResult>& results) {
+            std::vector<std::string> labels;
+            std::map<std::string, std::vector<BenchResult>> groups;
+            for (auto& result : results) {
+                int axes = result.axes & ~BenchParams::COUNT;
+                auto label = result.name + describe(axes, result.params);
+                auto& group = groups[label];
+                if (group.empty()) labels.push_back(label);
+                group.push_back(result);
+            }
+
+            for (auto& label : labels) {
+                log(logFunc, "%s: time ~ n^%.2f\n", label.c_str(), scalingExponent(groups[label]));
+            }
+        }
+    }
+
+    double scalingExponent(const std::vector<BenchResult>& results) {
+        double sumX = 0;
+        double sumY = 0;
+        double sumXX = 0;
+        double sumXY = 0;
+        int n = 0;
+        for (auto& result : results) {
+            if (result.params.count <= 0 || result.q50Ms <= 0) continue;
+            double x = std::log(double(result.params.count));
+            double y = std::log(result.q50Ms);
+            sumX += x;
+            sumY += y;
+            sumXX += x * x;
+            sumXY += x * y;
+            n++;
+        }
+
+        double denominator = n * sumXX - sumX * sumX;
+        if (n < 2 || denominator < 1e-9) return 0;
+        return (n * sumXY - sumX * sumY) / denominator;
+    }
+
+    bool Registry::run(const BenchOptions& options, std::vector<BenchResult>& results,
+                       log_t logFunc, stop_t stopFunc) const {
+        registerBuiltInBenchmarks();
+        PerfCounters counters;
 
         try {
             techInfo(logFunc);
+            log(logFunc, counters.available()
+                             ? "Counters: available (collected with a single OpenCV thread)\n"
+                             : "Counters: unavailable\n");
+
+            CpuPin pin{options.cpu};
+            if (options.cpu >= 0) {
+                if (pin.pinned()) {
+                    log(logFunc, "Pinned to CPU %d (benchmark thread only)\n", options.cpu);
+                } else {
+                    log(logFunc, "Pinning to CPU %d failed\n", options.cpu);
+                }
+            }
+
             log(logFunc, "Benchmark started.\n");
 
-            for (auto func : mFuncs) {
-                stats.reset();
-                bool updated = false;
+            for (auto& entry : mFuncs) {
+                if (!selected(entry.name, options.filters)) continue;
 
-                while (!updated && !stopFunc()) {
-                    stats.start();
-                    func.second();
-                    updated = stats.stop();
+                if (entry.setup == nullptr) {
+                    BenchResult result{};
+                    result.name = entry.name;
+                    result.numPixels = entry.numPixels;
+                    for (int rep = 0; rep < options.repetitions; rep++) {
+                        result.repetition = rep;
+                        measure(entry.name, entry.func, options, counters, stopFunc, result);
+                        logResult(logFunc, result);
+                        results.push_back(result);
+                    }
+                    continue;
                 }
 
-                if (stopFunc()) { throw std::runtime_error("stopped"); }
+                size_t firstResult = results.size();
+                for (auto& params : combinations(options, entry.axes)) {
+                    ThreadsGuard threads{(entry.axes & BenchParams::THREADS) ? params.numThreads
+                                                                              : 0};
+                    auto func = entry.setup(params);
+                    if (!func) {
+                        log(logFunc, "%s%s: not supported\n", entry.name,
+                            describe(entry.axes, params).c_str());
+                        continue;
+                    }
+
+                    BenchResult result{};
+                    result.name = entry.name;
+                    result.axes = entry.axes;
+                    result.params = params;
+                    if (entry.axes & BenchParams::DIMS) {
+                        result.numPixels = int64_t(params.dims.width) * params.dims.height;
+                    }
+                    for (int rep = 0; rep < options.repetitions; rep++) {
+                        result.repetition = rep;
+                        measure(entry.name, func, options, counters, stopFunc, result);
+                        logResult(logFunc, result);
+                        results.push_back(result);
+                    }
+                }
 
-                auto q = stats.quantilesMs();
-                log(logFunc, "%s: %.2f / %.1f / %.0f\n", func.first, q.q50, q.q95, q.q99);
+                if (entry.axes & BenchParams::COUNT) {
+                    std::vector<BenchResult> entryResults(results.begin() + firstResult,
+                                                          results.end());
+                    logScaling(logFunc, entryResults);
+                }
             }
 
             log(logFunc, "Benchmark finished.\n\n");
-        } catch (std::exception& e) { log(logFunc, "Benchmark interrupted: %s.\n\n", e.what()); }
+            return true;
+        } catch (std::exception& e) {
+            log(logFunc, "Benchmark interrupted: %s.\n\n", e.what());
+            return false;
+        }
+    }
+
+    void Registry::runAll(log_t logFunc, stop_t stopFunc) const {
+        std::vector<BenchResult> results;
+        run(BenchOptions{}, results, logFunc, stopFunc);
+    }
+
+    void Registry::list(log_t logFunc) const {
+        registerBuiltInBenchmarks();
+        const std::pair<int, const char*> axisNames[] = {
+            {BenchParams::DIMS, "resolution"},
+            {BenchParams::FORMAT, "format"},
+            {BenchParams::HEIGHT, "height"},
+            {BenchParams::THREADS, "threads"},
+            {BenchParams::COUNT, "count"},
+        };
+
+        for (auto& entry : mFuncs) {
+            log(logFunc, entry.name);
+            const char* separator = " [";
+            for (auto& axis : axisNames) {
+                if ((entry.axes & axis.first) == 0) continue;
+                log(logFunc, "%s%s", separator, axis.second);
+                separator = ", ";
+            }
+            log(logFunc, entry.axes != 0 ? "]\n" : "\n");
+        }
+    }
+
+    namespace {
+        void writeJsonString(std::ostream& out, const std::string& str) {
+            out << '"';
+            for (char c : str) {
+                if (c == '"' || c == '\\') out << '\\';
+                out << c;
+            }
+            out << '"';
+        }
+
+        void writeCsvString(std::ostream& out, const std::string& str) {
+            out << '"';
+            for (char c : str) {
+                if (c == '"') out << '"';
+                out << c;
+            }
+            out << '"';
+        }
+    }
+
+    void writeJson(std::ostream& out, const std::vector<BenchResult>& results) {
+        const char* separator = "\n";
+        out << "[";
+        for (auto& r : results) {
+            out << separator << "{\"name\":";
+            writeJsonString(out, r.name);
+            if (r.axes & BenchParams::DIMS) {
+                out << ",\"width\":" << r.params.dims.width;
+                out << ",\"height\":" << r.params.dims.height;
+            }
+            if (r.axes & BenchParams::FORMAT) {
+                out << ",\"format\":\"" << formatName(r.params.format) << '"';
+            }
+            if (r.axes & BenchParams::HEIGHT) {
+                out << ",\"processingHeight\":" << r.params.processingHeight;
+            }
+            if (r.axes & BenchParams::THREADS) {
+                out << ",\"threads\":" << r.params.numThreads;
+            }
+            if (r.axes & BenchParams::COUNT) { out << ",\"count\":" << r.params.count; }
+            out << ",\"repetition\":" << r.repetition << ",\"pixels\":" << r.numPixels
+                << ",\"calls\":" << r.numCalls << ",\"q50Ms\":" << r.q50Ms
+                << ",\"q95Ms\":" << r.q95Ms << ",\"q99Ms\":" << r.q99Ms
+                << ",\"meanMs\":" << r.meanMs << ",\"minMs\":" << r.minMs
+                << ",\"maxMs\":" << r.maxMs;
+            if (r.haveCounters) {
+                const char* counterSeparator = "";
+                out << ",\"counters\":{";
+                for (int i = 0; i < PerfCounters::NUM_EVENTS; i++) {
+                    auto event = PerfCounters::Event(i);
+                    out << counterSeparator << '"' << PerfCounters::name(event)
+                        << "\":" << r.counters[i];
+                    counterSeparator = ",";
+                }
+                out << "}";
+            }
+            out << "}";
+            separator = ",\n";
+        }
+        out << "\n]\n";
+    }
+
+    void writeCsv(std::ostream& out, const std::vector<BenchResult>& results) {
+        out << "name,width,height,format,processing_height,threads,count,repetition,pixels,"
+               "calls,q50_ms,q95_ms,q99_ms,mean_ms,min_ms,max_ms";
+        for (int i = 0; i < PerfCounters::NUM_EVENTS; i++) {
+            out << ',' << PerfCounters::name(PerfCounters::Event(i));
+        }
+        out << '\n';
+
+        for (auto& r : results) {
+            writeCsvString(out, r.name);
+            out << ',';
+            if (r.axes & BenchParams::DIMS) out << r.params.dims.width;
+            out << ',';
+            if (r.axes & BenchParams::DIMS) out << r.params.dims.height;
+            out << ',';
+            if (r.axes & BenchParams::FORMAT) out << formatName(r.params.format);
+            out << ',';
+            if (r.axes & BenchParams::HEIGHT) out << r.params.processingHeight;
+            out << ',';
+            if (r.axes & BenchParams::THREADS) out << r.params.numThreads;
+            out << ',';
+            if (r.axes & BenchParams::COUNT) out << r.params.count;
+            out << ',' << r.repetition << ',' << r.numPixels << ',' << r.numCalls << ','
+                << r.q50Ms << ',' << r.q95Ms << ',' << r.q99Ms << ',' << r.meanMs << ','
+                << r.minMs << ',' << r.maxMs;
+            for (int i = 0; i < PerfCounters::NUM_EVENTS; i++) {
+                out << ',';
+                if (r.haveCounters) out << r.counters[i];
+            }
+            out << '\n';
+        }
+    }
+
+    namespace {
+        const char* const baselineToken = "/FMO/BENCHMARK/BASELINE/V1/";
+
+        double median(std::vector<int64_t> samples) {
+            if (samples.empty()) return 0;
+            auto mid = begin(samples) + samples.size() / 2;
+            std::nth_element(begin(samples), mid, end(samples));
+            return double(*mid);
+        }
+
+        /// Pools the samples of all repetitions, keeping the order of the benchmarks.
+        void pool(const std::vector<BenchResult>& results, std::vector<std::string>& labels,
+                  std::map<std::string, std::vector<int64_t>>& samples) {
+            for (auto& result : results) {
+                auto label = result.name + describe(result.axes, result.params);
+                auto& vec = samples[label];
+                if (vec.empty()) labels.push_back(label);
+                vec.insert(end(vec), begin(result.samplesNs), end(result.samplesNs));
+            }
+        }
+    }
+
+    void saveBaseline(std::ostream& out, const std::vector<BenchResult>& results) {
+        out << baselineToken << '\n';
+        out << results.size() << '\n';
+
+        for (auto& r : results) {
+            out << r.name << '\n';
+            out << r.axes << ' ' << r.params.dims.width << ' ' << r.params.dims.height << ' '
+                << formatName(r.params.format) << ' ' << r.params.processingHeight << ' '
+                << r.params.numThreads << ' ' << r.repetition << ' ' << r.numPixels << ' '
+                << r.samplesNs.size() << ' ' << r.params.count << '\n';
+            for (auto ns : r.samplesNs) { out << ns << ' '; }
+            out << '\n';
+        }
+    }
+
+    std::vector<BenchResult> loadBaseline(std::istream& in) {
+        std::string token;
+        in >> token;
+        if (token != baselineToken) { throw std::runtime_error("not a benchmark baseline"); }
+
+        size_t numResults;
+        in >> numResults;
+        std::vector<BenchResult> results;
+
+        for (size_t i = 0; i < numResults && in; i++) {
+            BenchResult r{};
+            size_t numSamples = 0;
+            std::string line;
+            in >> std::ws;
+            std::getline(in, r.name);
+            std::getline(in, line);
+            std::istringstream fields{line};
+            fields >> r.axes >> r.params.dims.width >> r.params.dims.height >> token >>
+                r.params.processingHeight >> r.params.numThreads >> r.repetition >> r.numPixels >>
+                numSamples;
+            if (!fields) in.setstate(std::ios::failbit);
+            // the item count was appended later, baselines saved without it have zero
+            fields >> r.params.count;
+            r.params.format = formatFromName(token.c_str());
+            r.samplesNs.resize(in ? numSamples : 0);
+            for (auto& ns : r.samplesNs) { in >> ns; }
+            summarize(r);
+            results.push_back(std::move(r));
+        }
+
+        if (!in) { throw std::runtime_error("error while parsing benchmark baseline"); }
+        return results;
+    }
+
+    std::vector<BenchResult> selectBaseline(const std::vector<BenchResult>& baseline,
+                                            const BenchOptions& options) {
+        std::vector<BenchResult> result;
+        for (auto& r : baseline) {
+            if (!selected(r.name.c_str(), options.filters)) continue;
+            bool measured = false;
+            for (auto& params : combinations(options, r.axes)) {
+                if ((r.axes & BenchParams::DIMS) && params.dims != r.params.dims) continue;
+                if ((r.axes & BenchParams::FORMAT) && params.format != r.params.format) continue;
+                if ((r.axes & BenchParams::HEIGHT) &&
+                    params.processingHeight != r.params.processingHeight) {
+                    continue;
+                }
+                if ((r.axes & BenchParams::THREADS) && params.numThreads != r.params.numThreads) {
+                    continue;
+                }
+                if ((r.axes & BenchParams::COUNT) && params.count != r.params.count) continue;
+                measured = true;
+                break;
+            }
+            if (measured) result.push_back(r);
+        }
+        return result;
+    }
+
+    std::vector<BenchComparison> compareResults(const std::vector<BenchResult>& baseline,
+                                                const std::vector<BenchResult>& results,
+                                                double threshold, double alpha) {
+        std::vector<std::string> baseLabels;
+        std::vector<std::string> labels;
+        std::map<std::string, std::vector<int64_t>> baseSamples;
+        std::map<std::string, std::vector<int64_t>> samples;
+        pool(baseline, baseLabels, baseSamples);
+        pool(results, labels, samples);
+
+        std::vector<BenchComparison> comparisons;
+        for (auto& label : labels) {
+            BenchComparison c;
+            auto& vec = samples[label];
+            c.label = label;
+            c.verdict = BenchComparison::NEW;
+            c.q50Ms = median(vec) / 1e6;
+            c.baseQ50Ms = 0;
+            c.change = 0;
+            c.pValue = 1;
+
+            auto it = baseSamples.find(label);
+            if (it != baseSamples.end() && !it->second.empty()) {
+                c.verdict = BenchComparison::SAME;
+                c.baseQ50Ms = median(it->second) / 1e6;
+                c.change = c.q50Ms / std::max(c.baseQ50Ms, 1e-9) - 1;
+                c.pValue = mannWhitneyP(it->second, vec);
+
+                if (c.pValue < alpha) {
+                    if (c.change > threshold) c.verdict = BenchComparison::REGRESSION;
+                    if (c.change < -threshold) c.verdict = BenchComparison::IMPROVEMENT;
+                }
+            }
+
+            comparisons.push_back(c);
+        }
+
+        for (auto& label : baseLabels) {
+            auto& baseVec = baseSamples[label];
+            if (samples.count(label) != 0 || baseVec.empty()) continue;
+            BenchComparison c;
+            c.label = label;
+            c.verdict = BenchComparison::MISSING;
+            c.baseQ50Ms = median(baseVec) / 1e6;
+            c.q50Ms = 0;
+            c.change = 0;
+            c.pValue = 1;
+            comparisons.push_back(c);
+        }
+
+        return comparisons;
+    }
+
+    namespace {
+        /// Resizes the frames of a BGR sequence and converts them to the requested format.
+        void prepareFrames(const std::vector<Image>& sequence, Dims dims, Format format,
+                           std::vector<Image>& frames) {
+            if (format != Format::GRAY && format != Format::BGR && format != Format::YUV) {
+                throw std::runtime_error("unsupported format");
+            }
+
+            Image resized;
+            frames.resize(sequence.size());
+            for (size_t i = 0; i < sequence.size(); i++) {
+                if (sequence[i].format() != Format::BGR) {
+                    throw std::runtime_error("sequence frames must be BGR");
+                }
+                resized.resize(Format::BGR, dims);
+                cv::resize(sequence[i].wrap(), resized.wrap(), {dims.width, dims.height}, 0, 0,
+                           cv::INTER_AREA);
+                if (format == Format::BGR) {
+                    frames[i].swap(resized);
+                } else {
+                    convert(resized, frames[i], format);
+                }
+            }
+        }
+
+        AlgorithmBenchResult measureAlgorithm(const std::string& name,
+                                              const std::vector<Image>& frames,
+                                              const AlgorithmBenchOptions& options,
+                                              stop_t stopFunc) {
+            AlgorithmBenchResult result;
+            result.name = name;
+            result.dims = frames.front().dims();
+            result.format = frames.front().format();
+            result.numFrames = options.numFrames;
+
+            Algorithm::Config config;
+            config.name = name;
+            auto algorithm = Algorithm::make(config, result.format, result.dims);
+            algorithm->setProfiling(true);
+            // measure the lean path regardless of the default, a copy is only made for display
+            algorithm->setKeepInput(false);
+            auto& profiler = algorithm->getProfiler();
+            std::vector<int64_t> stageNs(size_t(profiler.numStages()), 0);
+            Algorithm::Output output;
+            Histogram histogram;
+            int64_t totalNs = 0;
+            int64_t numDetections = 0;
+            result.peakMemory = 0;
+            result.haveAllocs = heapAllocationsCounted();
+            result.stageAllocs.resize(stageNs.size());
+
+            for (int i = 0; i < options.warmUp + options.numFrames; i++) {
+                if (stopFunc()) { throw std::runtime_error("stopped"); }
+                auto& frame = frames[size_t(i) % frames.size()];
+                AllocCounts allocs0 = heapAllocations();
+                int64_t startNs = nanoTime();
+                algorithm->setInputView(frame);
+                AllocCounts allocs1 = heapAllocations();
+                algorithm->getOutput(output);
+                int64_t frameNs = nanoTime() - startNs;
+                AllocCounts allocs2 = heapAllocations();
+                result.peakMemory = std::max(result.peakMemory, algorithm->getMemoryUsage());
+                if (i < options.warmUp) continue;
+
+                histogram.add(frameNs);
+                totalNs += frameNs;
+                numDetections += int64_t(output.detections.size());
+                result.inputAllocs += allocs1 - allocs0;
+                result.outputAllocs += allocs2 - allocs1;
+                for (size_t s = 0; s < stageNs.size(); s++) {
+                    stageNs[s] += profiler.lastNs(int(s));
+                    result.stageAllocs[s] += profiler.lastAllocs(int(s));
+                }
+            }
+
+            double numFrames = double(std::max(options.numFrames, 1));
+            result.fps = numFrames / std::max(double(totalNs) / 1e9, 1e-9);
+            result.q50Ms = histogram.quantile(0.50) / 1e6;
+            result.q95Ms = histogram.quantile(0.95) / 1e6;
+            result.detectionsPerFrame = double(numDetections) / numFrames;
+            for (size_t s = 0; s < stageNs.size(); s++) {
+                result.stageNames.push_back(profiler.stageName(int(s)));
+                result.stageMeanMs.push_back(double(stageNs[s]) / numFrames / 1e6);
+            }
+            return result;
+        }
+
+        void logAlgorithmResult(log_t logFunc, const AlgorithmBenchResult& r) {
+            log(logFunc, "%s [%dx%d %s]: %.1f fps, %.2f / %.1f ms, %d KiB peak, %.2f det/frame\n",
+                r.name.c_str(), r.dims.width, r.dims.height, formatName(r.format), r.fps, r.q50Ms,
+                r.q95Ms, int(r.peakMemory >> 10), r.detectionsPerFrame);
+
+            std::string stages = "  stages (mean ms):";
+            for (size_t s = 0; s < r.stageNames.size(); s++) {
+                char buf[32];
+                snprintf(buf, sizeof(buf), " %.2f", r.stageMeanMs[s]);
+                stages += " " + r.stageNames[s] + buf;
+            }
+            stages += "\n";
+            log(logFunc, stages.c_str());
+            if (!r.haveAllocs) return;
+
+            double numFrames = double(std::max(r.numFrames, 1));
+            log(logFunc, "  allocations per frame: input %.1f (%.0f B), output %.1f (%.0f B)\n",
+                double(r.inputAllocs.count) / numFrames, double(r.inputAllocs.bytes) / numFrames,
+                double(r.outputAllocs.count) / numFrames, double(r.outputAllocs.bytes) / numFrames);
+            std::string allocs = "  stages (allocations per frame):";
+            for (size_t s = 0; s < r.stageNames.size(); s++) {
+                char buf[32];
+                snprintf(buf, sizeof(buf), " %.1f", double(r.stageAllocs[s].count) / numFrames);
+                allocs += " " + r.stageNames[s] + buf;
+            }
+            allocs += "\n";
+            log(logFunc, allocs.c_str());
+        }
+    }
+
+    bool benchmarkAlgorithms(const std::vector<Image>& sequence,
+                             const AlgorithmBenchOptions& options,
+                             std::vector<AlgorithmBenchResult>& results, log_t logFunc,
+                             stop_t stopFunc) {
+        try {
+            if (sequence.empty()) { throw std::runtime_error("empty sequence"); }
+            techInfo(logFunc);
+            log(logFunc, "Algorithm benchmark started (%d frames in sequence).\n",
+                int(sequence.size()));
+            std::vector<Image> frames;
+
+            for (auto dims : options.resolutions) {
+                for (auto format : options.formats) {
+                    prepareFrames(sequence, dims, format, frames);
+
+                    for (auto& name : Algorithm::listFactories()) {
+                        if (!selected(name.c_str(), options.filters)) continue;
+                        results.push_back(measureAlgorithm(name, frames, options, stopFunc));
+                        logAlgorithmResult(logFunc, results.back());
+                    }
+                }
+            }
+
+            log(logFunc, "Algorithm benchmark finished.\n\n");
+            return true;
+        } catch (std::exception& e) {
+            log(logFunc, "Algorithm benchmark interrupted: %s.\n\n", e.what());
+            return false;
+        }
+    }
+
+    void writeJson(std::ostream& out, const std::vector<AlgorithmBenchResult>& results) {
+        const char* separator = "\n";
+        out << "[";
+        for (auto& r : results) {
+            out << separator << "{\"name\":";
+            writeJsonString(out, r.name);
+            out << ",\"width\":" << r.dims.width << ",\"height\":" << r.dims.height
+                << ",\"format\":\"" << formatName(r.format) << "\",\"frames\":" << r.numFrames
+                << ",\"fps\":" << r.fps << ",\"q50Ms\":" << r.q50Ms << ",\"q95Ms\":" << r.q95Ms
+                << ",\"peakMemory\":" << r.peakMemory
+                << ",\"detectionsPerFrame\":" << r.detectionsPerFrame << ",\"stagesMs\":{";
+            for (size_t s = 0; s < r.stageNames.size(); s++) {
+                if (s != 0) out << ",";
+                writeJsonString(out, r.stageNames[s]);
+                out << ":" << r.stageMeanMs[s];
+            }
+            out << "}";
+            if (r.haveAllocs) {
+                out << ",\"inputAllocs\":" << r.inputAllocs.count
+                    << ",\"inputAllocBytes\":" << r.inputAllocs.bytes
+                    << ",\"outputAllocs\":" << r.outputAllocs.count
+                    << ",\"outputAllocBytes\":" << r.outputAllocs.bytes << ",\"stageAllocs\":{";
+                for (size_t s = 0; s < r.stageNames.size(); s++) {
+                    if (s != 0) out << ",";
+                    writeJsonString(out, r.stageNames[s]);
+                    out << ":" << r.stageAllocs[s].count;
+                }
+                out << "}";
+            }
+            out << "}";
+            separator = ",\n";
+        }
+        out << "\n]\n";
+    }
+
+    void writeCsv(std::ostream& out, const std::vector<AlgorithmBenchResult>& results) {
+        out << "name,width,height,format,frames,fps,q50_ms,q95_ms,peak_memory,"
+               "detections_per_frame,stages_ms,input_allocs,output_allocs\n";
+        for (auto& r : results) {
+            writeCsvString(out, r.name);
+            out << ',' << r.dims.width << ',' << r.dims.height << ',' << formatName(r.format)
+                << ',' << r.numFrames << ',' << r.fps << ',' << r.q50Ms << ',' << r.q95Ms << ','
+                << r.peakMemory << ',' << r.detectionsPerFrame << ',';
+            std::string stages;
+            for (size_t s = 0; s < r.stageNames.size(); s++) {
+                if (s != 0) stages += ';';
+                stages += r.stageNames[s] + '=' + std::to_string(r.stageMeanMs[s]);
+            }
+            writeCsvString(out, stages);
+            if (r.haveAllocs) {
+                out << ',' << r.inputAllocs.count << ',' << r.outputAllocs.count << '\n';
+            } else {
+                out << ",,\n";
+            }
+        }
+    }
+
+    Benchmark::Benchmark(const char* name, bench_t func, int64_t numPixels) {
+        auto& reg = Registry::get();
+        reg.add(name, func, numPixels);
     }
 
-    Benchmark::Benchmark(const char* name, bench_t func) {
+    Benchmark::Benchmark(const char* name, setup_t setup, int axes) {
         auto& reg = Registry::get();
-        reg.add(name, func);
+        reg.add(name, setup, axes);
     }
 
     namespace {
         struct {
             cv::Mat grayNoise;
             cv::Mat grayCircles;
-            cv::Mat grayBlack;
             cv::Mat rect;
 
             cv::Mat out1;
@@ -107,28 +915,24 @@ namespace fmo {
             cv::Mat out3;
 
             fmo::Image grayNoiseImage;
-            fmo::Image grayCirclesImage;
-            fmo::Image grayBlackImage;
             fmo::Image yuv420SpNoiseImage;
             fmo::Image yuv420SpNoiseImage2;
             fmo::Image yuv420SpNoiseImage3;
-            fmo::Image yuvNoiseImage;
-            fmo::Image yuvNoiseImage2;
+            fmo::Image bgrNoiseImage;
+            fmo::Image convertedImage;
             fmo::Image outImage;
+            fmo::Image yuv420SpHugeImages[3];
+            fmo::Image outImageHuge;
             std::vector<fmo::Image> outImageVec;
 
             std::mt19937 re{5489};
             using limits = std::numeric_limits<int>;
             std::uniform_int_distribution<int> uniform{limits::min(), limits::max()};
             std::uniform_int_distribution<int> randomGray{2, 254};
-            std::unique_ptr<fmo::Algorithm> algorithmGray;
             std::unique_ptr<fmo::Algorithm> algorithmYuv420Sp;
+            std::unique_ptr<fmo::Algorithm> algorithmYuv420SpHuge;
             fmo::Subsampler subsampler;
-            fmo::Differentiator::Config diffCfg;
-            fmo::Differentiator diff{diffCfg};
-            fmo::StripGen stripGen;
             std::vector<fmo::Pos16> pos16Vec;
-            std::vector<fmo::Strip> stripVec;
         } global;
 
         struct Init {
@@ -182,18 +986,8 @@ namespace fmo {
                 }
 
                 {
-                    global.yuvNoiseImage.resize(fmo::Format::YUV, {W, H});
-                    auto* data = global.yuvNoiseImage.data();
-                    auto* end = data + (3 * W * H);
-
-                    for (; data < end; data += sizeof(int)) {
-                        *(int*)data = global.uniform(global.re);
-                    }
-                }
-
-                {
-                    global.yuvNoiseImage2.resize(fmo::Format::YUV, {W, H});
-                    auto* data = global.yuvNoiseImage2.data();
+                    global.bgrNoiseImage.resize(fmo::Format::BGR, {W, H});
+                    auto* data = global.bgrNoiseImage.data();
                     auto* end = data + (3 * W * H);
 
                     for (; data < end; data += sizeof(int)) {
@@ -216,79 +1010,237 @@ namespace fmo {
                             *data++ = (dx2 + dy2 < 10000) ? 0xFF : 0x00;
                         }
                     }
-
-                    global.grayCirclesImage.assign(fmo::Format::GRAY, {W, H},
-                                                   global.grayCircles.data);
-                }
-
-                {
-                    global.grayBlack = newGrayMat();
-                    auto* data = global.grayBlack.data;
-                    auto len = size_t(W * H);
-                    std::memset(data, 0, len);
-
-                    global.grayBlackImage.assign(fmo::Format::GRAY, {W, H}, global.grayBlack.data);
                 }
 
                 global.rect = cv::getStructuringElement(cv::MORPH_RECT, {3, 3});
 
                 {
                     fmo::Algorithm::Config cfg;
-                    global.algorithmGray = Algorithm::make(cfg, fmo::Format::GRAY, {W, H});
                     global.algorithmYuv420Sp = Algorithm::make(cfg, fmo::Format::YUV420SP, {W, H});
+
+                    // the same inputs and algorithm, with buffers backed by huge pages
+                    auto policy = fmo::getAllocPolicy();
+                    fmo::setAllocPolicy(fmo::AllocPolicy::HUGE_PAGES);
+                    global.yuv420SpHugeImages[0] = global.yuv420SpNoiseImage;
+                    global.yuv420SpHugeImages[1] = global.yuv420SpNoiseImage2;
+                    global.yuv420SpHugeImages[2] = global.yuv420SpNoiseImage3;
+                    global.outImageHuge.resize(fmo::Format::YUV420SP, {W, H});
+                    global.algorithmYuv420SpHuge =
+                        Algorithm::make(cfg, fmo::Format::YUV420SP, {W, H});
+                    fmo::setAllocPolicy(policy);
                 }
             }
         };
 
         void init() { static Init once; }
 
-        Benchmark FMO_UNIQUE_NAME{"fmo::Subsampler GRAY", []() {
-                                      init();
-                                      global.subsampler(global.grayNoiseImage, global.outImage);
-                                  }};
+        /// All benchmarks that are not parameterized process a single full-HD frame per call.
+        constexpr int64_t NUM_PIXELS = int64_t(Init::W) * Init::H;
 
-        Benchmark FMO_UNIQUE_NAME{"fmo::Subsampler YUV", []() {
-                                      init();
-                                      global.subsampler(global.yuvNoiseImage, global.outImage);
-                                  }};
+        /// Creates an image of the given format and dimensions filled with pseudo-random bytes.
+        void fillNoise(fmo::Image& image, fmo::Format format, fmo::Dims dims, unsigned seed) {
+            std::mt19937 re{seed};
+            image.resize(format, dims);
+            for (auto& byte : image) { byte = uint8_t(re()); }
+        }
 
-        Benchmark FMO_UNIQUE_NAME{"fmo::Subsampler YUV420SP", []() {
-                                      init();
-                                      global.subsampler(global.yuv420SpNoiseImage, global.outImage);
-                                  }};
+        /// Creates a GRAY image with a grid of white circles on a black background.
+        void fillCircles(fmo::Image& image, fmo::Dims dims) {
+            image.resize(fmo::Format::GRAY, dims);
+            for (int r = 0; r < dims.height; r++) {
+                int rmod = ((r + 128) % 256);
+                int dy = std::min(rmod, 256 - rmod);
+                uint8_t* data = image.data() + r * image.skip();
+                for (int c = 0; c < dims.width; c++) {
+                    int cmod = ((c + 128) % 256);
+                    int dx = std::min(cmod, 256 - cmod);
+                    *data++ = (dx * dx + dy * dy < 10000) ? 0xFF : 0x00;
+                }
+            }
+        }
 
-        Benchmark FMO_UNIQUE_NAME{"fmo::StripGen", []() {
-                                      init();
-                                      int outNoise;
-                                      global.stripVec.clear();
-                                      global.stripGen(global.grayCirclesImage, 2, 1, 2,
-                                                      global.stripVec, outNoise);
-                                  }};
+        Benchmark FMO_UNIQUE_NAME{
+            "fmo::Subsampler",
+            [](const BenchParams& params) -> std::function<void()> {
+                if (params.format == Format::UNKNOWN || params.format == Format::INT32) return {};
+                struct State {
+                    fmo::Subsampler subsampler;
+                    fmo::Image input;
+                    fmo::Image output;
+                };
+                auto state = std::make_shared<State>();
+                fillNoise(state->input, params.format, params.dims, 1);
+                return [state]() { state->subsampler(state->input, state->output); };
+            },
+            BenchParams::DIMS | BenchParams::FORMAT | BenchParams::THREADS};
 
-        Benchmark FMO_UNIQUE_NAME{"fmo::Differentiator", []() {
-                                      init();
-                                      global.diff(global.yuvNoiseImage, global.yuvNoiseImage2,
-                                                  global.outImage);
-                                  }};
+        Benchmark FMO_UNIQUE_NAME{
+            "fmo::Differentiator",
+            [](const BenchParams& params) -> std::function<void()> {
+                if (params.format != Format::GRAY && params.format != Format::BGR &&
+                    params.format != Format::YUV) {
+                    return {};
+                }
+                struct State {
+                    fmo::Differentiator::Config config;
+                    fmo::Differentiator diff{config};
+                    fmo::Image inputs[2];
+                    fmo::Image output;
+                };
+                auto state = std::make_shared<State>();
+                fillNoise(state->inputs[0], params.format, params.dims, 1);
+                fillNoise(state->inputs[1], params.format, params.dims, 2);
+                return [state]() {
+                    state->diff(state->inputs[0], state->inputs[1], state->output);
+                };
+            },
+            BenchParams::DIMS | BenchParams::FORMAT | BenchParams::THREADS};
+
+        Benchmark FMO_UNIQUE_NAME{
+            "fmo::median3",
+            [](const BenchParams& params) -> std::function<void()> {
+                struct State {
+                    fmo::Image inputs[3];
+                    fmo::Image output;
+                };
+                auto state = std::make_shared<State>();
+                for (unsigned i = 0; i < 3; i++) {
+                    fillNoise(state->inputs[i], Format::GRAY, params.dims, 1 + i);
+                }
+                return [state]() {
+                    fmo::median3(state->inputs[0], state->inputs[1], state->inputs[2],
+                                 state->output);
+                };
+            },
+            BenchParams::DIMS | BenchParams::THREADS};
+
+        Benchmark FMO_UNIQUE_NAME{
+            "fmo::StripGen",
+            [](const BenchParams& params) -> std::function<void()> {
+                struct State {
+                    fmo::StripGen stripGen;
+                    fmo::Image input;
+                    std::vector<fmo::Strip> strips;
+                };
+                auto state = std::make_shared<State>();
+                fillCircles(state->input, params.dims);
+                return [state]() {
+                    int outNoise;
+                    state->strips.clear();
+                    state->stripGen(state->input, 2, 1, 2, state->strips, outNoise);
+                };
+            },
+            BenchParams::DIMS | BenchParams::THREADS};
+
+        Benchmark FMO_UNIQUE_NAME{
+            "fmo::Agglomerator",
+            [](const BenchParams& params) -> std::function<void()> {
+                // random points, merged greedily while they are close to each other; counts
+                // beyond Agglomerator::safetyMaxNumClusters would be truncated, so they are skipped
+                if (params.count > Agglomerator::safetyMaxNumClusters) return {};
+                struct Cluster {
+                    float x, y, weight;
+                };
+                struct State {
+                    fmo::Agglomerator agglomerator;
+                    std::vector<Cluster> points;
+                    std::vector<Cluster> clusters;
+                };
+                auto state = std::make_shared<State>();
+                std::mt19937 re{5489};
+                std::uniform_real_distribution<float> coord{0.f, 1000.f};
+                for (int i = 0; i < params.count; i++) {
+                    state->points.push_back({coord(re), coord(re), 1.f});
+                }
+                return [state]() {
+                    using Id_t = Agglomerator::Id_t;
+                    auto& clusters = state->clusters;
+                    clusters = state->points;
+                    auto distance = [&](Id_t i, Id_t j) {
+                        float dx = clusters[i].x - clusters[j].x;
+                        float dy = clusters[i].y - clusters[j].y;
+                        float d = std::sqrt(dx * dx + dy * dy);
+                        return (d < 100.f) ? d : Agglomerator::infDist;
+                    };
+                    auto merge = [&](Id_t i, Id_t j) {
+                        auto& c1 = clusters[i];
+                        auto& c2 = clusters[j];
+                        float weight = c1.weight + c2.weight;
+                        c1.x = (c1.x * c1.weight + c2.x * c2.weight) / weight;
+                        c1.y = (c1.y * c1.weight + c2.y * c2.weight) / weight;
+                        c1.weight = weight;
+                    };
+                    state->agglomerator(distance, merge, Id_t(clusters.size()));
+                };
+            },
+            BenchParams::COUNT};
+
+        Benchmark FMO_UNIQUE_NAME{
+            "fmo::Algorithm",
+            [](const BenchParams& params) -> std::function<void()> {
+                if (params.format == Format::UNKNOWN || params.format == Format::INT32) return {};
+                struct State {
+                    std::unique_ptr<fmo::Algorithm> algorithm;
+                    fmo::Image inputs[3];
+                    int i = 0;
+                };
+                auto state = std::make_shared<State>();
+                fmo::Algorithm::Config config;
+                config.maxImageHeight = params.processingHeight;
+                state->algorithm = fmo::Algorithm::make(config, params.format, params.dims);
+                for (unsigned i = 0; i < 3; i++) {
+                    fillNoise(state->inputs[i], params.format, params.dims, 1 + i);
+                }
+                return [state]() { state->algorithm->setInputView(state->inputs[state->i++ % 3]); };
+            },
+            BenchParams::DIMS | BenchParams::FORMAT | BenchParams::HEIGHT | BenchParams::THREADS};
+
+        Benchmark FMO_UNIQUE_NAME{
+            "fmo::Algorithm, scene",
+            [](const BenchParams& params) -> std::function<void()> {
+                if (params.format == Format::UNKNOWN || params.format == Format::INT32) return {};
+                // a short loop of a synthetic scene with ten fast-moving objects
+                struct State {
+                    std::unique_ptr<fmo::Algorithm> algorithm;
+                    fmo::Image inputs[8];
+                    int i = 0;
+                };
+                auto state = std::make_shared<State>();
+                fmo::Algorithm::Config config;
+                config.maxImageHeight = params.processingHeight;
+                state->algorithm = fmo::Algorithm::make(config, params.format, params.dims);
+                fmo::SceneGenerator::Config sceneConfig;
+                sceneConfig.dims = params.dims;
+                sceneConfig.format = params.format;
+                sceneConfig.numObjects = 10;
+                fmo::SceneGenerator scene{sceneConfig};
+                std::vector<fmo::SpanSet> truth;
+                for (auto& input : state->inputs) { scene.next(input, truth); }
+                return [state]() { state->algorithm->setInputView(state->inputs[state->i++ % 8]); };
+            },
+            BenchParams::DIMS | BenchParams::FORMAT | BenchParams::HEIGHT | BenchParams::THREADS};
 
-        Benchmark FMO_UNIQUE_NAME{"fmo::copy + fmo::Algorithm GRAY", []() {
+        Benchmark FMO_UNIQUE_NAME{"fmo::convert + fmo::Subsampler BGR to YUV", []() {
                                       init();
-                                      static int i = 0;
+                                      fmo::convert(global.bgrNoiseImage, global.convertedImage,
+                                                   fmo::Format::YUV);
+                                      global.subsampler(global.convertedImage, global.outImage);
+                                  },
+                                  NUM_PIXELS};
 
-                                      switch (i++ % 3) {
-                                      case 0:
-                                          fmo::copy(global.grayCirclesImage, global.outImage);
-                                          break;
-                                      case 1:
-                                          fmo::copy(global.grayNoiseImage, global.outImage);
-                                          break;
-                                      case 2:
-                                          fmo::copy(global.grayBlackImage, global.outImage);
-                                          break;
-                                      }
+        Benchmark FMO_UNIQUE_NAME{"fmo::Subsampler BGR to YUV", []() {
+                                      init();
+                                      global.subsampler(global.bgrNoiseImage, global.outImage,
+                                                        fmo::Format::YUV);
+                                  },
+                                  NUM_PIXELS};
 
-                                      global.algorithmGray->setInputSwap(global.outImage);
-                                  }};
+        Benchmark FMO_UNIQUE_NAME{"fmo::Subsampler BGR to GRAY", []() {
+                                      init();
+                                      global.subsampler(global.bgrNoiseImage, global.outImage,
+                                                        fmo::Format::GRAY);
+                                  },
+                                  NUM_PIXELS};
 
         Benchmark FMO_UNIQUE_NAME{"fmo::copy + fmo::Algorithm YUV420SP", []() {
                                       init();
@@ -307,53 +1259,72 @@ namespace fmo {
                                       }
 
                                       global.algorithmYuv420Sp->setInputSwap(global.outImage);
-                                  }};
+                                  },
+                                  NUM_PIXELS};
+
+        Benchmark FMO_UNIQUE_NAME{"fmo::copy + fmo::Algorithm YUV420SP, huge pages", []() {
+                                      init();
+                                      static int i = 0;
+                                      fmo::copy(global.yuv420SpHugeImages[i++ % 3],
+                                                global.outImageHuge);
+                                      global.algorithmYuv420SpHuge->setInputSwap(
+                                          global.outImageHuge);
+                                  },
+                                  NUM_PIXELS};
 
         Benchmark FMO_UNIQUE_NAME{"fmo::copy GRAY", []() {
                                       init();
                                       fmo::copy(global.grayNoiseImage, global.outImage);
-                                  }};
+                                  },
+                                  NUM_PIXELS};
 
         Benchmark FMO_UNIQUE_NAME{"fmo::copy YUV420SP", []() {
                                       init();
                                       fmo::copy(global.yuv420SpNoiseImage, global.outImage);
-                                  }};
+                                  },
+                                  NUM_PIXELS};
 
-        Benchmark FMO_UNIQUE_NAME{"fmo::median3", []() {
+        Benchmark FMO_UNIQUE_NAME{"fmo::copy YUV420SP, huge pages", []() {
                                       init();
-                                      fmo::median3(global.grayNoiseImage, global.grayCirclesImage,
-                                                   global.grayBlackImage, global.outImage);
-                                  }};
+                                      fmo::copy(global.yuv420SpHugeImages[0],
+                                                global.outImageHuge);
+                                  },
+                                  NUM_PIXELS};
 
         Benchmark FMO_UNIQUE_NAME{"cv::bitwise_or", []() {
                                       init();
                                       cv::bitwise_or(global.grayNoise, global.grayCircles,
                                                      global.out1);
-                                  }};
+                                  },
+                                  NUM_PIXELS};
 
         Benchmark FMO_UNIQUE_NAME{"cv::resize/NEAREST", []() {
                                       init();
                                       cv::resize(global.grayNoise, global.out1,
                                                  {Init::W / 2, Init::H / 2}, 0, 0,
                                                  cv::INTER_NEAREST);
-                                  }};
+                                  },
+                                  NUM_PIXELS};
 
         Benchmark FMO_UNIQUE_NAME{"cv::resize/AREA", []() {
                                       init();
                                       cv::resize(global.grayNoise, global.out1,
                                                  {Init::W / 2, Init::H / 2}, 0, 0, cv::INTER_AREA);
-                                  }};
+                                  },
+                                  NUM_PIXELS};
 
         Benchmark FMO_UNIQUE_NAME{"cv::threshold", []() {
                                       init();
                                       cv::threshold(global.grayNoise, global.out1, 0x80, 0xFF,
                                                     cv::THRESH_BINARY);
-                                  }};
+                                  },
+                                  NUM_PIXELS};
 
         Benchmark FMO_UNIQUE_NAME{"cv::absdiff", []() {
                                       init();
                                       cv::absdiff(global.grayNoise, global.grayCircles,
                                                   global.out1);
-                                  }};
+                                  },
+                                  NUM_PIXELS};
     }
 }
@@ -3,6 +3,7 @@
 #include "include-simd.hpp"
 #include <fmo/differentiator.hpp>
 #include <fmo/processing.hpp>
+#include <fmo/trace.hpp>
 
 namespace fmo {
     namespace {
@@ -15,8 +16,8 @@ namespace fmo {
     Differentiator::Config::Config()
         : thresh(24), noiseMin(0.0035), noiseMax(0.0047), adjustPeriod(4) {}
 
-    Differentiator::Differentiator(const Config& cfg)
-        : mCfg(cfg), mThresh(std::min(std::max(cfg.thresh, threshMin), threshMax)) {
+    Differentiator::Differentiator(const Config& cfg, ImagePool* pool)
+        : mCfg(cfg), mPool(pool), mThresh(std::min(std::max(cfg.thresh, threshMin), threshMax)) {
         mNoise.reserve(mCfg.adjustPeriod);
     }
 
@@ -52,47 +53,53 @@ namespace fmo {
             DST_BATCH_SIZE = sizeof(batch_t),
         };
 
-        AddAndThreshJob(const uint8_t* src, uint8_t* dst, uint8_t thresh)
-            : mSrc(src), mDst(dst), mThresh(thresh) {}
-
-        virtual void operator()(const cv::Range& pieces) const override {
-            size_t firstSrc = size_t(pieces.start) * SRC_BATCH_SIZE;
-            size_t lastSrc = size_t(pieces.end) * SRC_BATCH_SIZE;
-            size_t firstDst = size_t(pieces.start) * DST_BATCH_SIZE;
-            const uint8_t* src = mSrc + firstSrc;
-            const uint8_t* srcEnd = mSrc + lastSrc;
-            uint8_t* dst = mDst + firstDst;
-            impl(src, srcEnd, dst, mThresh);
+        AddAndThreshJob(const Mat& src, Mat& dst, uint8_t thresh)
+            : mSrc(src.data()),
+              mDst(dst.data()),
+              mSrcSkip(src.skip()),
+              mDstSkip(dst.skip()),
+              mWidth(size_t(src.dims().width)),
+              mThresh(thresh) {}
+
+        virtual void operator()(const cv::Range& rows) const override {
+            TraceSpan span{"addAndThresh"};
+            const size_t pieces = mWidth / DST_BATCH_SIZE;
+            const int t = int(mThresh);
+
+            for (int row = rows.start; row < rows.end; row++) {
+                const uint8_t* src = mSrc + size_t(row) * mSrcSkip;
+                uint8_t* dst = mDst + size_t(row) * mDstSkip;
+                impl(src, src + pieces * SRC_BATCH_SIZE, dst, mThresh);
+
+                // process the last few pixels of the row individually
+                src += pieces * SRC_BATCH_SIZE;
+                uint8_t* out = dst + pieces * DST_BATCH_SIZE;
+                uint8_t* outEnd = dst + mWidth;
+                for (; out < outEnd; out++, src += 3) {
+                    *out = ((src[0] + src[1] + src[2]) > t) ? uint8_t(0xFF) : uint8_t(0);
+                }
+            }
         }
 
     private:
         const uint8_t* const mSrc;
         uint8_t* const mDst;
+        const size_t mSrcSkip;
+        const size_t mDstSkip;
+        const size_t mWidth;
         uint8_t mThresh;
     };
 
     void addAndThresh(const Image& src, Image& dst, uint8_t thresh) {
         const Format format = src.format();
         const Dims dims = src.dims();
-        const size_t pixels = size_t(dims.width) * size_t(dims.height);
-        const size_t pieces = pixels / AddAndThreshJob::DST_BATCH_SIZE;
 
         if (getPixelStep(format) != 3) { throw std::runtime_error("addAndThresh(): bad format"); }
 
-        // run the job in parallel
+        // run the job in parallel, row by row to respect the row pitch of both images
         dst.resize(Format::GRAY, dims);
-        AddAndThreshJob job{src.data(), dst.data(), thresh};
-        cv::parallel_for_(cv::Range{0, int(pieces)}, job, cv::getNumThreads());
-
-        // process the last few bytes individually
-        size_t lastIndex = pieces * AddAndThreshJob::DST_BATCH_SIZE;
-        const uint8_t* data = src.data() + (lastIndex * 3);
-        uint8_t* out = dst.data() + lastIndex;
-        uint8_t* outEnd = dst.data() + pixels;
-        int t = int(thresh);
-        for (; out < outEnd; out++, data += 3) {
-            *out = ((data[0] + data[1] + data[2]) > t) ? uint8_t(0xFF) : uint8_t(0);
-        }
+        AddAndThreshJob job{src, dst, thresh};
+        cv::parallel_for_(cv::Range{0, dims.height}, job, cv::getNumThreads());
     }
 
     void Differentiator::operator()(const Mat& src1, const Mat& src2, Image& dst) {
@@ -117,6 +124,12 @@ namespace fmo {
             }
         }
 
+        // draw buffers from the pool, so that a change of size doesn't cause an allocation
+        if (mPool != nullptr) {
+            mPool->acquire(mAbsDiff, src1.format(), src1.dims());
+            mPool->acquire(dst, Format::GRAY, src1.dims());
+        }
+
         // calculate absolute differences
         absdiff(src1, src2, mAbsDiff);
 
@@ -0,0 +1,34 @@
+#include <fmo/exchange.hpp>
+
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace fmo {
+#if defined(__linux__)
+    namespace {
+        int* address(std::atomic<uint32_t>& value) { return reinterpret_cast<int*>(&value); }
+    }
+
+    void WaitWord::wait(uint32_t expected) {
+        syscall(SYS_futex, address(value), FUTEX_WAIT_PRIVATE, int(expected), nullptr, nullptr, 0);
+    }
+
+    void WaitWord::wakeAll() {
+        syscall(SYS_futex, address(value), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    void WaitWord::wait(uint32_t expected) {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCondition.wait(lock, [&]() { return value.load() != expected; });
+    }
+
+    void WaitWord::wakeAll() {
+        { std::lock_guard<std::mutex> lock(mMutex); }
+        mCondition.notify_all();
+    }
+#endif
+}
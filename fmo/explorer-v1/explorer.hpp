@@ -36,6 +36,9 @@ namespace fmo {
             return mCache.visColor;
         }
 
+        /// Provides the number of bytes held in image buffers by this instance.
+        virtual size_t getMemoryUsage() const override;
+
     private:
         /// Pos using a small data type for coordinates.
         struct MiniPos {
@@ -139,6 +142,7 @@ namespace fmo {
             MyDetection(const Detection::Object& detObj, const Detection::Predecessor& detPrev,
                         const Trajectory* traj, const ExplorerV1* aMe);
             virtual void getPoints(PointSet& out) const override;
+            virtual void getSpans(SpanSet& out) const override;
 
         private:
             const ExplorerV1* const me;
@@ -182,6 +186,9 @@ namespace fmo {
         /// Locates an object by selecting the best trajectory.
         void findObjects();
 
+        /// Fills the detection storage with the objects that have been accepted this frame.
+        void makeDetections();
+
         /// Determines whether the given trajectory should be considered a fast-moving object.
         bool isObject(Trajectory&) const;
 
@@ -208,6 +215,7 @@ namespace fmo {
         std::vector<int> mSortCache;              ///< for storing and sorting integers
         std::vector<const Trajectory*> mRejected; ///< objects that have been rejected this frame
         std::vector<const Trajectory*> mObjects;  ///< objects that have been accepted this frame
+        std::vector<MyDetection> mDetections;     ///< reported by getOutput(), reused every frame
         int mFrameNum = 0; ///< frame number, 1 when processing the first frame
         Cache mCache;      ///< miscellaneous cached objects
         const Config mCfg; ///< configuration settings
@@ -172,14 +172,55 @@ namespace fmo {
         std::sort(begin(out), end(out), pointSetCompLt);
     }
 
+    void ExplorerV1::MyDetection::getSpans(SpanSet& out) const {
+        out.clear();
+        const Trajectory& traj = *mTraj;
+        int step = me->mLevel.step;
+        int halfStep = step / 2;
+        const uint8_t* data1 = me->mLevel.diff1.data();
+        const uint8_t* data2 = me->mLevel.diff2.data();
+        int skip1 = int(me->mLevel.diff1.skip());
+        int skip2 = int(me->mLevel.diff2.skip());
+
+        // iterate over all strips in trajectory
+        int compIdx = traj.first;
+        while (compIdx != Component::NO_COMPONENT) {
+            const Component& comp = me->mComponents[compIdx];
+            int stripIdx = comp.first;
+            while (stripIdx != Strip::END) {
+                const Strip& strip = me->mStrips[stripIdx];
+                int col = (strip.x - halfStep) / step;
+                int row = (strip.y - halfStep) / step;
+                uint8_t val1 = *(data1 + (row * skip1 + col));
+                uint8_t val2 = *(data2 + (row * skip2 + col));
+
+                // if the center of the strip is in both difference images, add a span for each row
+                if (val1 != 0 && val2 != 0) {
+                    int ye = strip.y + strip.halfHeight;
+                    int xb = strip.x - halfStep;
+                    int xe = strip.x + halfStep;
+
+                    for (int y = strip.y - strip.halfHeight; y < ye; y++) {
+                        out.push_back({y, xb, xe});
+                    }
+                }
+                stripIdx = strip.special;
+            }
+            compIdx = comp.next;
+        }
+
+        // sort and join adjacent strips
+        spanSetNormalize(out);
+    }
+
     namespace {
         Pos center(const fmo::Bounds& b) {
             return{(b.max.x + b.min.x) / 2, (b.max.y + b.min.y) / 2};
         }
     }
 
-    void ExplorerV1::getOutput(Output& out) {
-        out.clear();
+    void ExplorerV1::makeDetections() {
+        mDetections.clear();
         Detection::Object detObj;
         Detection::Predecessor detPrev;
 
@@ -187,8 +228,12 @@ namespace fmo {
             detObj.center = center(traj->bounds1);
             detObj.radius = mComponents[traj->first].approxHalfHeight;
             detPrev.center = center(traj->bounds2);
-            out.detections.emplace_back();
-            out.detections.back().reset(new MyDetection(detObj, detPrev, traj, this));
+            mDetections.emplace_back(detObj, detPrev, traj, this);
         }
     }
+
+    void ExplorerV1::getOutput(Output& out) {
+        out.clear();
+        for (auto& detection : mDetections) { out.detections.push_back(&detection); }
+    }
 }
@@ -12,6 +12,7 @@ namespace fmo {
         level.numStrips = 0;
         Dims dims = level.preprocessed.dims();
         uint8_t* colData = level.preprocessed.data();
+        size_t skip = level.preprocessed.skip();
 
         int black2Prev = 0;
         int blackPrev = 0;
@@ -44,7 +45,7 @@ namespace fmo {
             whitePrev = 0;
             white = 0;
 
-            for (row = 0; row < dims.height; row++, data += dims.width) {
+            for (row = 0; row < dims.height; row++, data += skip) {
                 if (*data != 0) {
                     if (white++ == 0) {
                         black2Prev = blackPrev;
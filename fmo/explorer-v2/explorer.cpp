@@ -17,7 +17,7 @@ namespace fmo {
     ExplorerV2::~ExplorerV2() = default;
 
     ExplorerV2::ExplorerV2(const Config& cfg, Format format, Dims dims)
-        : mDiff(cfg.diff), mCfg(cfg) {
+        : mSubsampler(&mImagePool), mDiff(cfg.diff, &mImagePool), mCfg(cfg) {
         if (dims.width <= 0 || dims.height <= 0 || dims.width > int16_max ||
             dims.height > int16_max) {
             throw std::runtime_error("bad config");
@@ -36,7 +36,7 @@ namespace fmo {
         mSourceLevel.image3.resize(format, dims);
         int step = 1;
 
-        format = mSubsampler.nextFormat(format);
+        format = mSubsampler.nextFormat(format, mCfg.processingFormat);
         dims = mSubsampler.nextDims(dims);
         step = mSubsampler.nextPixelSize(step);
 
@@ -59,6 +59,9 @@ namespace fmo {
         mLevel.diff2.resize(Format::GRAY, dims);
         mLevel.preprocessed.resize(Format::GRAY, dims);
         mLevel.step = step;
+
+        mProfiler.setStages({"createLevelPyramid", "preprocess", "findStrips", "findComponents",
+                            "findClusters", "findObjects", "makeDetections"});
     }
 
     void ExplorerV2::setInputSwap(Image& input) {
@@ -70,11 +73,35 @@ namespace fmo {
         }
 
         mFrameNum++;
+        mProfiler.start();
         createLevelPyramid(input);
+        mProfiler.lap();
         preprocess();
+        mProfiler.lap();
         findStrips();
+        mProfiler.lap();
         findComponents();
+        mProfiler.lap();
         findClusters();
+        mProfiler.lap();
         findObjects();
+        mProfiler.lap();
+        makeDetections();
+        mProfiler.lap();
+        mProfiler.stop();
+    }
+
+    size_t ExplorerV2::getMemoryUsage() const {
+        size_t result = Algorithm::getMemoryUsage() + mSubsampler.memoryUsage();
+        result += mDiff.memoryUsage();
+        for (const Image* image : {&mSourceLevel.image1, &mSourceLevel.image2,
+                                   &mSourceLevel.image3, &mLevel.image1, &mLevel.image2,
+                                   &mLevel.image3, &mLevel.diff1, &mLevel.diff2,
+                                   &mLevel.preprocessed, &mCache.visDiffGray,
+                                   &mCache.visDiffColor, &mCache.visColor}) {
+            result += image->capacity();
+        }
+        for (auto& level : mIgnoredLevels) { result += level.image.capacity(); }
+        return result;
     }
 }
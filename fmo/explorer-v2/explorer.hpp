@@ -39,6 +39,9 @@ namespace fmo {
             return mCache.visColor;
         }
 
+        /// Provides the number of bytes held in image buffers by this instance.
+        virtual size_t getMemoryUsage() const override;
+
     private:
         /// Data related to source images.
         struct SourceLevel {
@@ -120,6 +123,7 @@ namespace fmo {
             MyDetection(const Detection::Object& detObj, const Detection::Predecessor& detPrev,
                         const Cluster* cluster, const ExplorerV2* aMe);
             virtual void getPoints(PointSet& out) const override;
+            virtual void getSpans(SpanSet& out) const override;
 
         private:
             const ExplorerV2* const me;
@@ -159,6 +163,9 @@ namespace fmo {
         /// Locates an object by selecting the best trajectory.
         void findObjects();
 
+        /// Fills the detection storage with the objects that have been accepted this frame.
+        void makeDetections();
+
         /// Determines whether the given trajectory should be considered a fast-moving object.
         bool isObject(Cluster&) const;
 
@@ -182,6 +189,7 @@ namespace fmo {
         std::vector<Component> mComponents;       ///< detected components, ordered by x coordinate
         std::vector<Cluster> mClusters;           ///< detected clusters in no particular order
         std::vector<const Cluster*> mObjects;     ///< objects that have been accepted this frame
+        std::vector<MyDetection> mDetections;     ///< reported by getOutput(), reused every frame
         int mFrameNum = 0; ///< frame number, 1 when processing the first frame
         Cache mCache;      ///< miscellaneous cached objects
         const Config mCfg; ///< configuration settings
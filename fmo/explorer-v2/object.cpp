@@ -138,6 +138,36 @@ namespace fmo {
         std::sort(begin(out), end(out), pointSetCompLt);
     }
 
+    void ExplorerV2::MyDetection::getSpans(SpanSet& out) const {
+        out.clear();
+        auto& obj = *mCluster;
+        int halfStep = me->mLevel.step / 2;
+        int minX = std::max(obj.bounds1.min.x, obj.bounds2.min.x);
+        int maxX = std::min(obj.bounds1.max.x, obj.bounds2.max.x);
+
+        // iterate over all strips in cluster
+        int index = obj.l.strip;
+        while (index != Special::END) {
+            auto& strip = me->mStrips[index];
+
+            // if the center of the strip is in both bounding boxes, add a span for each row
+            if (strip.pos.x >= minX && strip.pos.x <= maxX) {
+                int ye = strip.pos.y + strip.halfDims.height;
+                int xb = strip.pos.x - halfStep;
+                int xe = strip.pos.x + halfStep;
+
+                for (int y = strip.pos.y - strip.halfDims.height; y < ye; y++) {
+                    out.push_back({y, xb, xe});
+                }
+            }
+
+            index = next(strip);
+        }
+
+        // sort and join adjacent strips
+        spanSetNormalize(out);
+    }
+
     namespace {
         Pos center(const fmo::Bounds& b) {
             return {(b.max.x + b.min.x) / 2, (b.max.y + b.min.y) / 2};
@@ -146,8 +176,8 @@ namespace fmo {
         float average(float v1, float v2) { return (v1 + v2) / 2; }
     }
 
-    void ExplorerV2::getOutput(Output& out) {
-        out.clear();
+    void ExplorerV2::makeDetections() {
+        mDetections.clear();
         Detection::Object detObj;
         Detection::Predecessor detPrev;
 
@@ -155,8 +185,12 @@ namespace fmo {
             detObj.center = center(cluster->bounds1);
             detObj.radius = average(cluster->approxHeightMin, cluster->approxHeightMax);
             detPrev.center = center(cluster->bounds2);
-            out.detections.emplace_back();
-            out.detections.back().reset(new MyDetection(detObj, detPrev, cluster, this));
+            mDetections.emplace_back(detObj, detPrev, cluster, this);
         }
     }
+
+    void ExplorerV2::getOutput(Output& out) {
+        out.clear();
+        for (auto& detection : mDetections) { out.detections.push_back(&detection); }
+    }
 }
@@ -14,16 +14,20 @@ namespace fmo {
             prevLevelImage = &level.image1;
         }
 
+        // conversion to the processing format is fused with the first decimation
+        Format format = mCfg.processingFormat;
+
         for (auto& level : mIgnoredLevels) {
-            mSubsampler(*prevLevelImage, level.image);
+            mSubsampler(*prevLevelImage, level.image, format);
             prevLevelImage = &level.image;
+            format = Format::UNKNOWN;
         }
 
         {
             auto& level = mLevel;
             level.image2.swap(level.image3);
             level.image1.swap(level.image2);
-            mSubsampler(*prevLevelImage, level.image1);
+            mSubsampler(*prevLevelImage, level.image1, format);
             prevLevelImage = &level.image1;
         }
     }
@@ -17,7 +17,7 @@ namespace fmo {
     ExplorerV3::~ExplorerV3() = default;
 
     ExplorerV3::ExplorerV3(const Config& cfg, Format format, Dims dims)
-        : mDiff(cfg.diff), mCfg(cfg) {
+        : mSubsampler(&mImagePool), mDiff(cfg.diff, &mImagePool), mCfg(cfg) {
         if (dims.width <= 0 || dims.height <= 0 || dims.width > int16_max ||
             dims.height > int16_max) {
             throw std::runtime_error("bad config");
@@ -28,54 +28,123 @@ namespace fmo {
                 "bad config: expecting height to be larger than maxImageHeight");
         }
 
-        // allocate the source level
+        // allocate the source level, unless the source images are not retained
         mSourceLevel.format = format;
         mSourceLevel.dims = dims;
-        mSourceLevel.image1.resize(format, dims);
-        mSourceLevel.image2.resize(format, dims);
-        mSourceLevel.image3.resize(format, dims);
-        int step = 1;
+        if (!mCfg.leanMemory) {
+            mSourceLevel.image1.resize(format, dims);
+            mSourceLevel.image2.resize(format, dims);
+            mSourceLevel.image3.resize(format, dims);
+        }
+
+        // create the remaining levels
+        createLevels(0);
+        mGovernor.configure(mCfg.latencyBudget, mCfg.latencyHysteresis,
+                            mLevel.image1.dims().height);
+
+        mProfiler.setStages({"createLevelPyramid", "preprocess", "findProtoStrips",
+                            "findMetaStrips", "findComponents", "findClusters", "findObjects",
+                            "makeDetections"});
+        mFlightRecorder.configure(mCfg.flightRecorderThreshold, mCfg.flightRecorderDir, mProfiler);
+    }
 
-        format = mSubsampler.nextFormat(format);
-        dims = mSubsampler.nextDims(dims);
-        step = mSubsampler.nextPixelSize(step);
+    void ExplorerV3::createLevels(int extraLevels) {
+        Format format = mSubsampler.nextFormat(mSourceLevel.format, mCfg.processingFormat);
+        Dims dims = mSubsampler.nextDims(mSourceLevel.dims);
+        int step = mSubsampler.nextPixelSize(1);
+        int numIgnored = 0;
 
-        // create as many decimation levels as required to get below maximum height
-        mIgnoredLevels.reserve(4);
-        while (dims.height > mCfg.maxImageHeight) {
-            mIgnoredLevels.emplace_back();
-            mIgnoredLevels.back().image.resize(format, dims);
+        auto ignoreLevel = [&]() {
+            if (int(mIgnoredLevels.size()) == numIgnored) { mIgnoredLevels.emplace_back(); }
+            auto& image = mIgnoredLevels[numIgnored++].image;
+            if (!mCfg.leanMemory) { mImagePool.acquire(image, format, dims); }
 
             format = mSubsampler.nextFormat(format);
             dims = mSubsampler.nextDims(dims);
             step = mSubsampler.nextPixelSize(step);
+        };
+
+        // create as many decimation levels as required to get below maximum height, then add the
+        // levels requested by the latency governor
+        while (dims.height > mCfg.maxImageHeight) { ignoreLevel(); }
+        for (int i = 0; i < extraLevels; i++) { ignoreLevel(); }
+        for (int i = numIgnored; i < int(mIgnoredLevels.size()); i++) {
+            mImagePool.release(mIgnoredLevels[i].image);
         }
+        mIgnoredLevels.resize(numIgnored);
 
-        // allocate the processed level
-        mLevel.image1.resize(format, dims);
-        mLevel.image2.resize(format, dims);
-        mLevel.image3.resize(format, dims);
-        mLevel.diff1.resize(Format::GRAY, dims);
-        mLevel.diff2.resize(Format::GRAY, dims);
-        mLevel.preprocessed.resize(Format::GRAY, dims);
+        // allocate the processed level, reusing buffers when switching between levels
+        for (Image* image : {&mLevel.image1, &mLevel.image2, &mLevel.image3, &mLevel.diff1,
+                             &mLevel.diff2, &mLevel.preprocessed}) {
+            image->setRowAlign(ROW_ALIGN);
+        }
+        mImagePool.acquire(mLevel.image1, format, dims);
+        mImagePool.acquire(mLevel.image2, format, dims);
+        mImagePool.acquire(mLevel.image3, format, dims);
+        mImagePool.acquire(mLevel.diff1, Format::GRAY, dims);
+        mImagePool.acquire(mLevel.diff2, Format::GRAY, dims);
+        mImagePool.acquire(mLevel.preprocessed, Format::GRAY, dims);
+        mLevel.strips1.clear();
+        mLevel.strips2.clear();
         mLevel.step = step;
+        mLevel.extraLevels = extraLevels;
     }
 
-    void ExplorerV3::setInputSwap(Image& input) {
-        if (input.format() != mSourceLevel.image1.format()) {
-            throw std::runtime_error("setInputSwap(): bad format");
+    void ExplorerV3::setInputSwap(Image& input) { process(input, &input); }
+
+    void ExplorerV3::setInputView(const Mat& input) { process(input, nullptr); }
+
+    void ExplorerV3::process(const Mat& input, Image* swapInput) {
+        if (input.format() != mSourceLevel.format) {
+            throw std::runtime_error("setInput(): bad format");
+        }
+        if (input.dims() != mSourceLevel.dims) {
+            throw std::runtime_error("setInput(): bad dimensions");
         }
-        if (input.dims() != mSourceLevel.image1.dims()) {
-            throw std::runtime_error("setInputSwap(): bad dimensions");
+
+        // switch processing level if required by the latency governor, start from scratch
+        if (mGovernor.level() != mLevel.extraLevels) {
+            createLevels(mGovernor.level());
+            mFrameNum = 0;
         }
 
+        mGovernor.frameStart();
+        mFlightRecorder.frameStart();
         mFrameNum++;
-        createLevelPyramid(input);
+        mProfiler.start();
+        createLevelPyramid(input, swapInput);
+        mFlightRecorder.keepInput(mLevel.image1, mFrameNum);
+        mProfiler.lap();
         preprocess();
+        mProfiler.lap();
         findProtoStrips();
+        mProfiler.lap();
         findMetaStrips();
+        mProfiler.lap();
         findComponents();
+        mProfiler.lap();
         findClusters();
+        mProfiler.lap();
         findObjects();
+        mProfiler.lap();
+        makeDetections();
+        mProfiler.lap();
+        mProfiler.stop();
+        mGovernor.frameEnd();
+        mFlightRecorder.frameEnd(mProfiler, mDiff.thresh(), int(mLevel.metaStrips.size()));
+    }
+
+    size_t ExplorerV3::getMemoryUsage() const {
+        size_t result = Algorithm::getMemoryUsage() + mSubsampler.memoryUsage();
+        result += mDiff.memoryUsage();
+        for (const Image* image : {&mSourceLevel.image1, &mSourceLevel.image2,
+                                   &mSourceLevel.image3, &mLevel.image1, &mLevel.image2,
+                                   &mLevel.image3, &mLevel.diff1, &mLevel.diff2,
+                                   &mLevel.preprocessed, &mCache.visDiffGray,
+                                   &mCache.visDiffColor, &mCache.visColor}) {
+            result += image->capacity();
+        }
+        for (auto& level : mIgnoredLevels) { result += level.image.capacity(); }
+        return result;
     }
 }
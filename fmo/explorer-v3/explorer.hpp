@@ -22,6 +22,12 @@ namespace fmo {
         /// the contents of the provided input image with an internal buffer.
         virtual void setInputSwap(Image& input) override;
 
+        /// To be called every frame instead of setInputSwap(), providing the next image as a
+        /// read-only view. The first decimation reads directly from the view. No source-resolution
+        /// images are retained, except for a copy of the newest input for the debug image if
+        /// setKeepInput() is enabled.
+        virtual void setInputView(const Mat& input) override;
+
         /// To be called every frame, obtaining a list of fast-moving objects that have been
         /// detected this frame. The returned objects (i.e. instances of class Detection) may be
         /// used only before the next call to setInputSwap().
@@ -39,6 +45,9 @@ namespace fmo {
             return mCache.visColor;
         }
 
+        /// Provides the number of bytes held in image buffers by this instance.
+        virtual size_t getMemoryUsage() const override;
+
     private:
         /// Strip generated by searching in a difference image.
         using ProtoStrip = Strip;
@@ -111,6 +120,7 @@ namespace fmo {
             MyDetection(const Detection::Object& detObj, const Detection::Predecessor& detPrev,
                         const Cluster* cluster, const ExplorerV3* aMe);
             virtual void getPoints(PointSet& out) const override;
+            virtual void getSpans(SpanSet& out) const override;
 
         private:
             const ExplorerV3* const me;
@@ -145,6 +155,7 @@ namespace fmo {
             std::vector<MetaStrip> metaStrips; ///< strips created by merging proto-strips
             Image preprocessed;                ///< image ready for strip detection
             int step;                          ///< relative pixel width (due to downscaling)
+            int extraLevels = 0;               ///< levels added by the latency governor
             int numStrips = 0;                 ///< number of strips detected this frame
         };
 
@@ -157,8 +168,16 @@ namespace fmo {
             std::vector<std::pair<float, Cluster*>> sortClusters;
         };
 
+        /// Allocates the decimation levels and the processed level. The processed level is placed
+        /// extraLevels decimation steps below the level determined by Config::maxImageHeight.
+        void createLevels(int extraLevels);
+
         /// Creates low-resolution versions of the source image using decimation.
-        void createLevelPyramid(Image& input);
+        void createLevelPyramid(const Mat& input, Image* swapInput);
+
+        /// Runs all processing stages. If swapInput is not null, it is the same image as input and
+        /// it is received by swapping, unless Config::leanMemory is set.
+        void process(const Mat& input, Image* swapInput);
 
         /// Applies image-wide operations before strips are detected.
         void preprocess();
@@ -181,6 +200,9 @@ namespace fmo {
         /// Locates an object by selecting the best trajectory.
         void findObjects();
 
+        /// Fills the detection storage with the objects that have been accepted this frame.
+        void makeDetections();
+
         /// Determines whether the given trajectory should be considered a fast-moving object.
         bool isObject(Cluster&) const;
 
@@ -202,7 +224,8 @@ namespace fmo {
         std::vector<Component> mComponents;       ///< detected components, ordered by x coordinate
         std::vector<Cluster> mClusters;           ///< detected clusters in no particular order
         std::vector<const Cluster*> mObjects;     ///< objects that have been accepted this frame
-        int mFrameNum = 0; ///< frame number, 1 when processing the first frame
+        std::vector<MyDetection> mDetections;     ///< reported by getOutput(), reused every frame
+        int mFrameNum = 0; ///< frame number at the current level, 1 when processing the first frame
         Cache mCache;      ///< miscellaneous cached objects
         const Config mCfg; ///< configuration settings
     };
@@ -131,6 +131,33 @@ namespace fmo {
         std::sort(begin(out), end(out), pointSetCompLt);
     }
 
+    void ExplorerV3::MyDetection::getSpans(SpanSet& out) const {
+        out.clear();
+        auto& obj = *mCluster;
+
+        // iterate over all strips in cluster
+        int index = obj.l.strip;
+        while (index != MetaStrip::END) {
+            auto& strip = me->mLevel.metaStrips[index];
+
+            // if strip is in both diffs, add a span for each row of the strip
+            if (strip.older && strip.newer) {
+                int ye = strip.pos.y + strip.halfDims.height;
+                int xb = strip.pos.x - strip.halfDims.width;
+                int xe = strip.pos.x + strip.halfDims.width;
+
+                for (int y = strip.pos.y - strip.halfDims.height; y < ye; y++) {
+                    out.push_back({y, xb, xe});
+                }
+            }
+
+            index = strip.next;
+        }
+
+        // sort and join adjacent strips
+        spanSetNormalize(out);
+    }
+
     namespace {
         Pos center(const fmo::Bounds& b) {
             return {(b.max.x + b.min.x) / 2, (b.max.y + b.min.y) / 2};
@@ -139,8 +166,8 @@ namespace fmo {
         float average(float v1, float v2) { return (v1 + v2) / 2; }
     }
 
-    void ExplorerV3::getOutput(Output& out) {
-        out.clear();
+    void ExplorerV3::makeDetections() {
+        mDetections.clear();
         Detection::Object detObj;
         Detection::Predecessor detPrev;
 
@@ -148,8 +175,12 @@ namespace fmo {
             detObj.center = center(cluster->bounds1);
             detObj.radius = average(cluster->approxHeightMin, cluster->approxHeightMax);
             detPrev.center = center(cluster->bounds2);
-            out.detections.emplace_back();
-            out.detections.back().reset(new MyDetection(detObj, detPrev, cluster, this));
+            mDetections.emplace_back(detObj, detPrev, cluster, this);
         }
     }
+
+    void ExplorerV3::getOutput(Output& out) {
+        out.clear();
+        for (auto& detection : mDetections) { out.detections.push_back(&detection); }
+    }
 }
@@ -3,27 +3,53 @@
 #include <fmo/processing.hpp>
 
 namespace fmo {
-    void ExplorerV3::createLevelPyramid(Image& input) {
-        const Mat* prevLevelImage;
+    void ExplorerV3::createLevelPyramid(const Mat& input, Image* swapInput) {
+        if (mCfg.leanMemory) {
+            // stream the input through the ignored levels, keeping only the processed level
+            auto& level = mLevel;
+            level.image2.swap(level.image3);
+            level.image1.swap(level.image2);
+            int levels = int(mIgnoredLevels.size()) + 1;
+            mSubsampler.decimate(input, level.image1, levels, mCfg.processingFormat);
+            return;
+        }
+
+        const Mat* prevLevelImage = &input;
 
         {
             auto& level = mSourceLevel;
-            level.image2.swap(level.image3);
-            level.image1.swap(level.image2);
-            input.swap(level.image1);
-            prevLevelImage = &level.image1;
+            if (swapInput != nullptr) {
+                level.image2.swap(level.image3);
+                level.image1.swap(level.image2);
+                swapInput->swap(level.image1);
+                prevLevelImage = &level.image1;
+            } else {
+                // older source images are only needed by setInputSwap(), release them
+                for (Image* image : {&level.image2, &level.image3}) { Image{}.swap(*image); }
+
+                // the newest image is only needed for visualization
+                if (mKeepInput) {
+                    copy(input, level.image1);
+                } else {
+                    Image{}.swap(level.image1);
+                }
+            }
         }
 
+        // conversion to the processing format is fused with the first decimation
+        Format format = mCfg.processingFormat;
+
         for (auto& level : mIgnoredLevels) {
-            mSubsampler(*prevLevelImage, level.image);
+            mSubsampler(*prevLevelImage, level.image, format);
             prevLevelImage = &level.image;
+            format = Format::UNKNOWN;
         }
 
         {
             auto& level = mLevel;
             level.image2.swap(level.image3);
             level.image1.swap(level.image2);
-            mSubsampler(*prevLevelImage, level.image1);
+            mSubsampler(*prevLevelImage, level.image1, format);
             prevLevelImage = &level.image1;
         }
     }
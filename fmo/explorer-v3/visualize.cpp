@@ -15,8 +15,13 @@ namespace fmo {
     }
 
     void ExplorerV3::visualize() {
-        // cover the visualization image with the latest input image
-        copy(mSourceLevel.image1, mCache.visColor, Format::BGR);
+        // cover the visualization image with the latest input image, if it has been kept
+        if (mSourceLevel.image1.dims() == mSourceLevel.dims) {
+            copy(mSourceLevel.image1, mCache.visColor, Format::BGR);
+        } else {
+            mCache.visColor.resize(Format::BGR, mSourceLevel.dims);
+            mCache.visColor.wrap().setTo(uint8_t(0x00));
+        }
         cv::Mat result = mCache.visColor.wrap();
 
         // scale the current diff to source size
@@ -0,0 +1,311 @@
+#include "image-util.hpp"
+#include <algorithm>
+#include <fmo/flightrecorder.hpp>
+#include <fmo/processing.hpp>
+#include <fmo/queue.hpp>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace fmo {
+    namespace {
+        double toMs(int64_t ns) { return double(ns) / 1e6; }
+
+        /// Provides the part of a path after the last separator.
+        std::string fileName(const std::string& path) {
+            auto pos = path.find_last_of("/\\");
+            return (pos == std::string::npos) ? path : path.substr(pos + 1);
+        }
+
+        /// Provides the part of a path up to and including the last separator.
+        std::string directoryOf(const std::string& path) {
+            auto pos = path.find_last_of("/\\");
+            return (pos == std::string::npos) ? std::string{} : path.substr(0, pos + 1);
+        }
+    }
+
+    /// Kept frames handed over to the writer thread. The buffers travel back and forth between
+    /// the recorder and the writer, so that they are allocated only once.
+    struct FlightRecorder::Dump {
+        std::string prefix;                  ///< path of the files without the extension
+        float thresholdMs = 0;               ///< threshold that the last frame exceeded
+        std::vector<std::string> stageNames; ///< names of the stages in Snapshot::stagesNs
+        Snapshot frames[NUM_FRAMES];         ///< kept frames, oldest first
+        int numFrames = 0;                   ///< number of valid entries in frames
+    };
+
+    /// Writes dumps to disk in a separate thread.
+    struct FlightRecorder::Writer {
+        Writer(FlightRecorder* recorder)
+            : mRecorder(recorder), mQueue(queueConfig()), mThread(threadImpl, this) {}
+
+        ~Writer() {
+            // let the thread write the remaining dumps
+            mQueue.exit();
+            mThread.join();
+        }
+
+        /// Passes a dump to the writer thread. The argument receives the buffers of a free slot.
+        ///
+        /// @return False if the writer is still busy with earlier dumps.
+        bool send(Dump& dump) { return mQueue.swapSend(dump); }
+
+    private:
+        static QueueConfig queueConfig() {
+            // when the disk cannot keep up, the dumps that are already queued are more valuable
+            QueueConfig cfg;
+            cfg.capacity = 2;
+            cfg.policy = QueuePolicy::DROP_NEWEST;
+            return cfg;
+        }
+
+        static void threadImpl(Writer* self) {
+            Dump dump;
+            std::string error;
+
+            while (self->mQueue.swapReceive(dump)) {
+                error.clear();
+                try {
+                    write(dump);
+                } catch (std::exception& e) { error = e.what(); }
+
+                if (error.empty()) {
+                    self->mRecorder->succeeded(dump.prefix + ".txt");
+                } else {
+                    self->mRecorder->failed(error);
+                }
+            }
+        }
+
+        static void write(const Dump& dump) {
+            std::ofstream out{dump.prefix + ".txt"};
+            if (!out) { throw std::runtime_error("failed to open " + dump.prefix + ".txt"); }
+
+            out << "# frames preceding and including a frame that took longer than "
+                << dump.thresholdMs << " ms\n";
+            out << "threshold-ms " << dump.thresholdMs << '\n';
+
+            for (int i = 0; i < dump.numFrames; i++) {
+                auto& snapshot = dump.frames[i];
+                std::string imageFile = dump.prefix + "-" + std::to_string(i) + ".png";
+                save(snapshot.input, imageFile);
+
+                // images are listed relative to the text file so that dumps can be moved around
+                out << "\nframe " << snapshot.frameNum << '\n';
+                out << "image " << fileName(imageFile) << '\n';
+                out << "format " << formatName(snapshot.input.format()) << '\n';
+                out << "dims " << snapshot.input.dims().width << ' '
+                    << snapshot.input.dims().height << '\n';
+                out << "diff-thresh " << snapshot.diffThresh << '\n';
+                out << "num-strips " << snapshot.numStrips << '\n';
+                out << "total-ms " << toMs(snapshot.totalNs) << '\n';
+                for (int j = 0; j < int(snapshot.stagesNs.size()); j++) {
+                    out << "stage-ms " << dump.stageNames[j] << ' '
+                        << toMs(snapshot.stagesNs[j]) << '\n';
+                }
+            }
+
+            out.flush();
+            if (!out) { throw std::runtime_error("failed to write " + dump.prefix + ".txt"); }
+        }
+
+        // data
+        FlightRecorder* const mRecorder;
+        Queue<Dump> mQueue;
+        std::thread mThread;
+    };
+
+    FlightRecorder::FlightRecorder() : mPending(new Dump) {}
+
+    FlightRecorder::~FlightRecorder() { flush(); }
+
+    void FlightRecorder::configure(float thresholdMs, const std::string& dir,
+                                   Profiler& profiler) {
+        flush();
+        mThresholdNs = int64_t(double(thresholdMs) * 1e6);
+        mDir = dir;
+        mNumFrames = 0;
+        profiler.setRecording(enabled());
+        if (!enabled()) return;
+
+        for (auto& snapshot : mSnapshots) {
+            snapshot.stagesNs.assign(size_t(profiler.numStages()), 0);
+        }
+    }
+
+    void FlightRecorder::frameStartImpl() {
+        mStartNs = nanoTime();
+        auto& snapshot = mSnapshots[mNumFrames++ % NUM_FRAMES];
+        snapshot.frameNum = -1;
+    }
+
+    void FlightRecorder::keepInputImpl(const Mat& input, int frameNum) {
+        auto& snapshot = mSnapshots[(mNumFrames - 1) % NUM_FRAMES];
+        snapshot.frameNum = frameNum;
+        copy(input, snapshot.input);
+    }
+
+    bool FlightRecorder::frameEndImpl(const Profiler& profiler, int diffThresh, int numStrips) {
+        auto& snapshot = mSnapshots[(mNumFrames - 1) % NUM_FRAMES];
+        snapshot.totalNs = nanoTime() - mStartNs;
+        snapshot.diffThresh = diffThresh;
+        snapshot.numStrips = numStrips;
+        for (int i = 0; i < int(snapshot.stagesNs.size()); i++) {
+            snapshot.stagesNs[i] = profiler.lastNs(i);
+        }
+
+        if (snapshot.totalNs <= mThresholdNs || mNumHandedOver == MAX_DUMPS) return false;
+        dump(profiler);
+        return true;
+    }
+
+    void FlightRecorder::dump(const Profiler& profiler) {
+        Dump& dump = *mPending;
+        dump.prefix = mDir + "/fmo-frame-" + std::to_string(mNumFrames);
+        dump.thresholdMs = float(toMs(mThresholdNs));
+        dump.stageNames.resize(size_t(profiler.numStages()));
+        for (int i = 0; i < profiler.numStages(); i++) {
+            dump.stageNames[i] = profiler.stageName(i);
+        }
+
+        dump.numFrames = 0;
+        int64_t first = std::max(mNumFrames - NUM_FRAMES, int64_t(0));
+        for (int64_t i = first; i < mNumFrames; i++) {
+            auto& snapshot = mSnapshots[i % NUM_FRAMES];
+            if (snapshot.frameNum == -1) continue;
+            auto& kept = dump.frames[dump.numFrames++];
+            kept.frameNum = snapshot.frameNum;
+            copy(snapshot.input, kept.input);
+            kept.diffThresh = snapshot.diffThresh;
+            kept.numStrips = snapshot.numStrips;
+            kept.totalNs = snapshot.totalNs;
+            kept.stagesNs = snapshot.stagesNs;
+        }
+
+        mNumHandedOver++;
+        if (!mWriter) mWriter.reset(new Writer(this));
+        if (!mWriter->send(dump)) { failed("writer busy, dropped " + dump.prefix + ".txt"); }
+    }
+
+    void FlightRecorder::flush() { mWriter.reset(); }
+
+    void FlightRecorder::succeeded(const std::string& file) {
+        std::lock_guard<std::mutex> lock(mStatusMutex);
+        mNumDumps++;
+        mLastDump = file;
+    }
+
+    void FlightRecorder::failed(const std::string& error) {
+        std::cerr << "FlightRecorder: " << error << '\n';
+        std::lock_guard<std::mutex> lock(mStatusMutex);
+        mNumFailures++;
+        mLastError = error;
+    }
+
+    int FlightRecorder::numDumps() const {
+        std::lock_guard<std::mutex> lock(mStatusMutex);
+        return mNumDumps;
+    }
+
+    int FlightRecorder::numFailures() const {
+        std::lock_guard<std::mutex> lock(mStatusMutex);
+        return mNumFailures;
+    }
+
+    std::string FlightRecorder::lastDump() const {
+        std::lock_guard<std::mutex> lock(mStatusMutex);
+        return mLastDump;
+    }
+
+    std::string FlightRecorder::lastError() const {
+        std::lock_guard<std::mutex> lock(mStatusMutex);
+        return mLastError;
+    }
+
+    FlightRecorder::Recording FlightRecorder::load(const std::string& file) {
+        std::ifstream in{file};
+        if (!in) { throw std::runtime_error("FlightRecorder: failed to open " + file); }
+        auto fail = [&](const std::string& what) {
+            throw std::runtime_error("FlightRecorder: " + what + " in " + file);
+        };
+
+        Recording result;
+        std::string dir = directoryOf(file);
+        std::string line;
+        std::string key;
+        std::string imageFile;
+        Format format = Format::UNKNOWN;
+        Dims dims{0, 0};
+
+        // images are read once the whole frame has been parsed
+        auto loadImage = [&]() {
+            if (result.frames.empty()) return;
+            Image image{dir + imageFile, format};
+            if (image.dims() != dims) fail("unexpected image size");
+            result.frames.back().input = std::move(image);
+        };
+
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream fields{line};
+            fields >> key;
+
+            if (key == "threshold-ms") {
+                fields >> result.thresholdMs;
+            } else if (key == "frame") {
+                loadImage();
+                result.frames.emplace_back();
+                fields >> result.frames.back().frameNum;
+            } else if (result.frames.empty()) {
+                fail("\"" + key + "\" before the first frame");
+            } else if (key == "image") {
+                fields >> imageFile;
+            } else if (key == "format") {
+                std::string name;
+                fields >> name;
+                format = formatFromName(name.c_str());
+                if (format == Format::UNKNOWN) fail("unknown format " + name);
+            } else if (key == "dims") {
+                fields >> dims.width >> dims.height;
+            } else if (key == "diff-thresh") {
+                fields >> result.frames.back().diffThresh;
+            } else if (key == "num-strips") {
+                fields >> result.frames.back().numStrips;
+            } else if (key == "total-ms") {
+                double ms = 0;
+                fields >> ms;
+                result.frames.back().totalNs = int64_t(ms * 1e6);
+            } else if (key == "stage-ms") {
+                std::string name;
+                double ms = 0;
+                fields >> name >> ms;
+                auto& stagesNs = result.frames.back().stagesNs;
+                if (result.frames.size() == 1) result.stageNames.push_back(name);
+                if (stagesNs.size() >= result.stageNames.size()) fail("unexpected stage " + name);
+                stagesNs.push_back(int64_t(ms * 1e6));
+            } else {
+                fail("unknown key \"" + key + "\"");
+            }
+
+            if (fields.fail()) fail("malformed line \"" + line + "\"");
+        }
+
+        loadImage();
+        return result;
+    }
+
+    void FlightRecorder::replayInput(const Snapshot& snapshot, Image& dst) {
+        Format format = snapshot.input.format();
+        if (isSemiPlanar(format) || isPacked422(format)) {
+            throw std::runtime_error("FlightRecorder: replay not supported for " +
+                                     std::string(formatName(format)));
+        }
+
+        Dims dims = snapshot.input.dims();
+        dst.resize(format, {2 * dims.width, 2 * dims.height});
+        cv::resize(snapshot.input.wrap(), dst.wrap(), {2 * dims.width, 2 * dims.height}, 0, 0,
+                   cv::INTER_NEAREST);
+    }
+}
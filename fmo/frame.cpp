@@ -0,0 +1,90 @@
+#include <fmo/frame.hpp>
+#include <mutex>
+#include <vector>
+
+namespace fmo {
+    /// Data shared by a pool and all of its buffers.
+    struct FramePoolState {
+        Format format;
+        Dims dims;
+        std::mutex mutex;
+        std::vector<Frame::Buffer*> free; ///< buffers ready for reuse
+        int numAllocated = 0;             ///< number of buffers in existence
+        bool closed = false;              ///< the pool has been destroyed
+    };
+
+    void Frame::release() noexcept {
+        if (!mBuffer) return;
+        Buffer* buffer = mBuffer;
+        mBuffer = nullptr;
+        if (buffer->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+        // the last reference is gone, return the buffer to the pool
+        FramePoolState& pool = *buffer->pool;
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (!pool.closed) {
+                pool.free.push_back(buffer);
+                return;
+            }
+            pool.numAllocated--;
+        }
+        delete buffer;
+    }
+
+    Image Frame::share() const {
+        // the reference taken here is dropped by the release function
+        Buffer* buffer = mBuffer;
+        acquire();
+        const Image& image = buffer->image;
+        auto* data = const_cast<uint8_t*>(image.data());
+        return {image.format(), image.dims(), data, [buffer](uint8_t*) {
+                    Frame frame;
+                    frame.mBuffer = buffer;
+                }};
+    }
+
+    FramePool::FramePool(Format format, Dims dims) : mState(std::make_shared<FramePoolState>()) {
+        mState->format = format;
+        mState->dims = dims;
+    }
+
+    FramePool::~FramePool() {
+        std::lock_guard<std::mutex> lock(mState->mutex);
+        mState->closed = true;
+        for (auto* buffer : mState->free) { delete buffer; }
+        mState->numAllocated -= int(mState->free.size());
+        mState->free.clear();
+    }
+
+    Frame::Buffer* FramePool::take() {
+        {
+            std::lock_guard<std::mutex> lock(mState->mutex);
+            if (!mState->free.empty()) {
+                Frame::Buffer* buffer = mState->free.back();
+                mState->free.pop_back();
+                return buffer;
+            }
+        }
+
+        std::unique_ptr<Frame::Buffer> buffer{new Frame::Buffer};
+        buffer->image.resize(mState->format, mState->dims);
+        buffer->pool = mState;
+
+        // make sure that returning the buffer to the pool won't allocate
+        std::lock_guard<std::mutex> lock(mState->mutex);
+        mState->numAllocated++;
+        mState->free.reserve(mState->numAllocated);
+        return buffer.release();
+    }
+
+    int FramePool::numAllocated() const {
+        std::lock_guard<std::mutex> lock(mState->mutex);
+        return mState->numAllocated;
+    }
+
+    int FramePool::numFree() const {
+        std::lock_guard<std::mutex> lock(mState->mutex);
+        return int(mState->free.size());
+    }
+}
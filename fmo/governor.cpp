@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <fmo/governor.hpp>
+
+namespace fmo {
+    void LatencyGovernor::configure(float budgetMs, float hysteresis, int height) {
+        mBudgetNs = int64_t(double(budgetMs) * 1e6);
+        mFinerNs = int64_t(double(budgetMs) * double(hysteresis) * 1e6);
+        mLevel = 0;
+        mMaxLevel = 0;
+        mNumSamples = 0;
+        for (height /= 2; height >= MIN_HEIGHT; height /= 2) { mMaxLevel++; }
+    }
+
+    bool LatencyGovernor::add(int64_t frameNs) {
+        mNumFrames++;
+        mSamples[mNumSamples++] = frameNs;
+        if (mNumSamples != WINDOW) return false;
+        mNumSamples = 0;
+
+        // find the 95% quantile of frame time in the last window
+        auto iter95 = begin(mSamples) + (95 * WINDOW) / 100;
+        std::nth_element(begin(mSamples), iter95, end(mSamples));
+        int64_t q95 = *iter95;
+
+        int newLevel = mLevel;
+        if (q95 > mBudgetNs && mLevel < mMaxLevel) {
+            newLevel++;
+        } else if (q95 < mFinerNs && mLevel > 0) {
+            newLevel--;
+        }
+
+        if (newLevel == mLevel) return false;
+        mLastSwitch.frameNum = mNumFrames;
+        mLastSwitch.oldLevel = mLevel;
+        mLastSwitch.newLevel = newLevel;
+        mLastSwitch.q95Ms = float(double(q95) / 1e6);
+        mLevel = newLevel;
+        mNumSwitches++;
+        return true;
+    }
+}
@@ -17,6 +17,13 @@ namespace fmo {
         case Format::YUV420SP:
             result = (result * 3) / 2;
             break;
+        case Format::YUYV:
+        case Format::UYVY:
+            result *= 2;
+            break;
+        case Format::P010:
+            result *= 3;
+            break;
         default:
             throw std::runtime_error("getNumBytes: unsupported format");
         }
@@ -24,15 +31,33 @@ namespace fmo {
         return result;
     }
 
+    size_t getNumBytes(Format format, Dims dims, size_t pitch) {
+        if (pitch == getRowBytes(format, dims.width)) return getNumBytes(format, dims);
+        size_t rows = static_cast<size_t>(dims.height);
+        if (isSemiPlanar(format)) { rows += rows / 2; }
+        return rows * pitch;
+    }
+
+    size_t getRowBytes(Format format, int width) {
+        if (format == Format::YUV420SP) return static_cast<size_t>(width);
+        if (format == Format::P010) return static_cast<size_t>(width) * 2;
+        return static_cast<size_t>(width) * getPixelStep(format);
+    }
+
+    size_t getPitch(Format format, int width, size_t rowAlign) {
+        size_t rowBytes = getRowBytes(format, width);
+        return ((rowBytes + rowAlign - 1) / rowAlign) * rowAlign;
+    }
+
     cv::Size getCvSize(Format format, Dims dims) {
         cv::Size result{dims.width, dims.height};
-        if (format == Format::YUV420SP) { result.height = (result.height * 3) / 2; }
+        if (isSemiPlanar(format)) { result.height = (result.height * 3) / 2; }
         return result;
     }
 
     Dims getDims(Format format, cv::Size size) {
         Dims result{size.width, size.height};
-        if (format == Format::YUV420SP) { result.height = (result.height * 2) / 3; }
+        if (isSemiPlanar(format)) { result.height = (result.height * 2) / 3; }
         return result;
     }
 
@@ -47,6 +72,11 @@ namespace fmo {
             return CV_32SC1;
         case Format::YUV420SP:
             return CV_8UC1;
+        case Format::YUYV:
+        case Format::UYVY:
+            return CV_8UC2;
+        case Format::P010:
+            return CV_16UC1;
         default:
             throw std::runtime_error("getCvType: unsupported format");
         }
@@ -61,22 +91,35 @@ namespace fmo {
             return 3;
         case Format::INT32:
             return 4;
+        case Format::YUYV:
+        case Format::UYVY:
+            return 2;
         case Format::YUV420SP:
             throw std::runtime_error("getPixelStep: not applicable to YUV420SP");
+        case Format::P010:
+            throw std::runtime_error("getPixelStep: not applicable to P010");
         default:
             throw std::runtime_error("getPixelStep: unsupported format");
         }
     }
 
+    bool isSemiPlanar(Format format) {
+        return format == Format::YUV420SP || format == Format::P010;
+    }
+
+    bool isPacked422(Format format) { return format == Format::YUYV || format == Format::UYVY; }
+
     cv::Mat yuv420SPWrapGray(const Mat& mat) {
         Dims dims = mat.dims();
+        int cols = (mat.format() == Format::P010) ? (2 * dims.width) : dims.width;
         uint8_t* data = const_cast<uint8_t*>(mat.data());
-        return {cv::Size(dims.width, dims.height), CV_8UC1, data};
+        return {cv::Size(cols, dims.height), CV_8UC1, data, mat.skip()};
     }
 
     cv::Mat yuv420SPWrapUV(const Mat& mat) {
         Dims dims = mat.dims();
+        int cols = (mat.format() == Format::P010) ? (2 * dims.width) : dims.width;
         uint8_t* data = const_cast<uint8_t*>(mat.uvData());
-        return {cv::Size(dims.width, dims.height / 2), CV_8UC1, data};
+        return {cv::Size(cols, dims.height / 2), CV_8UC1, data, mat.skip()};
     }
 }
@@ -8,25 +8,43 @@ namespace fmo {
     /// Get the number of bytes of data that an image requires, given its format and dimensions.
     size_t getNumBytes(Format format, Dims dims);
 
+    /// Get the number of bytes of data that an image requires, given its format, dimensions, and
+    /// the number of bytes in a row including padding.
+    size_t getNumBytes(Format format, Dims dims, size_t pitch);
+
+    /// Get the number of bytes in a row of an image without padding.
+    size_t getRowBytes(Format format, int width);
+
+    /// Get the number of bytes in a row of an image with rows padded to a multiple of rowAlign.
+    size_t getPitch(Format format, int width, size_t rowAlign);
+
     /// Convert the actual dimensions to the size that is used by OpenCV. OpenCV considers YUV
-    /// 4:2:0 SP images 1.5x taller.
+    /// 4:2:0 SP images (YUV420SP, P010) 1.5x taller.
     cv::Size getCvSize(Format format, Dims dims);
 
     /// Convert the size used by OpenCV to the actual dimensions. OpenCV considers YUV 4:2:0 SP
-    /// images 1.5x taller.
+    /// images (YUV420SP, P010) 1.5x taller.
     Dims getDims(Format format, cv::Size size);
 
     /// Get the Mat data type used by OpenCV that corresponds to the format.
     int getCvType(Format format);
 
     /// Get the number of bytes between a color value and the next one. This makes sense only
-    /// for interleaved formats, such as GRAY, BGR, or INT32.
+    /// for interleaved formats, such as GRAY, BGR, or INT32. For YUYV and UYVY, this is the
+    /// number of bytes between luma values.
     size_t getPixelStep(Format format);
 
-    /// Access the gray channel of a YUV420SP mat.
+    /// Whether the image stores luma in one plane, followed by a plane of interleaved chroma
+    /// samples at half resolution, as YUV420SP and P010 do.
+    bool isSemiPlanar(Format format);
+
+    /// Whether two horizontally adjacent pixels share chroma samples, as in YUYV and UYVY.
+    bool isPacked422(Format format);
+
+    /// Access the gray channel of a YUV420SP or P010 mat, as bytes.
     cv::Mat yuv420SPWrapGray(const Mat& mat);
 
-    /// Access the UV channel of a YUV420SP mat.
+    /// Access the UV channel of a YUV420SP or P010 mat, as bytes.
     cv::Mat yuv420SPWrapUV(const Mat& mat);
 }
 
@@ -1,8 +1,45 @@
 #include "image-util.hpp"
 #include <fmo/assert.hpp>
 #include <fmo/region.hpp>
+#include <cstring>
 
 namespace fmo {
+    namespace {
+        const Format allFormats[] = {Format::UNKNOWN, Format::GRAY,     Format::BGR,
+                                     Format::YUV,     Format::INT32,    Format::YUV420SP,
+                                     Format::YUYV,    Format::UYVY,     Format::P010};
+    }
+
+    const char* formatName(Format format) {
+        switch (format) {
+        case Format::GRAY:
+            return "GRAY";
+        case Format::BGR:
+            return "BGR";
+        case Format::YUV:
+            return "YUV";
+        case Format::INT32:
+            return "INT32";
+        case Format::YUV420SP:
+            return "YUV420SP";
+        case Format::YUYV:
+            return "YUYV";
+        case Format::UYVY:
+            return "UYVY";
+        case Format::P010:
+            return "P010";
+        default:
+            return "UNKNOWN";
+        }
+    }
+
+    Format formatFromName(const char* name) {
+        for (Format format : allFormats) {
+            if (std::strcmp(formatName(format), name) == 0) return format;
+        }
+        return Format::UNKNOWN;
+    }
+
     Image::Image(const std::string& filename, Format format) {
         cv::Mat mat;
 
@@ -27,14 +64,68 @@ namespace fmo {
         std::copy(mat.data, mat.data + mData.size(), mData.data());
         mFormat = format;
         mDims = dims;
+        mPitch = getRowBytes(format, dims.width);
     }
 
     void Image::assign(Format format, Dims dims, const uint8_t* data) {
-        size_t bytes = getNumBytes(format, dims);
-        mData.resize(bytes);
-        mDims = dims;
+        releaseAdopted();
+        resize(format, dims);
+        size_t rowBytes = getRowBytes(format, dims.width);
+
+        if (mPitch == rowBytes) {
+            std::copy(data, data + mData.size(), mData.data());
+            return;
+        }
+
+        // copy row by row, skipping the padding
+        int rows = isSemiPlanar(format) ? (dims.height + dims.height / 2) : dims.height;
+        uint8_t* dst = mData.data();
+        for (int row = 0; row < rows; row++, data += rowBytes, dst += mPitch) {
+            std::copy(data, data + rowBytes, dst);
+        }
+    }
+
+    void Image::copyFrom(const Image& rhs) {
+        if (rhs.adopted()) {
+            // adopted buffers are never padded
+            assign(rhs.mFormat, rhs.mDims, rhs.mAdopted);
+            return;
+        }
+
+        releaseAdopted();
+        mRowAlign = rhs.mRowAlign;
+        resize(rhs.mFormat, rhs.mDims);
+        std::copy(rhs.mData.data(), rhs.mData.data() + mData.size(), mData.data());
+    }
+
+    void Image::adopt(Format format, Dims dims, uint8_t* data, Release release) {
+        if (data == nullptr) { throw std::runtime_error("adopt: null data"); }
+        releaseAdopted();
+        mData.clear();
         mFormat = format;
-        std::copy(data, data + bytes, mData.data());
+        mDims = dims;
+        mPitch = getRowBytes(format, dims.width);
+        mAdopted = data;
+        mAdoptedSize = getNumBytes(format, dims);
+        mRelease = std::move(release);
+    }
+
+    void Image::releaseAdopted() noexcept {
+        if (mAdopted == nullptr) return;
+        uint8_t* data = mAdopted;
+        mAdopted = nullptr;
+        mAdoptedSize = 0;
+        if (mRelease) {
+            mRelease(data);
+            mRelease = nullptr;
+        }
+    }
+
+    void Image::setRowAlign(size_t rowAlign) {
+        if (rowAlign == 0 || (rowAlign & (rowAlign - 1)) != 0 || rowAlign > 128) {
+            throw std::runtime_error("setRowAlign: alignment must be a power of 2, at most 128");
+        }
+        mRowAlign = rowAlign;
     }
 
     Region Image::region(Pos pos, Dims dims) {
@@ -43,27 +134,32 @@ namespace fmo {
             throw std::runtime_error("region outside image");
         }
 
-        auto rowStep = static_cast<size_t>(mDims.width);
+        auto rowStep = mPitch;
 
-        if (mFormat == Format::YUV420SP) {
+        if (isSemiPlanar(mFormat)) {
             if (pos.x % 2 != 0 || pos.y % 2 != 0 || dims.width % 2 != 0 || dims.height % 2 != 0) {
-                throw std::runtime_error("region: YUV420SP regions must be aligned to 2px");
+                throw std::runtime_error("region: 4:2:0 regions must be aligned to 2px");
             }
 
+            size_t colBytes = getRowBytes(mFormat, pos.x);
+
             uint8_t* start = data();
-            start += static_cast<size_t>(pos.x);
+            start += colBytes;
             start += rowStep * static_cast<size_t>(pos.y);
 
             uint8_t* uvStart = uvData();
-            uvStart += static_cast<size_t>(pos.x);
+            uvStart += colBytes;
             uvStart += rowStep * static_cast<size_t>(pos.y / 2);
 
-            return {Format::YUV420SP, pos, dims, start, uvStart, rowStep};
+            return {mFormat, pos, dims, start, uvStart, rowStep};
         } else {
+            if (isPacked422(mFormat) && (pos.x % 2 != 0 || dims.width % 2 != 0)) {
+                throw std::runtime_error("region: 4:2:2 regions must be aligned to 2px");
+            }
+
             size_t pixelStep = getPixelStep(mFormat);
-            rowStep *= pixelStep;
 
-            uint8_t* start = mData.data();
+            uint8_t* start = data();
             start += pixelStep * static_cast<size_t>(pos.x);
             start += rowStep * static_cast<size_t>(pos.y);
 
@@ -72,16 +168,24 @@ namespace fmo {
     }
 
     void Image::resize(Format format, Dims dims) {
-        size_t bytes = getNumBytes(format, dims);
+        if (mAdopted != nullptr) {
+            if (format == mFormat && dims == mDims) return;
+            releaseAdopted();
+        }
+
+        mPitch = getPitch(format, dims.width, mRowAlign);
+        size_t bytes = getNumBytes(format, dims, mPitch);
         mData.resize(bytes);
         mDims = dims;
         mFormat = format;
     }
 
-    cv::Mat Image::wrap() { return {getCvSize(mFormat, mDims), getCvType(mFormat), mData.data()}; }
+    cv::Mat Image::wrap() {
+        return {getCvSize(mFormat, mDims), getCvType(mFormat), data(), mPitch};
+    }
 
     cv::Mat Image::wrap() const {
-        auto* ptr = const_cast<uint8_t*>(mData.data());
-        return {getCvSize(mFormat, mDims), getCvType(mFormat), ptr};
+        auto* ptr = const_cast<uint8_t*>(data());
+        return {getCvSize(mFormat, mDims), getCvType(mFormat), ptr, mPitch};
     }
 }
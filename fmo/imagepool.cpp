@@ -0,0 +1,45 @@
+#include <fmo/imagepool.hpp>
+
+namespace fmo {
+    void ImagePool::acquire(Image& image, Format format, Dims dims) {
+        if (image.format() == format && image.dims() == dims) {
+            mStats.hits++;
+            return;
+        }
+
+        size_t rowAlign = image.rowAlign();
+        release(image);
+        for (auto& free : mFree) {
+            if (free.format() == format && free.dims() == dims && free.rowAlign() == rowAlign) {
+                image.swap(free);
+                free.swap(mFree.back());
+                mFree.pop_back();
+                mStats.hits++;
+                return;
+            }
+        }
+
+        mStats.misses++;
+        detail::ScopedAllocPolicy policy{mAllocPolicy};
+        image.setRowAlign(rowAlign);
+        image.resize(format, dims);
+    }
+
+    void ImagePool::release(Image& image) {
+        if (image.adopted()) {
+            // adopted buffers go back to their owner, never into the pool
+            image.clear();
+            return;
+        }
+
+        if (image.size() == 0) return;
+        mFree.emplace_back();
+        mFree.back().swap(image);
+    }
+
+    size_t ImagePool::numFreeBytes() const {
+        size_t result = 0;
+        for (auto& image : mFree) { result += image.capacity(); }
+        return result;
+    }
+}
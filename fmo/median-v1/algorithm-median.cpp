@@ -11,68 +11,167 @@ namespace fmo {
     }
 
     MedianV1::MedianV1(const Config& cfg, Format format, Dims dims)
-        : mCfg(cfg), mSourceLevel{{format, dims}, 0}, mDiff(cfg.diff) {}
+        : mCfg(cfg),
+          mSourceLevel{format, dims, {}, 0},
+          mSubsampler(&mImagePool),
+          mDiff(cfg.diff, &mImagePool) {
+        mProfiler.setStages({"swapAndSubsampleInput", "computeBinDiff", "findComponents",
+                            "findObjects", "matchObjects", "selectObjects", "makeDetections"});
+
+        // the latency governor may add decimation levels below the regular processing level
+        int numLevels = 0;
+        while (dims.height > mCfg.maxImageHeight) {
+            dims = mSubsampler.nextDims(dims);
+            numLevels++;
+        }
+        mGovernor.configure(mCfg.latencyBudget, mCfg.latencyHysteresis, dims.height);
+        mCache.subsampled.resize(numLevels + mGovernor.maxLevel());
+        mFlightRecorder.configure(mCfg.flightRecorderThreshold, mCfg.flightRecorderDir, mProfiler);
+
+        // pad the rows of processed images
+        for (auto& image : mCache.subsampled) { image.setRowAlign(ROW_ALIGN); }
+        for (auto& image : mProcessingLevel.inputs) { image.setRowAlign(ROW_ALIGN); }
+        mProcessingLevel.background.setRowAlign(ROW_ALIGN);
+        mProcessingLevel.binDiff.setRowAlign(ROW_ALIGN);
+    }
 
     void MedianV1::setInputSwap(Image& in) {
-        swapAndSubsampleInput(in);
+        checkInput(in);
+        if (mCfg.leanMemory) {
+            // the source image is not retained
+            process(in);
+            return;
+        }
+        mSourceLevel.image.swap(in);
+        process(mSourceLevel.image);
+    }
+
+    void MedianV1::setInputView(const Mat& in) {
+        checkInput(in);
+        mSourceLevel.image.clear();
+        process(in);
+    }
+
+    void MedianV1::process(const Mat& in) {
+        mGovernor.frameStart();
+        mFlightRecorder.frameStart();
+        mProfiler.start();
+        subsampleInput(in);
+        mFlightRecorder.keepInput(mProcessingLevel.inputs[0], mSourceLevel.frameNum);
+        mProfiler.lap();
         computeBinDiff();
+        mProfiler.lap();
         findComponents();
+        mProfiler.lap();
         findObjects();
+        mProfiler.lap();
         matchObjects();
+        mProfiler.lap();
         selectObjects();
+        mProfiler.lap();
+        makeDetections();
+        mProfiler.lap();
         // add steps here...
+        mProfiler.stop();
+        mGovernor.frameEnd();
+        mFlightRecorder.frameEnd(mProfiler, mDiff.thresh(), int(mStrips.size()));
     }
 
-    void MedianV1::swapAndSubsampleInput(Image& in) {
-        if (in.format() != mSourceLevel.image.format()) {
-            throw std::runtime_error("setInputSwap(): bad format");
+    void MedianV1::checkInput(const Mat& in) const {
+        if (in.format() != mSourceLevel.format) {
+            throw std::runtime_error("setInput(): bad format");
         }
 
-        if (in.dims() != mSourceLevel.image.dims()) {
-            throw std::runtime_error("setInputSwap(): bad dimensions");
+        if (in.dims() != mSourceLevel.dims) {
+            throw std::runtime_error("setInput(): bad dimensions");
         }
+    }
 
-        mSourceLevel.image.swap(in);
+    void MedianV1::subsampleInput(const Mat& in) {
         mSourceLevel.frameNum++;
 
-        // subsample until the image size is below a set height
+        // subsample until the image size is below a set height, then as many more times as
+        // requested by the latency governor
         int pixelSizeLog2 = 0;
-        Image* input = &mSourceLevel.image;
+        const Mat* input = &in;
+        Image* output = nullptr;
+
+        // conversion to the processing format is fused with the first decimation
+        Format format = mCfg.processingFormat;
 
-        for (; input->dims().height > mCfg.maxImageHeight; pixelSizeLog2++) {
-            if (int(mCache.subsampled.size()) == pixelSizeLog2) {
-                mCache.subsampled.emplace_back(new Image);
+        auto decimate = [&]() {
+            output = &mCache.subsampled.at(pixelSizeLog2);
+            mImagePool.acquire(*output, mSubsampler.nextFormat(input->format(), format),
+                               mSubsampler.nextDims(input->dims()));
+            mSubsampler(*input, *output, format);
+            input = output;
+            pixelSizeLog2++;
+            format = Format::UNKNOWN;
+        };
+
+        if (mCfg.leanMemory) {
+            // stream the input through the intermediate levels, keeping only the last one
+            for (Dims dims = in.dims(); dims.height > mCfg.maxImageHeight;) {
+                dims = mSubsampler.nextDims(dims);
+                pixelSizeLog2++;
+            }
+            pixelSizeLog2 += mGovernor.level();
+            if (pixelSizeLog2 > 0) {
+                output = &mCache.subsampled.at(pixelSizeLog2 - 1);
+                mSubsampler.decimate(in, *output, pixelSizeLog2, format);
             }
-            auto& next = *mCache.subsampled[pixelSizeLog2];
-            mSubsampler(*input, next);
-            input = &next;
+        } else {
+            while (input->dims().height > mCfg.maxImageHeight) { decimate(); }
+            for (int i = 0; i < mGovernor.level(); i++) { decimate(); }
         }
 
         // need at least one decimation to happen
         // - because strips use integral half heights
         // - becuase we want the source image untouched
         if (pixelSizeLog2 == 0) {
-            throw std::runtime_error("setInputSwap(): input image too small");
+            throw std::runtime_error("setInput(): input image too small");
+        }
+
+        // after a change of processing level, forget the history at the previous level
+        if (pixelSizeLog2 != mProcessingLevel.pixelSizeLog2) {
+            mProcessingLevel.numInputs = 0;
+            for (auto& objects : mObjects) { objects.clear(); }
         }
 
         // swap the product of decimation into the processing level
         mProcessingLevel.inputs[2].swap(mProcessingLevel.inputs[1]);
         mProcessingLevel.inputs[1].swap(mProcessingLevel.inputs[0]);
-        mProcessingLevel.inputs[0].swap(*input);
+        mProcessingLevel.inputs[0].swap(*output);
         mProcessingLevel.pixelSizeLog2 = pixelSizeLog2;
+        mProcessingLevel.numInputs++;
     }
 
     void MedianV1::computeBinDiff() {
         auto& level = mProcessingLevel;
 
-        if (mSourceLevel.frameNum < 3) {
+        if (level.numInputs < 3) {
             // initial frames: just generate a black diff
-            level.binDiff.resize(Format::GRAY, level.inputs[0].dims());
+            mImagePool.acquire(level.binDiff, Format::GRAY, level.inputs[0].dims());
             level.binDiff.wrap().setTo(uint8_t(0x00));
             return;
         }
 
+        mImagePool.acquire(level.background, level.inputs[0].format(), level.inputs[0].dims());
         fmo::median3(level.inputs[0], level.inputs[1], level.inputs[2], level.background);
         mDiff(level.inputs[0], level.background, level.binDiff);
     }
+
+    size_t MedianV1::getMemoryUsage() const {
+        size_t result = Algorithm::getMemoryUsage() + mSubsampler.memoryUsage();
+        result += mDiff.memoryUsage();
+        for (const Image* image :
+             {&mSourceLevel.image, &mProcessingLevel.inputs[0], &mProcessingLevel.inputs[1],
+              &mProcessingLevel.inputs[2], &mProcessingLevel.background, &mProcessingLevel.binDiff,
+              &mCache.inputConverted, &mCache.diffConverted, &mCache.diffScaled,
+              &mCache.visualized, &mCache.pointsRaster}) {
+            result += image->capacity();
+        }
+        for (auto& image : mCache.subsampled) { result += image.capacity(); }
+        return result;
+    }
 }
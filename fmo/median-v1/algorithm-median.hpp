@@ -22,6 +22,11 @@ namespace fmo {
         /// the contents of the provided input image with an internal buffer.
         virtual void setInputSwap(Image&) override;
 
+        /// To be called every frame instead of setInputSwap(), providing the next image as a
+        /// read-only view. The first decimation reads directly from the view; no source-resolution
+        /// data is kept, since neither the output nor the debug image need it.
+        virtual void setInputView(const Mat&) override;
+
         /// To be called every frame, obtaining a list of fast-moving objects that have been
         /// detected this frame. The returned objects (i.e. instances of class Detection) may be
         /// used only before the next call to setInputSwap().
@@ -36,7 +41,12 @@ namespace fmo {
         /// the input image.
         virtual const Image& getDebugImage() override;
 
+        /// Provides the number of bytes held in image buffers by this instance.
+        virtual size_t getMemoryUsage() const override;
+
     private:
+        friend struct MedianV1Bench;
+
         // structures
 
         /// Special values used instead of indices.
@@ -88,17 +98,28 @@ namespace fmo {
             MyDetection(const Detection::Object& detObj, const Detection::Predecessor& detPrev,
                         const MedianV1::Object* obj, MedianV1* aMe);
             virtual void getPoints(PointSet& out) const override;
+            virtual void getSpans(SpanSet& out) const override;
 
         private:
+            /// Draws the object into a temporary image, returns the location of the image.
+            Bounds rasterize() const;
+
             MedianV1* me;
             const MedianV1::Object* mObj;
         };
 
         // methods
 
-        /// Subsamples the input image until it is below a set height; saves the source image and the
-        /// subsampled image.
-        void swapAndSubsampleInput(Image& in);
+        /// Runs all processing stages on the input image, which has already been validated.
+        void process(const Mat& in);
+
+        /// Throws if the input image doesn't have the format and dimensions given upon
+        /// construction.
+        void checkInput(const Mat& in) const;
+
+        /// Subsamples the input image until it is below a set height, and then as many more times
+        /// as required by the latency governor; saves the subsampled image.
+        void subsampleInput(const Mat& in);
 
         /// Calculates the per-pixel median of the last three frames to obtain the background.
         /// Creates a binary difference image of background vs. the latest image.
@@ -117,6 +138,9 @@ namespace fmo {
         /// Selects the objects that appear to be fast-moving throughout the last three frames.
         void selectObjects();
 
+        /// Fills the detection storage with the objects selected in the frame being reported.
+        void makeDetections();
+
         /// Tests whether a triplet of objects from consecutive frames should be considered as a
         /// detection of a fast-moving object.
         bool selectable(Object& o0, Object& o1, Object& o2) const;
@@ -129,12 +153,15 @@ namespace fmo {
         const Config mCfg; ///< configuration received upon construction
 
         struct {
-            Image image;  ///< latest source image
-            int frameNum; ///< the number of images received so far
+            Format format; ///< source format
+            Dims dims;     ///< source dimensions
+            Image image;   ///< latest source image received by setInputSwap()
+            int frameNum;  ///< the number of images received so far
         } mSourceLevel;
 
         struct {
-            int pixelSizeLog2;     ///< processing-level pixel size compared to source level, log2
+            int pixelSizeLog2 = 0; ///< processing-level pixel size compared to source level, log2
+            int numInputs = 0;     ///< number of inputs received at the current pixel size
             Image inputs[3];       ///< input images subsampled to processing resolution, 0 - newest
             Image background;      ///< median of the last three inputs
             Image binDiff;         ///< binary difference image, latest image vs. background
@@ -142,16 +169,16 @@ namespace fmo {
         } mProcessingLevel;
 
         struct {
-            std::vector<std::unique_ptr<Image>> subsampled; ///< cached decimation steps
-            Image inputConverted;       ///< latest processing input converted to BGR
-            Image diffConverted;        ///< latest diff converted to BGR
-            Image diffScaled;           ///< latest diff rescaled to source dimensions
-            Image visualized;           ///< debug visualization
-            std::vector<Pos16> upper;   ///< series of points at the top of a component
-            std::vector<Pos16> lower;   ///< series of points at the bottom of a component
-            std::vector<Pos16> temp;    ///< general points temporary
-            std::vector<Match> matches; ///< for keeping scores when matching objects
-            Image pointsRaster;         ///< for rasterization when generating pixel coords
+            std::vector<Image> subsampled; ///< cached decimation steps
+            Image inputConverted;          ///< latest processing input converted to BGR
+            Image diffConverted;           ///< latest diff converted to BGR
+            Image diffScaled;              ///< latest diff rescaled to source dimensions
+            Image visualized;              ///< debug visualization
+            std::vector<Pos16> upper;      ///< series of points at the top of a component
+            std::vector<Pos16> lower;      ///< series of points at the bottom of a component
+            std::vector<Pos16> temp;       ///< general points temporary
+            std::vector<Match> matches;    ///< for keeping scores when matching objects
+            Image pointsRaster;            ///< for rasterization when generating pixel coords
         } mCache;
 
         Subsampler mSubsampler;               ///< decimation tool that handles any image format
@@ -161,6 +188,7 @@ namespace fmo {
         std::vector<int16_t> mNextStrip;    ///< indices of the next strip in component
         std::vector<Component> mComponents; ///< connected components
         std::vector<Object> mObjects[4];    ///< objects, 0 - newest
+        std::vector<MyDetection> mDetections; ///< reported by getOutput(), reused every frame
     };
 }
 
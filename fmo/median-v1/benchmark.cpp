@@ -0,0 +1,120 @@
+#include "algorithm-median.hpp"
+#include <algorithm>
+#include <fmo/benchmark.hpp>
+#include <limits>
+#include <memory>
+
+namespace fmo {
+    /// Feeds synthetic strips, components and objects to the stages of MedianV1 whose duration
+    /// grows faster than linearly with the number of items. The stages are called directly, so
+    /// that each benchmark covers a single stage.
+    struct MedianV1Bench {
+        /// Ratio of source to processing resolution, as if the source were four times larger.
+        static constexpr int STEP = 4;
+
+        /// Creates an instance with the given processing-level dimensions.
+        static std::unique_ptr<MedianV1> make(const Algorithm::Config& config, Dims dims) {
+            Dims source{dims.width * STEP, dims.height * STEP};
+            std::unique_ptr<MedianV1> me{new MedianV1(config, Format::GRAY, source)};
+            me->mProcessingLevel.pixelSizeLog2 = 2;
+            return me;
+        }
+
+        /// A difference image with n short vertical bars, arranged in rows. Bars in neighboring
+        /// columns are joined into horizontal components.
+        static std::function<void()> findComponents(const BenchParams& params) {
+            const Dims dims{2048, 300};
+            const int barHeight = 4;
+            const int rowPitch = 20;
+            const int numRows = dims.height / rowPitch;
+            if (params.count > numRows * (dims.width / 2)) return {};
+
+            std::shared_ptr<MedianV1> me = make(Algorithm::Config{}, dims);
+            auto& binDiff = me->mProcessingLevel.binDiff;
+            binDiff.resize(Format::GRAY, dims);
+            std::fill(binDiff.begin(), binDiff.end(), uint8_t(0));
+            for (int i = 0; i < params.count; i++) {
+                int x = 2 * (i / numRows);
+                int y = (i % numRows) * rowPitch + rowPitch / 2;
+                for (int row = y; row < y + barHeight; row++) {
+                    binDiff.data()[row * binDiff.skip() + x] = 0xFF;
+                }
+            }
+
+            return [me]() { me->findComponents(); };
+        }
+
+        /// n components of three slanted strips each, and n objects from two frames ago, which
+        /// every new object is compared with.
+        static std::function<void()> findObjects(const BenchParams& params) {
+            const int perRow = 100;
+            const int numStrips = 3;
+            if (params.count * numStrips > std::numeric_limits<int16_t>::max()) return {};
+
+            Algorithm::Config config;
+            config.minStripsInObject = numStrips;
+            std::shared_ptr<MedianV1> me = make(config, {1000, 1500});
+            for (int i = 0; i < params.count; i++) {
+                int x = 40 + (i % perRow) * 40;
+                int y = 40 + (i / perRow) * 60;
+                me->mComponents.emplace_back(int16_t(me->mStrips.size()));
+                for (int j = 0; j < numStrips; j++) {
+                    Pos16 pos{int16_t(x + STEP * j), int16_t(y + STEP * j)};
+                    me->mStrips.emplace_back(pos, Dims16{STEP / 2, 6});
+                    bool last = j == numStrips - 1;
+                    me->mNextStrip.push_back(last ? int16_t(MedianV1::END)
+                                                  : int16_t(me->mStrips.size()));
+                }
+            }
+
+            // objects two frames ago, placed between the new ones
+            auto older = std::make_shared<std::vector<MedianV1::Object>>();
+            for (int i = 0; i < params.count; i++) {
+                MedianV1::Object o;
+                o.center = {60 + (i % perRow) * 40, 70 + (i / perRow) * 60};
+                o.halfLen[0] = 6.f;
+                older->push_back(o);
+            }
+
+            return [me, older]() {
+                // findObjects() shifts the objects by one frame, so the older objects are
+                // inserted one frame later and taken back afterwards
+                me->mObjects[1].swap(*older);
+                me->findObjects();
+                me->mObjects[2].swap(*older);
+            };
+        }
+
+        /// n objects in each of two consecutive frames. Each object has exactly one viable match
+        /// in the other frame.
+        static std::function<void()> matchObjects(const BenchParams& params) {
+            const int perRow = 100;
+            std::shared_ptr<MedianV1> me = make(Algorithm::Config{}, {1000, 1500});
+            for (int i = 0; i < params.count; i++) {
+                MedianV1::Object o;
+                o.id = i;
+                o.center = {100 + (i % perRow) * 100, 100 + (i / perRow) * 100};
+                o.area = 100.f;
+                o.direction = NormVector{1.f, 0.f};
+                o.halfLen[0] = 8.f;
+                o.halfLen[1] = 3.f;
+                o.aspect = o.halfLen[0] / o.halfLen[1];
+                me->mObjects[1].push_back(o);
+                o.center.x += 20;
+                me->mObjects[0].push_back(o);
+            }
+
+            return [me]() { me->matchObjects(); };
+        }
+    };
+
+    void registerMedianV1Benchmarks() {
+        auto& registry = Registry::get();
+        registry.add("fmo::MedianV1::findComponents", MedianV1Bench::findComponents,
+                     BenchParams::COUNT);
+        registry.add("fmo::MedianV1::findObjects", MedianV1Bench::findObjects,
+                     BenchParams::COUNT);
+        registry.add("fmo::MedianV1::matchObjects", MedianV1Bench::matchObjects,
+                     BenchParams::COUNT);
+    }
+}
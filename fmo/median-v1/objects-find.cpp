@@ -9,7 +9,7 @@ namespace fmo {
         mObjects[1].swap(mObjects[0]);
         mObjects[0].clear();
 
-        const Dims dims = mSourceLevel.image.dims();
+        const Dims dims = mSourceLevel.dims;
         const float imageArea = float(dims.width * dims.height);
         const int step = 1 << mProcessingLevel.pixelSizeLog2;
 
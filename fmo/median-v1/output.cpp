@@ -18,13 +18,13 @@ namespace fmo {
         Bounds b{{int(aMin.x), int(aMin.y)}, {int(aMax.x), int(aMax.y)}};
         b.min.x = std::max(b.min.x, 0);
         b.min.y = std::max(b.min.y, 0);
-        b.max.x = std::min(b.max.x, mSourceLevel.image.dims().width - 1);
-        b.max.y = std::min(b.max.y, mSourceLevel.image.dims().height - 1);
+        b.max.x = std::min(b.max.x, mSourceLevel.dims.width - 1);
+        b.max.y = std::min(b.max.y, mSourceLevel.dims.height - 1);
         return b;
     }
 
-    void MedianV1::getOutput(Output& out) {
-        out.clear();
+    void MedianV1::makeDetections() {
+        mDetections.clear();
         Detection::Predecessor detPrev;
         Detection::Object detObj;
         float radiusCorr = mCfg.outputRadiusCorr * float(1 << (mProcessingLevel.pixelSizeLog2 - 1));
@@ -90,17 +90,21 @@ namespace fmo {
             // calculate velocity, average over two frames if there are both neighbors
             detObj.velocity = velocityDistance / float(velocityNumFrames);
 
-            out.detections.emplace_back();
-            out.detections.back().reset(new MyDetection(detObj, detPrev, &o, this));
+            mDetections.emplace_back(detObj, detPrev, &o, this);
         }
     }
 
+    void MedianV1::getOutput(Output& out) {
+        out.clear();
+        for (auto& detection : mDetections) { out.detections.push_back(&detection); }
+    }
+
     MedianV1::MyDetection::MyDetection(const Detection::Object& detObj,
                                        const Detection::Predecessor& detPrev,
                                        const MedianV1::Object* obj, MedianV1* aMe)
         : Detection(detObj, detPrev), me(aMe), mObj(obj) {}
 
-    void MedianV1::MyDetection::getPoints(PointSet& out) const {
+    Bounds MedianV1::MyDetection::rasterize() const {
         // adjust rasterized object size
         float rasterSize = object.radius - me->mCfg.outputRasterCorr;
         rasterSize = std::max(rasterSize, me->mCfg.outputRadiusMin);
@@ -119,10 +123,15 @@ namespace fmo {
         cv::Mat buf = temp.wrap();
         buf.setTo(uint8_t(0x00));
         cv::line(buf, p1, p2, 0xFF, thickness);
+        return b;
+    }
+
+    void MedianV1::MyDetection::getPoints(PointSet& out) const {
+        Bounds b = rasterize();
 
         // output non-zero points
         out.clear();
-        const uint8_t* data = temp.data();
+        const uint8_t* data = me->mCache.pointsRaster.data();
         for (int y = b.min.y; y <= b.max.y; y++) {
             for (int x = b.min.x; x <= b.max.x; x++, data++) {
                 if (*data != 0) { out.push_back(Pos{x, y}); }
@@ -131,4 +140,26 @@ namespace fmo {
 
         // no need to sort the points, they are already sorted according to pointSetCompLt()
     }
+
+    void MedianV1::MyDetection::getSpans(SpanSet& out) const {
+        Bounds b = rasterize();
+
+        // output runs of non-zero points
+        out.clear();
+        const uint8_t* data = me->mCache.pointsRaster.data();
+        for (int y = b.min.y; y <= b.max.y; y++) {
+            int xBegin = -1;
+            for (int x = b.min.x; x <= b.max.x; x++, data++) {
+                if (*data != 0) {
+                    if (xBegin == -1) { xBegin = x; }
+                } else if (xBegin != -1) {
+                    out.push_back(Span{y, xBegin, x});
+                    xBegin = -1;
+                }
+            }
+            if (xBegin != -1) { out.push_back(Span{y, xBegin, b.max.x + 1}); }
+        }
+
+        // no need to normalize the spans, they are already sorted and disjoint
+    }
 }
@@ -24,8 +24,8 @@ namespace fmo {
         cv::Mat cvDiff;
         cv::Mat cvVis;
         {
-            mCache.diffScaled.resize(Format::BGR, mSourceLevel.image.dims());
-            mCache.visualized.resize(Format::BGR, mSourceLevel.image.dims());
+            mCache.diffScaled.resize(Format::BGR, mSourceLevel.dims);
+            mCache.visualized.resize(Format::BGR, mSourceLevel.dims);
             cvDiff = mCache.diffScaled.wrap();
             cvVis = mCache.visualized.wrap();
             cv::resize(mCache.diffConverted.wrap(), cvDiff, cvDiff.size(), 0, 0, cv::INTER_NEAREST);
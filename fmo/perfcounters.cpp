@@ -0,0 +1,89 @@
+#include <fmo/perfcounters.hpp>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace fmo {
+    namespace {
+#if defined(__linux__)
+        int openCounter(uint32_t type, uint64_t config) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            // user-space events are accessible with the default perf_event_paranoid setting
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            return int(fd);
+        }
+
+        constexpr uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+            return cache | (op << 8) | (result << 16);
+        }
+#endif
+    }
+
+    PerfCounters::PerfCounters() {
+        mFds.fill(-1);
+#if defined(__linux__)
+        mFds[CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        mFds[INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        mFds[L1D_MISSES] = openCounter(
+            PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                            PERF_COUNT_HW_CACHE_RESULT_MISS));
+        mFds[LLC_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        mFds[BRANCH_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+
+    PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : mFds) {
+            if (fd != -1) close(fd);
+        }
+#endif
+    }
+
+    bool PerfCounters::available() const {
+        for (int fd : mFds) {
+            if (fd != -1) return true;
+        }
+        return false;
+    }
+
+    void PerfCounters::read(Values& out) const {
+        out.fill(0);
+#if defined(__linux__)
+        for (int i = 0; i < NUM_EVENTS; i++) {
+            if (mFds[i] == -1) continue;
+            uint64_t value = 0;
+            if (::read(mFds[i], &value, sizeof(value)) == sizeof(value)) {
+                out[i] = int64_t(value);
+            }
+        }
+#endif
+    }
+
+    const char* PerfCounters::name(Event event) {
+        switch (event) {
+        case CYCLES:
+            return "cycles";
+        case INSTRUCTIONS:
+            return "instructions";
+        case L1D_MISSES:
+            return "L1D misses";
+        case LLC_MISSES:
+            return "LLC misses";
+        case BRANCH_MISSES:
+            return "branch misses";
+        default:
+            return "unknown";
+        }
+    }
+}
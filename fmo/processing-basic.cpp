@@ -12,7 +12,7 @@ namespace fmo {
     void copy(const Mat& src, Mat& dst) {
         dst.resize(src.format(), src.dims());
 
-        if (src.format() == Format::YUV420SP) {
+        if (isSemiPlanar(src.format())) {
             cv::Mat srcMat1 = yuv420SPWrapGray(src);
             cv::Mat srcMat2 = yuv420SPWrapUV(src);
             cv::Mat dstMat1 = yuv420SPWrapGray(dst);
@@ -41,6 +41,12 @@ namespace fmo {
             return;
         }
 
+        if (isPacked422(srcFormat) || srcFormat == Format::P010) {
+            // these formats cannot be reinterpreted, perform a proper conversion
+            convert(src, dst, dstFormat);
+            return;
+        }
+
         dst.resize(dstFormat, dims);
         auto grayCompatible = [](Format f) { return f == Format::GRAY || f == Format::YUV420SP; };
         auto bgrCompatible = [](Format f) { return f == Format::BGR || f == Format::YUV; };
@@ -116,6 +122,29 @@ namespace fmo {
             } else if (dstFormat == Format::GRAY) {
                 code = cv::COLOR_YUV420sp2GRAY;
             }
+        } else if (srcFormat == Format::YUYV) {
+            if (dstFormat == Format::BGR) {
+                code = cv::COLOR_YUV2BGR_YUYV;
+            } else if (dstFormat == Format::GRAY) {
+                code = cv::COLOR_YUV2GRAY_YUYV;
+            }
+        } else if (srcFormat == Format::UYVY) {
+            if (dstFormat == Format::BGR) {
+                code = cv::COLOR_YUV2BGR_UYVY;
+            } else if (dstFormat == Format::GRAY) {
+                code = cv::COLOR_YUV2GRAY_UYVY;
+            }
+        } else if (srcFormat == Format::P010) {
+            // reduce to 8 bits per sample, then convert as NV12
+            cv::Mat nv12;
+            srcMat.convertTo(nv12, CV_8U, 1. / 256.);
+            if (dstFormat == Format::BGR) {
+                cv::cvtColor(nv12, dstMat, cv::COLOR_YUV2BGR_NV12);
+                return;
+            } else if (dstFormat == Format::GRAY) {
+                nv12.rowRange(0, dstMat.rows).copyTo(dstMat);
+                return;
+            }
         }
 
         if (code == ERROR) {
@@ -175,6 +204,10 @@ namespace fmo {
             throw std::runtime_error("downscale: source cannot be YUV420SP");
         }
 
+        if (isPacked422(src.format()) || src.format() == Format::P010) {
+            throw std::runtime_error("downscale: source must be converted, use Subsampler");
+        }
+
         Dims srcDims = src.dims();
         Dims dstDims = {srcDims.width / 2, srcDims.height / 2};
 
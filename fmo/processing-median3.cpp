@@ -1,6 +1,7 @@
 #include "image-util.hpp"
 #include "include-simd.hpp"
 #include <fmo/processing.hpp>
+#include <fmo/trace.hpp>
 
 namespace fmo {
     struct Median3Job : public cv::ParallelLoopBody {
@@ -67,6 +68,7 @@ namespace fmo {
             : mSrc1(src1.data()), mSrc2(src2.data()), mSrc3(src3.data()), mDst(dst.data()) {}
 
         virtual void operator()(const cv::Range& pieces) const override {
+            TraceSpan span{"median3"};
             size_t first = size_t(pieces.start) * sizeof(batch_t);
             size_t last = size_t(pieces.end) * sizeof(batch_t);
             const uint8_t* const src1 = mSrc1 + first;
@@ -87,17 +89,32 @@ namespace fmo {
     void median3(const Image& src1, const Image& src2, const Image& src3, Image& dst) {
         const Format format = src1.format();
         const Dims dims = src1.dims();
-        const cv::Size size = getCvSize(format, dims);
-        const size_t bytes = size_t(size.width) * size_t(size.height) * getPixelStep(format);
-        const size_t pieces = bytes / sizeof(Median3Job::batch_t);
 
         if (format != src2.format() || dims != src2.dims() || format != src3.format() ||
             dims != src3.dims()) {
             throw std::runtime_error("median3: format/dimensions mismatch of inputs");
         }
 
-        // run the job in parallel
         dst.resize(format, dims);
+
+        if (src1.skip() != src2.skip() || src1.skip() != src3.skip() ||
+            src1.skip() != dst.skip()) {
+            // rows are laid out differently, fall back to OpenCV, which respects the row pitch
+            cv::Mat lo, hi;
+            cv::min(src1.wrap(), src2.wrap(), lo);
+            cv::max(src1.wrap(), src2.wrap(), hi);
+            cv::min(hi, src3.wrap(), hi);
+            cv::Mat dstMat = dst.wrap();
+            cv::max(lo, hi, dstMat);
+            return;
+        }
+
+        // all images share the same layout, so they can be treated as flat buffers, including the
+        // row padding; with rows padded to the batch size, there are no leftover bytes
+        const size_t bytes = src1.size();
+        const size_t pieces = bytes / sizeof(Median3Job::batch_t);
+
+        // run the job in parallel
         Median3Job job{src1, src2, src3, dst};
         cv::parallel_for_(cv::Range{0, int(pieces)}, job, cv::getNumThreads());
 
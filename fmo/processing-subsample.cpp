@@ -0,0 +1,175 @@
+#include "image-util.hpp"
+#include <algorithm>
+#include <fmo/processing.hpp>
+#include <fmo/trace.hpp>
+
+namespace fmo {
+    /// Averages 2x2 blocks of pixels and stores the averages as GRAY or YCrCb (which is what
+    /// Format::YUV stands for). BGR sources are converted using the coefficients of cv::cvtColor,
+    /// in fixed point with 14 fractional bits; since the input is a sum of four pixels, two more
+    /// bits are shifted out at the end. YUV sources are decimated without conversion, with chroma
+    /// taken from the samples that cover the 2x2 block.
+    struct SubsampleConvertJob : public cv::ParallelLoopBody {
+        enum : int {
+            SHIFT = 16,
+            HALF = 1 << (SHIFT - 1),
+            B2Y = 1868,  // 0.114
+            G2Y = 9617,  // 0.587
+            R2Y = 4899,  // 0.299
+            R2CR = 11682, // 0.713
+            B2CB = 9241,  // 0.564
+            DELTA = 512,  // 128 for each of the four summed pixels
+        };
+
+        SubsampleConvertJob(const Mat& src, Mat& dst)
+            : mSrc(src.data()),
+              mSrcUv(isSemiPlanar(src.format()) ? src.uvData() : nullptr),
+              mDst(dst.data()),
+              mSrcSkip(src.skip()),
+              mDstSkip(dst.skip()),
+              mWidth(dst.dims().width),
+              mSrcFormat(src.format()),
+              mYuv(dst.format() == Format::YUV) {}
+
+        static uint8_t clamp(int value) { return uint8_t(std::min(std::max(value, 0), 255)); }
+
+        /// Stores a pixel, given its luma and chroma.
+        void store(uint8_t*& dst, int y, int cr, int cb) const {
+            *dst++ = uint8_t(y);
+            if (!mYuv) return;
+            *dst++ = uint8_t(cr);
+            *dst++ = uint8_t(cb);
+        }
+
+        void rowBgr(const uint8_t* src1, const uint8_t* src2, uint8_t* dst) const {
+            for (int col = 0; col < mWidth; col++, src1 += 6, src2 += 6) {
+                int b4 = src1[0] + src1[3] + src2[0] + src2[3];
+                int g4 = src1[1] + src1[4] + src2[1] + src2[4];
+                int r4 = src1[2] + src1[5] + src2[2] + src2[5];
+                int y = b4 * B2Y + g4 * G2Y + r4 * R2Y;
+
+                if (!mYuv) {
+                    *dst++ = uint8_t((y + HALF) >> SHIFT);
+                    continue;
+                }
+
+                // luma scaled by four, with 14 fractional bits rounded off
+                int y4 = (y + (1 << 13)) >> 14;
+                int cr = clamp(((r4 - y4) * R2CR + (DELTA << 14) + HALF) >> SHIFT);
+                int cb = clamp(((b4 - y4) * B2CB + (DELTA << 14) + HALF) >> SHIFT);
+                store(dst, (y + HALF) >> SHIFT, cr, cb);
+            }
+        }
+
+        /// Each four bytes of a 4:2:2 row hold two luma samples and one sample of U and V.
+        template <int Y, int U, int V>
+        void rowPacked422(const uint8_t* src1, const uint8_t* src2, uint8_t* dst) const {
+            for (int col = 0; col < mWidth; col++, src1 += 4, src2 += 4) {
+                int y = (src1[Y] + src1[Y + 2] + src2[Y] + src2[Y + 2] + 2) >> 2;
+                int cr = (src1[V] + src2[V] + 1) >> 1;
+                int cb = (src1[U] + src2[U] + 1) >> 1;
+                store(dst, y, cr, cb);
+            }
+        }
+
+        /// In 4:2:0 formats, there is exactly one pair of chroma samples per output pixel.
+        void rowYuv420Sp(const uint8_t* src1, const uint8_t* src2, const uint8_t* uv,
+                         uint8_t* dst) const {
+            for (int col = 0; col < mWidth; col++, src1 += 2, src2 += 2, uv += 2) {
+                int y = (src1[0] + src1[1] + src2[0] + src2[1] + 2) >> 2;
+                store(dst, y, uv[0], uv[1]);
+            }
+        }
+
+        /// P010 samples are little-endian, with the value in the ten high bits.
+        void rowP010(const uint16_t* src1, const uint16_t* src2, const uint16_t* uv,
+                     uint8_t* dst) const {
+            for (int col = 0; col < mWidth; col++, src1 += 2, src2 += 2, uv += 2) {
+                int y = (src1[0] + src1[1] + src2[0] + src2[1] + (1 << 9)) >> 10;
+                int cr = (uv[1] + (1 << 7)) >> 8;
+                int cb = (uv[0] + (1 << 7)) >> 8;
+                store(dst, std::min(y, 255), std::min(cr, 255), std::min(cb, 255));
+            }
+        }
+
+        virtual void operator()(const cv::Range& rows) const override {
+            TraceSpan span{"subsampleConvert"};
+            for (int row = rows.start; row < rows.end; row++) {
+                const uint8_t* src1 = mSrc + (2 * row) * mSrcSkip;
+                const uint8_t* src2 = src1 + mSrcSkip;
+                const uint8_t* uv = (mSrcUv == nullptr) ? nullptr : mSrcUv + row * mSrcSkip;
+                uint8_t* dst = mDst + row * mDstSkip;
+
+                switch (mSrcFormat) {
+                case Format::BGR:
+                    rowBgr(src1, src2, dst);
+                    break;
+                case Format::YUYV:
+                    rowPacked422<0, 1, 3>(src1, src2, dst);
+                    break;
+                case Format::UYVY:
+                    rowPacked422<1, 0, 2>(src1, src2, dst);
+                    break;
+                case Format::YUV420SP:
+                    rowYuv420Sp(src1, src2, uv, dst);
+                    break;
+                case Format::P010:
+                    rowP010((const uint16_t*)src1, (const uint16_t*)src2, (const uint16_t*)uv,
+                            dst);
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+    private:
+        const uint8_t* const mSrc;
+        const uint8_t* const mSrcUv;
+        uint8_t* const mDst;
+        const size_t mSrcSkip;
+        const size_t mDstSkip;
+        const int mWidth;
+        const Format mSrcFormat;
+        const bool mYuv;
+    };
+
+    namespace {
+        bool canSubsampleConvert(Format from, Format to) {
+            switch (from) {
+            case Format::BGR:
+            case Format::YUYV:
+            case Format::UYVY:
+            case Format::P010:
+                return to == Format::GRAY || to == Format::YUV;
+            case Format::YUV420SP:
+                // conversion to YUV is handled by Subsampler
+                return to == Format::GRAY;
+            default:
+                return false;
+            }
+        }
+    }
+
+    void subsample(const Mat& src, Mat& dst, Format format) {
+        if (format == src.format()) {
+            subsample(src, dst);
+            return;
+        }
+
+        if (!canSubsampleConvert(src.format(), format)) {
+            throw std::runtime_error("subsample: unsupported conversion");
+        }
+
+        Dims srcDims = src.dims();
+        Dims dstDims = {srcDims.width / 2, srcDims.height / 2};
+
+        if (dstDims.width == 0 || dstDims.height == 0) {
+            throw std::runtime_error("subsample: source is too small");
+        }
+
+        dst.resize(format, dstDims);
+        SubsampleConvertJob job{src, dst};
+        cv::parallel_for_(cv::Range{0, dstDims.height}, job, cv::getNumThreads());
+    }
+}
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <fmo/profiler.hpp>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace fmo {
+    Profiler::Stage::Stage(const char* aName)
+        : cName(aName), name(aName), stats(SORT_PERIOD, WARM_UP), quantiles(0, 0, 0) {}
+
+    void Profiler::Stage::add(int64_t startNs, int64_t endNs, bool measure) {
+        if (Trace::enabled()) Trace::record(cName, startNs, endNs);
+        lastNs = endNs - startNs;
+        if (!measure) return;
+        if (numSamples++ >= WARM_UP) overall.add(lastNs);
+        if (!stats.add(lastNs)) return;
+        auto& q = stats.quantiles();
+        quantiles.q50 = float(q.q50 / 1e6);
+        quantiles.q95 = float(q.q95 / 1e6);
+        quantiles.q99 = float(q.q99 / 1e6);
+    }
+
+    void Profiler::Stage::count(const PerfCounters::Values& start,
+                                const PerfCounters::Values& end) {
+        for (size_t i = 0; i < counterSums.size(); i++) { counterSums[i] += end[i] - start[i]; }
+        numCounted++;
+    }
+
+    Profiler::Profiler() : mTotal("total") {}
+
+    bool Profiler::enableCounters(bool enabled) {
+        if (!enabled) {
+            mCounters.reset();
+            return false;
+        }
+        if (!mCounters) { mCounters.reset(new PerfCounters); }
+        if (!mCounters->available()) { mCounters.reset(); }
+        return bool(mCounters);
+    }
+
+    void Profiler::setStages(std::initializer_list<const char*> names) {
+        mStages.clear();
+        for (auto name : names) { mStages.emplace_back(new Stage(name)); }
+        mTotal.stats.reset(0);
+        mTotal.overall.clear();
+        mTotal.numSamples = 0;
+        mTotal.quantiles = {0, 0, 0};
+        mTotal.counterSums.fill(0);
+        mTotal.numCounted = 0;
+        mNextStage = 0;
+    }
+
+    void Profiler::startImpl() {
+        mStartNs = nanoTime();
+        mLastNs = mStartNs;
+        mNextStage = 0;
+        mStartAllocs = heapAllocations();
+        mLastAllocs = mStartAllocs;
+        if (mCounters && mEnabled) {
+            mCounters->read(mStartCounts);
+            mLastCounts = mStartCounts;
+        }
+    }
+
+    void Profiler::lapImpl() {
+        if (mNextStage == numStages()) { throw std::runtime_error("lap(): too many stages"); }
+        int64_t timeNs = nanoTime();
+        Stage& stage = *mStages[mNextStage++];
+        stage.add(mLastNs, timeNs, mEnabled);
+        mLastNs = timeNs;
+        AllocCounts allocs = heapAllocations();
+        stage.lastAllocs = allocs - mLastAllocs;
+        mLastAllocs = allocs;
+
+        if (mCounters && mEnabled) {
+            mCounters->read(mCounts);
+            stage.count(mLastCounts, mCounts);
+            mLastCounts = mCounts;
+        }
+    }
+
+    void Profiler::stopImpl() {
+        if (mNextStage != numStages()) { throw std::runtime_error("stop(): missing stages"); }
+        mTotal.add(mStartNs, nanoTime(), mEnabled);
+        mTotal.lastAllocs = mLastAllocs - mStartAllocs;
+        if (mCounters && mEnabled) { mTotal.count(mStartCounts, mLastCounts); }
+    }
+
+    void Profiler::print(std::ostream& out) const {
+        bool counters = mCounters && mTotal.numCounted > 0;
+
+        auto row = [&out, counters](const Stage& stage) {
+            // the histogram in Stats decays, this one weighs the whole run equally
+            auto& histogram = stage.overall;
+            out << std::setw(24) << std::left << stage.name << std::right << std::fixed;
+            out << std::setw(10) << std::setprecision(2) << (histogram.quantile(0.50) / 1e6);
+            out << std::setw(10) << std::setprecision(2) << (histogram.quantile(0.95) / 1e6);
+            out << std::setw(10) << std::setprecision(2) << (histogram.quantile(0.99) / 1e6);
+
+            if (counters) {
+                auto& sums = stage.counterSums;
+                double n = double(std::max(stage.numCounted, int64_t(1)));
+                double cycles = double(sums[PerfCounters::CYCLES]);
+                double ipc = double(sums[PerfCounters::INSTRUCTIONS]) / std::max(cycles, 1.);
+                out << std::setw(10) << std::setprecision(2) << (cycles / n / 1e6);
+                out << std::setw(10) << std::setprecision(2) << ipc;
+                out << std::setw(10) << std::setprecision(1)
+                    << (double(sums[PerfCounters::LLC_MISSES]) / n / 1e3);
+            }
+            out << '\n';
+        };
+
+        out << std::setw(24) << std::left << "stage [ms]" << std::right;
+        out << std::setw(10) << "q50" << std::setw(10) << "q95" << std::setw(10) << "q99";
+        if (counters) {
+            out << std::setw(10) << "Mcycles" << std::setw(10) << "IPC" << std::setw(10)
+                << "kLLCmiss";
+        }
+        out << '\n';
+        for (auto& stage : mStages) { row(*stage); }
+        row(mTotal);
+    }
+}
@@ -21,21 +21,27 @@ namespace fmo {
 
         Pos newPos{mPos.x + pos.x, mPos.y + pos.y};
 
-        if (mFormat == Format::YUV420SP) {
+        if (isSemiPlanar(mFormat)) {
             if (pos.x % 2 != 0 || pos.y % 2 != 0 || dims.width % 2 != 0 || dims.height % 2 != 0) {
-                throw std::runtime_error("region: YUV420SP regions must be aligned to 2px");
+                throw std::runtime_error("region: 4:2:0 regions must be aligned to 2px");
             }
 
+            size_t colBytes = getRowBytes(mFormat, pos.x);
+
             uint8_t* start = mData;
-            start += static_cast<size_t>(pos.x);
+            start += colBytes;
             start += mRowStep * static_cast<size_t>(pos.y);
 
             uint8_t* uvStart = mUvData;
-            uvStart += static_cast<size_t>(pos.x);
+            uvStart += colBytes;
             uvStart += mRowStep * static_cast<size_t>(pos.y / 2);
 
             return {mFormat, newPos, dims, start, uvStart, mRowStep};
         } else {
+            if (isPacked422(mFormat) && (pos.x % 2 != 0 || dims.width % 2 != 0)) {
+                throw std::runtime_error("region: 4:2:2 regions must be aligned to 2px");
+            }
+
             uint8_t* start = mData;
             start += getPixelStep(mFormat) * static_cast<size_t>(pos.x);
             start += mRowStep * static_cast<size_t>(pos.y);
@@ -51,15 +57,15 @@ namespace fmo {
     }
 
     cv::Mat Region::wrap() {
-        if (mFormat == Format::YUV420SP) {
-            throw std::runtime_error("wrap: cannot wrap YUV420SP regions");
+        if (isSemiPlanar(mFormat)) {
+            throw std::runtime_error("wrap: cannot wrap YUV420SP or P010 regions");
         }
         return {getCvSize(mFormat, mDims), getCvType(mFormat), mData, mRowStep};
     }
 
     cv::Mat Region::wrap() const {
-        if (mFormat == Format::YUV420SP) {
-            throw std::runtime_error("wrap: cannot wrap YUV420SP regions");
+        if (isSemiPlanar(mFormat)) {
+            throw std::runtime_error("wrap: cannot wrap YUV420SP or P010 regions");
         }
         return {getCvSize(mFormat, mDims), getCvType(mFormat), mData, mRowStep};
     }
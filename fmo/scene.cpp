@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <cmath>
+#include <fmo/scene.hpp>
+#include <ostream>
+#include <stdexcept>
+
+namespace fmo {
+    namespace {
+        constexpr float PI = 3.14159265f;
+        constexpr int NOISE_TABLE_BITS = 12;
+
+        /// Advances a xorshift random number generator. Unlike the distributions of the standard
+        /// library, the sequence is the same on every platform.
+        uint32_t random(uint32_t& state) {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+
+        /// Provides a random number in the range [lo, hi).
+        float uniform(uint32_t& state, float lo, float hi) {
+            return lo + (hi - lo) * float(random(state) >> 8) * (1.f / float(1 << 24));
+        }
+
+        uint8_t clamp(float value) {
+            return uint8_t(std::min(std::max(value + 0.5f, 0.f), 255.f));
+        }
+
+        /// Converts a BGR color to YCrCb, using the coefficients of cv::cvtColor.
+        void toYuv(float b, float g, float r, uint8_t& y, uint8_t& cr, uint8_t& cb) {
+            float luma = 0.114f * b + 0.587f * g + 0.299f * r;
+            y = clamp(luma);
+            cr = clamp((r - luma) * 0.713f + 128.f);
+            cb = clamp((b - luma) * 0.564f + 128.f);
+        }
+
+        /// Fills a BGR image with value noise: random values on a square lattice, interpolated
+        /// smoothly in between. Several scales are summed to get detail at various frequencies.
+        void renderTexture(Image& image, float amplitude, uint32_t& state) {
+            const Dims dims = image.dims();
+            const int cells[] = {64, 16};
+            const float weights[] = {0.7f, 0.3f};
+            std::vector<float> sum(size_t(dims.width) * dims.height * 3, 128.f);
+
+            for (int octave = 0; octave < 2; octave++) {
+                int cell = cells[octave];
+                int latticeW = dims.width / cell + 2;
+                int latticeH = dims.height / cell + 2;
+                std::vector<float> lattice(size_t(latticeW) * latticeH * 3);
+                for (auto& value : lattice) {
+                    value = uniform(state, -1.f, 1.f) * amplitude * weights[octave];
+                }
+
+                auto node = [&](int lx, int ly, int c) {
+                    return lattice[(size_t(ly) * latticeW + lx) * 3 + c];
+                };
+
+                for (int y = 0; y < dims.height; y++) {
+                    int ly = y / cell;
+                    float fy = float(y % cell) / cell;
+                    fy = fy * fy * (3 - 2 * fy);
+                    float* row = sum.data() + size_t(y) * dims.width * 3;
+
+                    for (int x = 0; x < dims.width; x++) {
+                        int lx = x / cell;
+                        float fx = float(x % cell) / cell;
+                        fx = fx * fx * (3 - 2 * fx);
+
+                        for (int c = 0; c < 3; c++) {
+                            float top = node(lx, ly, c) * (1 - fx) + node(lx + 1, ly, c) * fx;
+                            float bottom =
+                                node(lx, ly + 1, c) * (1 - fx) + node(lx + 1, ly + 1, c) * fx;
+                            row[x * 3 + c] += top * (1 - fy) + bottom * fy;
+                        }
+                    }
+                }
+            }
+
+            for (int y = 0; y < dims.height; y++) {
+                const float* src = sum.data() + size_t(y) * dims.width * 3;
+                uint8_t* dst = image.data() + y * image.skip();
+                for (int i = 0; i < dims.width * 3; i++) { dst[i] = clamp(src[i]); }
+            }
+        }
+    }
+
+    SceneGenerator::Config::Config()
+        : dims{1280, 720},
+          format(Format::BGR),
+          numObjects(1),
+          minSpeed(30.f),
+          maxSpeed(60.f),
+          minRadius(8.f),
+          maxRadius(16.f),
+          texture(40.f),
+          noise(2.f),
+          exposure(1.f),
+          seed(1) {}
+
+    SceneGenerator::SceneGenerator(const Config& config)
+        : mCfg(config), mState(config.seed * 2654435761u + 1) {
+        if (mState == 0) mState = 1;
+
+        switch (mCfg.format) {
+        case Format::GRAY:
+        case Format::BGR:
+        case Format::YUV:
+            break;
+        case Format::YUYV:
+        case Format::UYVY:
+            if (mCfg.dims.width % 2 != 0) {
+                throw std::runtime_error("SceneGenerator: width must be even");
+            }
+            break;
+        case Format::YUV420SP:
+        case Format::P010:
+            if (mCfg.dims.width % 2 != 0 || mCfg.dims.height % 2 != 0) {
+                throw std::runtime_error("SceneGenerator: dimensions must be even");
+            }
+            break;
+        default:
+            throw std::runtime_error("SceneGenerator: unsupported format");
+        }
+
+        if (mCfg.dims.width <= 0 || mCfg.dims.height <= 0) {
+            throw std::runtime_error("SceneGenerator: bad dimensions");
+        }
+
+        mBackground.resize(Format::BGR, mCfg.dims);
+        renderTexture(mBackground, mCfg.texture, mState);
+
+        // samples of a normal distribution, using the Box-Muller transform
+        mNoiseTable.resize(1 << NOISE_TABLE_BITS);
+        for (auto& sample : mNoiseTable) {
+            float u1 = uniform(mState, 1e-6f, 1.f);
+            float u2 = uniform(mState, 0.f, 1.f);
+            float value = mCfg.noise * std::sqrt(-2 * std::log(u1)) * std::cos(2 * PI * u2);
+            sample = int8_t(std::min(std::max(std::round(value), -127.f), 127.f));
+        }
+
+        mObjects = mCfg.objects;
+        if (mObjects.empty()) {
+            // random discs of contrasting colors, either dark or bright, slightly tinted
+            float w = float(mCfg.dims.width);
+            float h = float(mCfg.dims.height);
+            for (int i = 0; i < mCfg.numObjects; i++) {
+                Object obj;
+                obj.radius = uniform(mState, mCfg.minRadius, mCfg.maxRadius);
+                obj.x = uniform(mState, obj.radius, std::max(obj.radius, w - obj.radius));
+                obj.y = uniform(mState, obj.radius, std::max(obj.radius, h - obj.radius));
+                obj.speed = uniform(mState, mCfg.minSpeed, mCfg.maxSpeed);
+                obj.direction = uniform(mState, 0.f, 2 * PI);
+                float base = (random(mState) & 1) ? 30.f : 220.f;
+                for (auto& c : obj.bgr) { c = clamp(base + uniform(mState, -25.f, 25.f)); }
+                mObjects.push_back(obj);
+            }
+        }
+    }
+
+    void SceneGenerator::next(Image& out, std::vector<SpanSet>& truth) { step(&out, truth); }
+
+    void SceneGenerator::next(std::vector<SpanSet>& truth) { step(nullptr, truth); }
+
+    void SceneGenerator::step(Image* out, std::vector<SpanSet>& truth) {
+        if (out != nullptr) { mFrame = mBackground; }
+
+        truth.resize(mObjects.size());
+        for (size_t i = 0; i < mObjects.size(); i++) {
+            truth[i].clear();
+            renderObject(mObjects[i], truth[i], out != nullptr);
+        }
+
+        if (out != nullptr) {
+            addNoise();
+            encode(*out);
+        }
+
+        // move the objects, bouncing off the edges
+        float w = float(mCfg.dims.width);
+        float h = float(mCfg.dims.height);
+        for (auto& obj : mObjects) {
+            obj.x += obj.speed * std::cos(obj.direction);
+            obj.y += obj.speed * std::sin(obj.direction);
+            if (obj.x < obj.radius || obj.x > w - obj.radius) {
+                float edge = (obj.x < obj.radius) ? obj.radius : w - obj.radius;
+                obj.x = 2 * edge - obj.x;
+                obj.direction = PI - obj.direction;
+            }
+            if (obj.y < obj.radius || obj.y > h - obj.radius) {
+                float edge = (obj.y < obj.radius) ? obj.radius : h - obj.radius;
+                obj.y = 2 * edge - obj.y;
+                obj.direction = -obj.direction;
+            }
+            obj.x = std::min(std::max(obj.x, 0.f), w);
+            obj.y = std::min(std::max(obj.y, 0.f), h);
+        }
+
+        mFrameNum++;
+    }
+
+    void SceneGenerator::renderObject(const Object& obj, SpanSet& truth, bool render) {
+        // during the exposure, the center travels along the segment from a to a + v
+        const float ax = obj.x;
+        const float ay = obj.y;
+        const float vx = obj.speed * mCfg.exposure * std::cos(obj.direction);
+        const float vy = obj.speed * mCfg.exposure * std::sin(obj.direction);
+        const float r = obj.radius;
+        const float vv = vx * vx + vy * vy;
+
+        const Dims dims = mCfg.dims;
+        int x0 = std::max(0, int(std::floor(std::min(ax, ax + vx) - r)));
+        int x1 = std::min(dims.width, int(std::ceil(std::max(ax, ax + vx) + r)));
+        int y0 = std::max(0, int(std::floor(std::min(ay, ay + vy) - r)));
+        int y1 = std::min(dims.height, int(std::ceil(std::max(ay, ay + vy) + r)));
+
+        for (int y = y0; y < y1; y++) {
+            uint8_t* row = mFrame.data() + y * mFrame.skip();
+            float dy = ay - (y + 0.5f);
+            int xBegin = x1;
+            int xEnd = x0;
+
+            for (int x = x0; x < x1; x++) {
+                // the fraction of the exposure during which the disc covers the pixel center,
+                // obtained by solving |a + t v - c| <= r for t in [0, 1]
+                float dx = ax - (x + 0.5f);
+                float c = dx * dx + dy * dy - r * r;
+                float alpha;
+                if (vv < 1e-6f) {
+                    alpha = (c <= 0) ? 1.f : 0.f;
+                } else {
+                    float b = dx * vx + dy * vy;
+                    float disc = b * b - vv * c;
+                    if (disc <= 0) continue;
+                    float sq = std::sqrt(disc);
+                    float t1 = std::max((-b - sq) / vv, 0.f);
+                    float t2 = std::min((-b + sq) / vv, 1.f);
+                    alpha = t2 - t1;
+                }
+                if (alpha <= 0) continue;
+
+                xBegin = std::min(xBegin, x);
+                xEnd = x + 1;
+                if (!render) continue;
+
+                uint8_t* pixel = row + 3 * x;
+                for (int i = 0; i < 3; i++) {
+                    pixel[i] = clamp(pixel[i] + alpha * (float(obj.bgr[i]) - pixel[i]));
+                }
+            }
+
+            if (xBegin < xEnd) { truth.push_back({y, xBegin, xEnd}); }
+        }
+    }
+
+    void SceneGenerator::addNoise() {
+        if (mCfg.noise <= 0) return;
+        const Dims dims = mCfg.dims;
+        const int8_t* table = mNoiseTable.data();
+        uint32_t state = mState;
+
+        for (int y = 0; y < dims.height; y++) {
+            uint8_t* row = mFrame.data() + y * mFrame.skip();
+            for (int i = 0; i < dims.width * 3; i++) {
+                int value = row[i] + table[random(state) >> (32 - NOISE_TABLE_BITS)];
+                row[i] = uint8_t(std::min(std::max(value, 0), 255));
+            }
+        }
+
+        mState = state;
+    }
+
+    void SceneGenerator::encode(Image& out) const {
+        const Dims dims = mCfg.dims;
+        const Format format = mCfg.format;
+        out.resize(format, dims);
+
+        if (format == Format::BGR) {
+            for (int y = 0; y < dims.height; y++) {
+                const uint8_t* src = mFrame.data() + y * mFrame.skip();
+                std::copy(src, src + dims.width * 3, out.data() + y * out.skip());
+            }
+            return;
+        }
+
+        if (format == Format::GRAY || format == Format::YUV) {
+            for (int y = 0; y < dims.height; y++) {
+                const uint8_t* src = mFrame.data() + y * mFrame.skip();
+                uint8_t* dst = out.data() + y * out.skip();
+                for (int x = 0; x < dims.width; x++, src += 3) {
+                    uint8_t luma, cr, cb;
+                    toYuv(src[0], src[1], src[2], luma, cr, cb);
+                    *dst++ = luma;
+                    if (format == Format::GRAY) continue;
+                    *dst++ = cr;
+                    *dst++ = cb;
+                }
+            }
+            return;
+        }
+
+        if (format == Format::YUYV || format == Format::UYVY) {
+            // each four bytes hold two luma samples and the chroma of their average
+            const int Y = (format == Format::YUYV) ? 0 : 1;
+            const int U = (format == Format::YUYV) ? 1 : 0;
+            const int V = (format == Format::YUYV) ? 3 : 2;
+            for (int y = 0; y < dims.height; y++) {
+                const uint8_t* src = mFrame.data() + y * mFrame.skip();
+                uint8_t* dst = out.data() + y * out.skip();
+                for (int x = 0; x < dims.width; x += 2, src += 6, dst += 4) {
+                    uint8_t luma, cr, cb;
+                    toYuv(src[0], src[1], src[2], dst[Y], cr, cb);
+                    toYuv(src[3], src[4], src[5], dst[Y + 2], cr, cb);
+                    toYuv((src[0] + src[3]) * 0.5f, (src[1] + src[4]) * 0.5f,
+                          (src[2] + src[5]) * 0.5f, luma, cr, cb);
+                    dst[U] = cb;
+                    dst[V] = cr;
+                }
+            }
+            return;
+        }
+
+        // semi-planar 4:2:0: full-resolution luma, then chroma of the average of each 2x2 block
+        const bool p010 = format == Format::P010;
+        for (int y = 0; y < dims.height; y += 2) {
+            const uint8_t* src1 = mFrame.data() + y * mFrame.skip();
+            const uint8_t* src2 = src1 + mFrame.skip();
+            uint8_t* dst1 = out.data() + y * out.skip();
+            uint8_t* dst2 = dst1 + out.skip();
+            uint8_t* uv = out.uvData() + (y / 2) * out.skip();
+
+            for (int x = 0; x < dims.width; x += 2, src1 += 6, src2 += 6) {
+                uint8_t luma[4], cr, cb;
+                toYuv(src1[0], src1[1], src1[2], luma[0], cr, cb);
+                toYuv(src1[3], src1[4], src1[5], luma[1], cr, cb);
+                toYuv(src2[0], src2[1], src2[2], luma[2], cr, cb);
+                toYuv(src2[3], src2[4], src2[5], luma[3], cr, cb);
+                float b = (src1[0] + src1[3] + src2[0] + src2[3]) * 0.25f;
+                float g = (src1[1] + src1[4] + src2[1] + src2[4]) * 0.25f;
+                float r = (src1[2] + src1[5] + src2[2] + src2[5]) * 0.25f;
+                uint8_t unused;
+                toYuv(b, g, r, unused, cr, cb);
+
+                if (p010) {
+                    // little-endian samples with the value in the ten high bits
+                    auto store = [](uint8_t* dst, uint8_t value) {
+                        dst[0] = 0;
+                        dst[1] = value;
+                    };
+                    store(dst1 + 2 * x, luma[0]);
+                    store(dst1 + 2 * x + 2, luma[1]);
+                    store(dst2 + 2 * x, luma[2]);
+                    store(dst2 + 2 * x + 2, luma[3]);
+                    store(uv + 2 * x, cb);
+                    store(uv + 2 * x + 2, cr);
+                } else {
+                    dst1[x] = luma[0];
+                    dst1[x + 1] = luma[1];
+                    dst2[x] = luma[2];
+                    dst2[x + 1] = luma[3];
+                    uv[x] = cr;
+                    uv[x + 1] = cb;
+                }
+            }
+        }
+    }
+
+    void writeGroundTruth(std::ostream& out, Dims dims,
+                          const std::vector<std::vector<SpanSet>>& frames) {
+        size_t numObjects = 0;
+        for (auto& frame : frames) { numObjects += frame.size(); }
+        out << dims.width << ' ' << dims.height << ' ' << frames.size() << " 0 " << numObjects
+            << '\n';
+
+        std::vector<int> runs;
+        for (size_t i = 0; i < frames.size(); i++) {
+            for (auto& set : frames[i]) {
+                // spans that touch across the end of a row form a single run
+                runs.clear();
+                int pos = 0;
+                for (auto& span : set) {
+                    int begin = span.y * dims.width + span.xBegin;
+                    if (!runs.empty() && begin == pos) {
+                        runs.back() += span.xEnd - span.xBegin;
+                    } else {
+                        runs.push_back(begin - pos);
+                        runs.push_back(span.xEnd - span.xBegin);
+                    }
+                    pos = span.y * dims.width + span.xEnd;
+                }
+
+                out << (i + 1) << ' ' << runs.size();
+                for (int run : runs) { out << ' ' << run; }
+                out << '\n';
+            }
+        }
+    }
+}
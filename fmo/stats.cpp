@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <fmo/stats.hpp>
+#include <limits>
 
 namespace {
     const int64_t FRAME_STATS_MIN_DELTA = 500000; // 0.5 ms
@@ -11,6 +13,33 @@ namespace {
 
     float toMs(int64_t ns) { return static_cast<float>(ns / 1e6); }
 
+    /// Finds the position of the highest set bit in a non-zero number.
+    int highestBit(uint64_t v) {
+        int result = 0;
+        if (v >> 32) {
+            v >>= 32;
+            result += 32;
+        }
+        if (v >> 16) {
+            v >>= 16;
+            result += 16;
+        }
+        if (v >> 8) {
+            v >>= 8;
+            result += 8;
+        }
+        if (v >> 4) {
+            v >>= 4;
+            result += 4;
+        }
+        if (v >> 2) {
+            v >>= 2;
+            result += 2;
+        }
+        if (v >> 1) { result += 1; }
+        return result;
+    }
+
     using Clock = std::chrono::high_resolution_clock;
 
     struct {
@@ -24,61 +53,144 @@ namespace fmo {
         return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
     }
 
+    Histogram::Histogram() : mCounts(NUM_BUCKETS, 0), mLowIndex(NUM_BUCKETS), mHighIndex(-1) {
+        clear();
+    }
+
+    void Histogram::clear() {
+        if (mHighIndex >= mLowIndex) {
+            std::fill(begin(mCounts) + mLowIndex, begin(mCounts) + mHighIndex + 1, uint64_t(0));
+        }
+        mCount = 0;
+        mSum = 0;
+        mMin = std::numeric_limits<int64_t>::max();
+        mMax = std::numeric_limits<int64_t>::min();
+        mLowIndex = NUM_BUCKETS;
+        mHighIndex = -1;
+    }
+
+    int Histogram::index(int64_t val) {
+        if (val < SUB_COUNT) return int(std::max(val, int64_t(0)));
+        if (val >= MAX_VALUE) return NUM_BUCKETS - 1;
+        // keep SUB_BITS - 1 bits below the highest set bit
+        int shift = highestBit(uint64_t(val)) - (SUB_BITS - 1);
+        return SUB_COUNT + (shift - 1) * HALF_COUNT + int(val >> shift) - HALF_COUNT;
+    }
+
+    int64_t Histogram::lowerBound(int index) {
+        if (index < SUB_COUNT) return index;
+        int shift = (index - SUB_COUNT) / HALF_COUNT + 1;
+        int64_t top = (index - SUB_COUNT) % HALF_COUNT + HALF_COUNT;
+        return top << shift;
+    }
+
+    int64_t Histogram::upperBound(int index) {
+        if (index == NUM_BUCKETS - 1) return std::numeric_limits<int64_t>::max();
+        return lowerBound(index + 1) - 1;
+    }
+
+    void Histogram::add(int64_t val) {
+        int i = index(val);
+        mCounts[i]++;
+        mCount++;
+        mSum += double(val);
+        mMin = std::min(mMin, val);
+        mMax = std::max(mMax, val);
+        mLowIndex = std::min(mLowIndex, i);
+        mHighIndex = std::max(mHighIndex, i);
+    }
+
+    void Histogram::merge(const Histogram& other) {
+        for (int i = other.mLowIndex; i <= other.mHighIndex; i++) {
+            mCounts[i] += other.mCounts[i];
+        }
+        mCount += other.mCount;
+        mSum += other.mSum;
+        mMin = std::min(mMin, other.mMin);
+        mMax = std::max(mMax, other.mMax);
+        mLowIndex = std::min(mLowIndex, other.mLowIndex);
+        mHighIndex = std::max(mHighIndex, other.mHighIndex);
+    }
+
+    void Histogram::decay() {
+        uint64_t count = 0;
+        int lowIndex = NUM_BUCKETS;
+        int highIndex = -1;
+
+        uint64_t carry = 0;
+
+        // odd counts are rounded up and down alternately, so that sparse buckets do not vanish
+        for (int i = mLowIndex; i <= mHighIndex; i++) {
+            uint64_t sum = mCounts[i] + carry;
+            mCounts[i] = sum / 2;
+            carry = sum % 2;
+            if (mCounts[i] == 0) continue;
+            count += mCounts[i];
+            lowIndex = std::min(lowIndex, i);
+            highIndex = i;
+        }
+
+        if (count == 0) {
+            clear();
+            return;
+        }
+
+        mSum *= double(count) / double(mCount);
+        mCount = count;
+        if (lowIndex > 0) { mMin = std::max(mMin, lowerBound(lowIndex)); }
+        mMax = std::min(mMax, upperBound(highIndex));
+        mLowIndex = lowIndex;
+        mHighIndex = highIndex;
+    }
+
+    int64_t Histogram::quantile(double q) const {
+        if (mCount == 0) return 0;
+        q = std::min(std::max(q, 0.), 1.);
+        uint64_t rank = std::min(uint64_t(q * double(mCount)), mCount - 1);
+        uint64_t seen = 0;
+
+        for (int i = mLowIndex; i <= mHighIndex; i++) {
+            seen += mCounts[i];
+            if (seen <= rank) continue;
+            // report the middle of the bucket
+            int64_t lower = lowerBound(i);
+            int64_t val = lower + (lowerBound(i + 1) - lower) / 2;
+            if (i == NUM_BUCKETS - 1) val = mMax;
+            return std::min(std::max(val, mMin), mMax);
+        }
+
+        return mMax;
+    }
+
     Stats::Stats(int sortPeriod, int warmUp)
-        : mStorageSize(2 * sortPeriod),
-          mSortPeriod(sortPeriod),
+        : mSortPeriod(sortPeriod),
           mWarmUpFrames(warmUp),
-          mVec(),
           mWarmUpCounter(0),
-          mQuantiles(0, 0, 0) {
-        mVec.reserve(size_t(mStorageSize));
-    }
+          mSinceUpdate(0),
+          mHistogram(),
+          mQuantiles(0, 0, 0) {}
 
     void Stats::reset(int64_t defVal) {
-        mVec.clear();
+        mHistogram.clear();
         mWarmUpCounter = 0;
+        mSinceUpdate = 0;
         mQuantiles.q50 = mQuantiles.q95 = mQuantiles.q99 = defVal;
     }
 
     bool Stats::add(int64_t val) {
         if (mWarmUpCounter++ < mWarmUpFrames) return false;
-        mVec.push_back(val);
-        if (mVec.size() % mSortPeriod != 0) return false;
-
-        auto iter50 = begin(mVec) + ((50 * mVec.size()) / 100);
-        auto iter95 = begin(mVec) + ((95 * mVec.size()) / 100);
-        auto iter99 = begin(mVec) + ((99 * mVec.size()) / 100);
-
-        std::nth_element(begin(mVec), iter50, end(mVec));
-        if (iter50 != iter95) std::nth_element(iter50 + 1, iter95, end(mVec));
-        if (iter95 != iter99) std::nth_element(iter95 + 1, iter99, end(mVec));
+        mHistogram.add(val);
+        if (++mSinceUpdate < mSortPeriod) return false;
+        mSinceUpdate = 0;
 
-        mQuantiles.q50 = *iter50;
-        mQuantiles.q95 = *iter95;
-        mQuantiles.q99 = *iter99;
+        mQuantiles.q50 = mHistogram.quantile(0.50);
+        mQuantiles.q95 = mHistogram.quantile(0.95);
+        mQuantiles.q99 = mHistogram.quantile(0.99);
 
-        if (mVec.size() >= size_t(mStorageSize)) subsample();
+        if (mHistogram.count() >= uint64_t(2 * mSortPeriod)) mHistogram.decay();
         return true;
     }
 
-    void Stats::subsample() {
-        auto halfSize = mVec.size() / 2;
-        auto iter1 = begin(mVec);
-        auto iter2 = iter1 + halfSize;
-        auto iterEnd = end(mVec);
-
-        while (iter2 != iterEnd) {
-            iter1++;
-            iter2++;
-            if (iter2 == iterEnd) break;
-            *iter1 = *iter2;
-            iter1++;
-            iter2++;
-        }
-
-        mVec.resize(halfSize);
-    }
-
     FrameStats::FrameStats(int sortPeriod, int warmUp)
         : mStats(sortPeriod, warmUp), mLastTimeNs(0), mQuantilesHz(0, 0, 0) {}
 
@@ -128,4 +240,42 @@ namespace fmo {
         mQuantilesMs.q95 = toMs(quantiles.q95);
         mQuantilesMs.q99 = toMs(quantiles.q99);
     }
+
+    double mannWhitneyP(const std::vector<int64_t>& a, const std::vector<int64_t>& b) {
+        if (a.empty() || b.empty()) return 1.;
+
+        // pool the samples, remembering which set each one comes from
+        std::vector<std::pair<int64_t, bool>> pooled;
+        pooled.reserve(a.size() + b.size());
+        for (auto val : a) { pooled.emplace_back(val, true); }
+        for (auto val : b) { pooled.emplace_back(val, false); }
+        std::sort(begin(pooled), end(pooled));
+
+        // sum the ranks of "a", giving tied samples the average of their ranks
+        double n = double(pooled.size());
+        double rankSumA = 0;
+        double tieSum = 0;
+        for (size_t i = 0; i < pooled.size();) {
+            size_t j = i;
+            while (j < pooled.size() && pooled[j].first == pooled[i].first) { j++; }
+            double ties = double(j - i);
+            double rank = (double(i + 1) + double(j)) / 2;
+            for (size_t k = i; k < j; k++) {
+                if (pooled[k].second) rankSumA += rank;
+            }
+            tieSum += ties * ties * ties - ties;
+            i = j;
+        }
+
+        double nA = double(a.size());
+        double nB = double(b.size());
+        double u = rankSumA - nA * (nA + 1) / 2;
+        double mean = nA * nB / 2;
+        double var = nA * nB / 12 * ((n + 1) - tieSum / (n * (n - 1)));
+        if (var <= 0) return 1.;
+
+        // continuity correction
+        double z = std::max(std::abs(u - mean) - 0.5, 0.) / std::sqrt(var);
+        return std::erfc(z / std::sqrt(2.));
+    }
 }
@@ -1,9 +1,11 @@
 #include "include-opencv.hpp"
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <fmo/assert.hpp>
 #include <fmo/common.hpp>
 #include <fmo/strip.hpp>
+#include <fmo/trace.hpp>
 #include <mutex>
 #include <vector>
 
@@ -41,17 +43,18 @@ namespace fmo {
         }
 
         virtual void operator()(const cv::Range& r) const override {
+            TraceSpan span{"stripGen"};
             const int threadNum = r.start;
             rle_t* const rle = mRle->data() + (mRleSz * threadNum);
             Strip* const temp = mTemp->data() + (mTempSz * threadNum);
             const int16_t step = int16_t(mStep);
             const int16_t halfStep = int16_t(mStep / 2);
             const int pad = std::max(0, std::max(mMinHeight, mMinGap));
-            const int numBatches = mDims.width / WIDTH;
+            const int numBatches = (mDims.width + WIDTH - 1) / WIDTH;
             const int batchFirst = (threadNum * numBatches) / mNumThreads;
             const int batchLast = ((threadNum + 1) * numBatches) / mNumThreads;
             const int colFirst = batchFirst * WIDTH;
-            const int colLast = batchLast * WIDTH;
+            const int colLast = std::min(batchLast * WIDTH, mDims.width);
             const int skip = mSkip;
             const int minHeight = mMinHeight;
             const Dims dims = mDims;
@@ -70,7 +73,16 @@ namespace fmo {
                 rle_t* back[WIDTH];
                 int n[WIDTH];
 
-                for (int w = 0; w < WIDTH; w++) {
+                // the last batch may reach into row padding, which must be ignored
+                const int valid = std::min(int(WIDTH), dims.width - col);
+                batch_t mask = ~batch_t(0);
+                if (valid != WIDTH) {
+                    uint8_t maskBytes[WIDTH] = {};
+                    std::fill(maskBytes, maskBytes + valid, uint8_t(0xFF));
+                    std::memcpy(&mask, maskBytes, sizeof(mask));
+                }
+
+                for (int w = 0; w < valid; w++) {
                     back[w] = front[w];
 
                     // add top of image
@@ -79,8 +91,8 @@ namespace fmo {
                 }
 
                 // must start with a black segment
-                if (*data != 0) {
-                    for (int w = 0; w < WIDTH; w++) {
+                if ((*data & mask) != 0) {
+                    for (int w = 0; w < valid; w++) {
                         if (((const uint8_t*)(data))[w] != 0) {
                             *++(back[w]) = rle_t(0);
                             n[w]++;
@@ -92,8 +104,8 @@ namespace fmo {
                 // store indices of changes
                 for (int row = 1; row < dims.height; row++, data += skip) {
                     const batch_t* prev = data - skip;
-                    if (*data != *prev) {
-                        for (int w = 0; w < WIDTH; w++) {
+                    if (((*data ^ *prev) & mask) != 0) {
+                        for (int w = 0; w < valid; w++) {
                             if (((const uint8_t*)(data))[w] != ((const uint8_t*)(prev))[w]) {
                                 if ((row - *(back[w])) < minHeight) {
                                     // remove noise
@@ -109,7 +121,7 @@ namespace fmo {
                     }
                 }
 
-                for (int w = 0; w < WIDTH; w++, origX += int16_t(step)) {
+                for (int w = 0; w < valid; w++, origX += int16_t(step)) {
                     // must end with a black segment
                     if ((n[w] & 1) == 0) {
                         *++(back[w]) = rle_t(dims.height);
@@ -1,9 +1,17 @@
 #include "image-util.hpp"
-#include <fmo/subsampler.hpp>
+#include <algorithm>
 #include <fmo/processing.hpp>
+#include <fmo/region.hpp>
+#include <fmo/subsampler.hpp>
 
 namespace fmo {
     void Subsampler::operator()(const Mat& src, Mat& dst) {
+        if (isPacked422(src.format()) || src.format() == Format::P010) {
+            // decimate directly into YUV, without a conversion at full resolution
+            subsample(src, dst, Format::YUV);
+            return;
+        }
+
         if (src.format() != Format::YUV420SP) {
             subsample(src, dst);
             return;
@@ -15,23 +23,105 @@ namespace fmo {
         cv::Size cvSrcSize{srcDims.width, srcDims.height};
         cv::Size cvDstSize{dstDims.width, dstDims.height};
         dst.resize(Format::YUV, dstDims);
-        y.resize(Format::GRAY, dstDims);
-        u.resize(Format::GRAY, dstDims);
-        v.resize(Format::GRAY, dstDims);
+        prepare(y, dstDims);
+        prepare(u, dstDims);
+        prepare(v, dstDims);
         cv::Mat cvDst[3] = {y.wrap(), u.wrap(), v.wrap()};
 
         // create Y channel by decimation
-        cv::Mat cvSrcY{cvSrcSize, CV_8UC1, const_cast<uint8_t*>(src.data())};
+        cv::Mat cvSrcY{cvSrcSize, CV_8UC1, const_cast<uint8_t*>(src.data()), src.skip()};
         cv::resize(cvSrcY, cvDst[0], cvDstSize, 0, 0, cv::INTER_AREA);
 
         // create channels U, V by splitting
-        cv::Mat cvSrcUV{cvDstSize, CV_8UC2, const_cast<uint8_t*>(src.uvData())};
+        cv::Mat cvSrcUV{cvDstSize, CV_8UC2, const_cast<uint8_t*>(src.uvData()), src.skip()};
         cv::split(cvSrcUV, cvDst + 1);
 
         // create the result by merging
         cv::merge(cvDst, 3, dst.wrap());
     }
 
+    void Subsampler::operator()(const Mat& src, Mat& dst, Format format) {
+        if (format == Format::UNKNOWN || format == nextFormat(src.format())) {
+            (*this)(src, dst);
+            return;
+        }
+
+        subsample(src, dst, format);
+    }
+
+    namespace {
+        /// Provides a view of a range of rows of the image.
+        Region rowRange(const Mat& mat, int row, int numRows) {
+            auto* data = const_cast<uint8_t*>(mat.data()) + size_t(row) * mat.skip();
+            uint8_t* uvData = nullptr;
+            if (isSemiPlanar(mat.format())) {
+                uvData = const_cast<uint8_t*>(mat.uvData()) + size_t(row / 2) * mat.skip();
+            }
+            Dims dims{mat.dims().width, numRows};
+            return {mat.format(), {0, row}, dims, data, uvData, mat.skip()};
+        }
+    }
+
+    void Subsampler::decimate(const Mat& src, Image& dst, int levels, Format format,
+                              int bandRows) {
+        if (levels < 1 || bandRows < 1) {
+            throw std::runtime_error("decimate: bad arguments");
+        }
+
+        // find the format and dimensions of the output
+        Format dstFormat = nextFormat(src.format(), format);
+        Dims dstDims = nextDims(src.dims());
+        for (int i = 1; i < levels; i++) {
+            dstFormat = nextFormat(dstFormat);
+            dstDims = nextDims(dstDims);
+        }
+
+        if (dstDims.width == 0 || dstDims.height == 0) {
+            throw std::runtime_error("decimate: source is too small");
+        }
+
+        if (mPool != nullptr) {
+            mPool->acquire(dst, dstFormat, dstDims);
+        } else {
+            dst.resize(dstFormat, dstDims);
+        }
+
+        // each output row is computed from a fixed number of source rows, so processing bands
+        // separately yields the same result as processing whole images
+        if (int(mBands.size()) < levels - 1) { mBands.resize(levels - 1); }
+        const int scale = 1 << levels;
+
+        for (int row = 0; row < dstDims.height; row += bandRows) {
+            int numRows = std::min(bandRows, dstDims.height - row);
+            Region srcBand = rowRange(src, row * scale, numRows * scale);
+            Region dstBand = rowRange(dst, row, numRows);
+            const Mat* input = &srcBand;
+            Format bandFormat = format;
+
+            for (int i = 0; i < levels - 1; i++) {
+                (*this)(*input, mBands[i], bandFormat);
+                input = &mBands[i];
+                bandFormat = Format::UNKNOWN;
+            }
+
+            (*this)(*input, dstBand, bandFormat);
+        }
+    }
+
+    size_t Subsampler::memoryUsage() const {
+        size_t result = y.capacity() + u.capacity() + v.capacity();
+        for (auto& band : mBands) { result += band.capacity(); }
+        return result;
+    }
+
+    void Subsampler::prepare(Image& image, Dims dims) {
+        if (mPool != nullptr) {
+            mPool->acquire(image, Format::GRAY, dims);
+        } else {
+            image.resize(Format::GRAY, dims);
+        }
+    }
+
     Dims Subsampler::nextDims(Dims dims) {
         dims.width /= 2;
         dims.height /= 2;
@@ -39,7 +129,14 @@ namespace fmo {
     }
 
     Format Subsampler::nextFormat(Format before) {
-        if (before == Format::YUV420SP) return Format::YUV;
-        return before;
+        switch (before) {
+        case Format::YUV420SP:
+        case Format::YUYV:
+        case Format::UYVY:
+        case Format::P010:
+            return Format::YUV;
+        default:
+            return before;
+        }
     }
 }
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <fmo/trace.hpp>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace fmo {
+    namespace {
+        struct Event {
+            const char* name;
+            int64_t startNs;
+            int64_t endNs;
+        };
+
+        /// Written by a single thread; the number of written events is published with release
+        /// semantics so that the events can be read by another thread.
+        struct ThreadBuffer {
+            ThreadBuffer(int aTid) : events(Trace::CAPACITY), tid(aTid) {}
+
+            std::vector<Event> events;
+            std::atomic<uint64_t> numWritten{0};
+            const int tid;
+        };
+
+        struct {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        } global;
+
+        thread_local ThreadBuffer* threadBuffer = nullptr;
+
+        ThreadBuffer* registerThread() {
+            std::lock_guard<std::mutex> lock(global.mutex);
+            int tid = int(global.buffers.size()) + 1;
+            global.buffers.emplace_back(new ThreadBuffer(tid));
+            return global.buffers.back().get();
+        }
+
+        void writeString(std::ostream& out, const char* str) {
+            out << '"';
+            for (; *str != '\0'; str++) {
+                if (*str == '"' || *str == '\\') out << '\\';
+                out << *str;
+            }
+            out << '"';
+        }
+    }
+
+    constexpr size_t Trace::CAPACITY;
+    std::atomic<bool> Trace::sEnabled{false};
+
+    void Trace::enable(bool enabled) { sEnabled.store(enabled, std::memory_order_relaxed); }
+
+    void Trace::record(const char* name, int64_t startNs, int64_t endNs) {
+        ThreadBuffer* buffer = threadBuffer;
+        if (buffer == nullptr) { buffer = threadBuffer = registerThread(); }
+        uint64_t n = buffer->numWritten.load(std::memory_order_relaxed);
+        buffer->events[n % CAPACITY] = {name, startNs, endNs};
+        buffer->numWritten.store(n + 1, std::memory_order_release);
+    }
+
+    size_t Trace::numEvents() {
+        std::lock_guard<std::mutex> lock(global.mutex);
+        size_t result = 0;
+        for (auto& buffer : global.buffers) {
+            uint64_t n = buffer->numWritten.load(std::memory_order_acquire);
+            result += size_t(std::min(n, uint64_t(CAPACITY)));
+        }
+        return result;
+    }
+
+    void Trace::clear() {
+        std::lock_guard<std::mutex> lock(global.mutex);
+        for (auto& buffer : global.buffers) { buffer->numWritten.store(0); }
+    }
+
+    void Trace::writeJson(std::ostream& out) {
+        std::lock_guard<std::mutex> lock(global.mutex);
+        const char* separator = "\n";
+        out << "{\"traceEvents\":[";
+        out << std::fixed << std::setprecision(3);
+
+        for (auto& buffer : global.buffers) {
+            uint64_t end = buffer->numWritten.load(std::memory_order_acquire);
+            uint64_t begin = end - std::min(end, uint64_t(CAPACITY));
+
+            for (uint64_t i = begin; i < end; i++) {
+                auto& event = buffer->events[i % CAPACITY];
+                out << separator << "{\"name\":";
+                writeString(out, event.name);
+                out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid;
+                out << ",\"ts\":" << (double(event.startNs) / 1e3);
+                out << ",\"dur\":" << (double(event.endNs - event.startNs) / 1e3) << '}';
+                separator = ",\n";
+            }
+        }
+
+        out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+}
@@ -2,8 +2,12 @@
 #define FMO_ALGORITHM_HPP
 
 #include <fmo/differentiator.hpp>
+#include <fmo/flightrecorder.hpp>
+#include <fmo/governor.hpp>
+#include <fmo/imagepool.hpp>
 #include <fmo/image.hpp>
 #include <fmo/pointset.hpp>
+#include <fmo/profiler.hpp>
 #include <functional>
 #include <memory>
 #include <string>
@@ -44,6 +48,30 @@ namespace fmo {
             /// Maximum image height for processing. The input image will be downscaled by a factor
             /// of 2 until its height is less or equal to the specified value.
             int maxImageHeight;
+            /// Color format of the decimated images that are processed. Format::UNKNOWN means that
+            /// the input format is kept. When the input is BGR, GRAY or YUV may be requested; the
+            /// conversion is then fused with the first decimation, so that only the pixels of the
+            /// smaller image are converted. Used only in "median-v1" and "explorer" algorithms.
+            Format processingFormat;
+            /// When set, neither the source-resolution input nor the intermediate decimation levels
+            /// are retained. The input is streamed through the intermediate levels in bands and
+            /// only the processing level is kept, so setInputSwap() does not swap and debug images
+            /// lack the source image. Used only in "median-v1" and "explorer-v3".
+            bool leanMemory;
+            /// When non-zero, the algorithm monitors its frame time and adds or removes decimation
+            /// levels to keep the 95% quantile of frame time below this value, in milliseconds.
+            /// Used only in "median-v1" and "explorer-v3".
+            float latencyBudget;
+            /// A coarser processing level is abandoned only if the 95% quantile of frame time is
+            /// below latencyBudget multiplied by this value.
+            float latencyHysteresis;
+            /// When non-zero, the algorithm keeps its processing-level inputs and stage durations
+            /// of the last few frames and writes them to flightRecorderDir whenever a frame takes
+            /// longer than this value, in milliseconds. See FlightRecorder. Used only in
+            /// "median-v1" and "explorer-v3".
+            float flightRecorderThreshold;
+            /// Directory to write the frames captured by the flight recorder to.
+            std::string flightRecorderDir;
             /// Strips that have less than this number of pixels in the downscaled image will be
             /// ignored.
             int minStripHeight;
@@ -150,7 +178,9 @@ namespace fmo {
 
         /// A structure that contains all relevant information about a detected object. The user of
         /// the algorithm receives subclasses of this structure using the getOutput() method.
-        /// Instances of this class are invalidated by the next call to setInputSwap().
+        /// Instances of this class are owned by the algorithm, which keeps them in storage that is
+        /// reused from frame to frame. They are invalidated by the next call to setInputSwap() or
+        /// setInputView().
         struct Detection {
             virtual ~Detection() = default;
 
@@ -186,17 +216,22 @@ namespace fmo {
             /// Generates coordinates of object pixels and sorts them according to pointSetCompLt().
             virtual void getPoints(PointSet& out) const = 0;
 
+            /// Generates horizontal runs of object pixels, meeting the invariants of SpanSet. The
+            /// default implementation converts the result of getPoints().
+            virtual void getSpans(SpanSet& out) const;
+
             const Object object;           ///< info about the detected object
             const Predecessor predecessor; ///< info about the matched object in the previous frame
         };
 
         /// Type of result produced by an algorithm instance every frame, reporting the detected
-        /// objects.
+        /// objects. The output does not own the detections, so that it can be filled repeatedly
+        /// without allocating memory once its capacity is sufficient.
         struct Output {
-            /// Information about the detected objects.
-            std::vector<std::unique_ptr<Detection>> detections;
+            /// Information about the detected objects. Points into storage owned by the algorithm.
+            std::vector<const Detection*> detections;
 
-            /// Resets all data.
+            /// Resets all data. Retains capacity.
             void clear() { detections.clear(); }
         };
 
@@ -218,9 +253,23 @@ namespace fmo {
         /// the contents of the provided input image with an internal buffer.
         virtual void setInputSwap(Image& input) = 0;
 
+        /// To be called every frame instead of setInputSwap(), providing the next image as a
+        /// read-only view, e.g. a Region with any row stride. The format and dimensions are
+        /// checked like in setInputSwap(). The view need not remain valid after the call.
+        /// Implementations decimate directly from the view and keep a copy of the input only if
+        /// getDebugImage() needs it and setKeepInput() is enabled. The default implementation
+        /// copies the input and calls setInputSwap().
+        virtual void setInputView(const Mat& input);
+
+        /// Selects whether setInputView() keeps a copy of the source-resolution input for
+        /// algorithms that draw it in getDebugImage(). When disabled, such debug images have a
+        /// black background. Disabled by default.
+        void setKeepInput(bool keep) { mKeepInput = keep; }
+
         /// To be called every frame, obtaining a list of fast-moving objects that have been
         /// detected this frame. The returned objects (i.e. instances of class Detection) may be
-        /// used only before the next call to setInputSwap().
+        /// used only before the next call to setInputSwap(). May be called repeatedly in a single
+        /// frame; performs no heap allocations unless the output needs to grow.
         virtual void getOutput(Output& output) { output.clear(); }
 
         /// Provide the offset of the frame number in which the detected objects are being reported
@@ -231,6 +280,58 @@ namespace fmo {
         /// algorithm behavior. The returned image will have BGR format and the same dimensions as
         /// the input image.
         virtual const Image& getDebugImage() = 0;
+
+        /// Enables or disables the measurement of the duration of each processing stage during
+        /// setInputSwap(). Disabled by default.
+        void setProfiling(bool enabled) { mProfiler.enable(enabled); }
+
+        /// Enables or disables reading hardware performance counters during each processing stage
+        /// while profiling is enabled. See Profiler::enableCounters().
+        ///
+        /// @return True if at least one counter is available.
+        bool setProfilingCounters(bool enabled) { return mProfiler.enableCounters(enabled); }
+
+        /// Provides the durations of processing stages measured so far. Measurements are only
+        /// taken while enabled using setProfiling().
+        const Profiler& getProfiler() const { return mProfiler; }
+
+        /// Provides information about the processing level changes caused by the latency budget.
+        /// See Config::latencyBudget.
+        const LatencyGovernor& getGovernor() const { return mGovernor; }
+
+        /// Replaces the clock that the latency governor measures frame times with. See
+        /// LatencyGovernor::setClock().
+        void setGovernorClock(LatencyGovernor::now_t now) { mGovernor.setClock(now); }
+
+        /// Provides information about the frames dumped because they exceeded
+        /// Config::flightRecorderThreshold.
+        const FlightRecorder& getFlightRecorder() const { return mFlightRecorder; }
+
+        /// Provides the flight recorder, e.g. to wait for the dumps using FlightRecorder::flush().
+        FlightRecorder& getFlightRecorder() { return mFlightRecorder; }
+
+        /// Provides the pool that implementations draw their image buffers from, e.g. to check
+        /// that no allocations take place after a warm-up.
+        const ImagePool& getImagePool() const { return mImagePool; }
+
+        /// Provides the number of bytes held in image buffers by this instance, including the
+        /// buffers kept in the image pool. Other allocations are small in comparison and are not
+        /// included. See Config::leanMemory.
+        virtual size_t getMemoryUsage() const;
+
+    protected:
+        /// Row alignment of the images processed by the kernels, so that every row starts at an
+        /// address suitable for aligned vector loads. See Image::setRowAlign().
+        static constexpr size_t ROW_ALIGN = 32;
+
+        Profiler mProfiler;             ///< to be set up and updated by each implementation
+        LatencyGovernor mGovernor;      ///< to be configured and updated by implementations
+        FlightRecorder mFlightRecorder; ///< to be configured and updated by implementations
+        ImagePool mImagePool;           ///< source of image buffers for implementations
+        bool mKeepInput = false;        ///< see setKeepInput()
+
+    private:
+        Image mInputCopy; ///< used by the default implementation of setInputView()
     };
 }
 
@@ -1,15 +1,102 @@
 #ifndef FMO_ALLOCATOR_HPP
 #define FMO_ALLOCATOR_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <memory>
+#include <new>
 #include <type_traits>
 
 namespace fmo {
+    /// Determines where large blocks allocated by aligned allocators, i.e. image data, come from.
+    enum class AllocPolicy {
+        MALLOC,     ///< the heap, aligned manually
+        PAGES,      ///< page-aligned memory mapped directly from the OS
+        HUGE_PAGES, ///< like PAGES, backed by 2 MB huge pages where the OS permits it
+    };
+
+    /// Selects the policy used by all subsequent large allocations, unless overridden, e.g. by
+    /// ImagePool::setAllocPolicy(). Blocks smaller than detail::PAGE_ALLOC_MIN_BYTES always come
+    /// from the heap. When mapping memory fails, the heap is used as a fallback.
+    void setAllocPolicy(AllocPolicy policy);
+
+    /// Provides the policy selected using setAllocPolicy(). The default is AllocPolicy::MALLOC.
+    AllocPolicy getAllocPolicy();
+
     namespace detail {
         inline constexpr bool is_pow2(size_t x) { return x && (x & (x - 1)) == 0; }
 
+        enum : size_t {
+            PAGE_ALLOC_MIN_BYTES = 1 << 19, ///< smaller blocks are never mapped from the OS
+        };
+
+        /// Counts the allocations performed by aligned allocators.
+        inline std::atomic<int64_t>& alignedAllocations() {
+            static std::atomic<int64_t> counter{0};
+            return counter;
+        }
+
+        /// Counts the bytes requested from aligned allocators.
+        inline std::atomic<int64_t>& alignedAllocatedBytes() {
+            static std::atomic<int64_t> counter{0};
+            return counter;
+        }
+
+        /// Records an allocation performed by an aligned allocator.
+        inline void countAligned(size_t bytes) {
+            alignedAllocations().fetch_add(1, std::memory_order_relaxed);
+            alignedAllocatedBytes().fetch_add(int64_t(bytes), std::memory_order_relaxed);
+        }
+
+        /// Counts the allocations that have been mapped directly from the OS.
+        inline std::atomic<int64_t>& mappedAllocations() {
+            static std::atomic<int64_t> counter{0};
+            return counter;
+        }
+
+        /// Counts the heap allocations made through operator new, see FMO_COUNT_ALLOCATIONS.
+        inline std::atomic<int64_t>& heapAllocations() {
+            static std::atomic<int64_t> counter{0};
+            return counter;
+        }
+
+        /// Counts the bytes requested from operator new, see FMO_COUNT_ALLOCATIONS.
+        inline std::atomic<int64_t>& heapAllocatedBytes() {
+            static std::atomic<int64_t> counter{0};
+            return counter;
+        }
+
+        /// Allocates a block from the heap on behalf of a counting operator new.
+        inline void* countedNew(size_t bytes) {
+            heapAllocations().fetch_add(1, std::memory_order_relaxed);
+            heapAllocatedBytes().fetch_add(int64_t(bytes), std::memory_order_relaxed);
+            void* result = std::malloc(bytes == 0 ? 1 : bytes);
+            if (result == nullptr) { throw std::bad_alloc{}; }
+            return result;
+        }
+
+        /// Provides the policy in effect in the calling thread.
+        AllocPolicy currentAllocPolicy();
+
+        /// Overrides the allocation policy in the calling thread for the lifetime of the object.
+        struct ScopedAllocPolicy {
+            explicit ScopedAllocPolicy(AllocPolicy policy);
+            ~ScopedAllocPolicy();
+            ScopedAllocPolicy(const ScopedAllocPolicy&) = delete;
+            ScopedAllocPolicy& operator=(const ScopedAllocPolicy&) = delete;
+
+        private:
+            int mPrevious;
+        };
+
+        /// Maps a page-aligned block from the OS according to the policy. The byte preceding the
+        /// block is set to zero to distinguish it from heap blocks. Returns null on failure.
+        void* pageMalloc(size_t bytes, AllocPolicy policy);
+
+        /// Unmaps a block obtained from pageMalloc().
+        void pageFree(void* ptr);
+
         template <typename T, size_t Align>
         struct aligned_allocator;
         template <typename T, size_t Align = alignof(T), bool Switch = (Align > alignof(double))>
@@ -17,7 +104,10 @@ namespace fmo {
 
         template <typename T, size_t Align>
         struct alloc<T, Align, false> {
-            static T* malloc(size_t bytes) { return (T*)std::malloc(bytes); }
+            static T* malloc(size_t bytes) {
+                countAligned(bytes);
+                return (T*)std::malloc(bytes);
+            }
             static void free(T* ptr) { std::free(ptr); }
             using allocator = std::allocator<T>;
             using deleter = std::default_delete<T>;
@@ -30,6 +120,16 @@ namespace fmo {
             static_assert(Align > alignof(double), "alignment is too small -- use malloc");
 
             static T* malloc(size_t bytes) {
+                countAligned(bytes);
+                if (bytes >= PAGE_ALLOC_MIN_BYTES) {
+                    AllocPolicy policy = currentAllocPolicy();
+                    if (policy != AllocPolicy::MALLOC) {
+                        void* ptr = pageMalloc(bytes, policy);
+                        if (ptr != nullptr) return (T*)ptr;
+                    }
+                }
+
+                // the offset stored before the block is always negative, zero marks mapped blocks
                 auto orig = (uintptr_t)std::malloc(bytes + Align);
                 if (orig == 0) return nullptr;
                 auto aligned = (orig + Align) & ~(Align - 1);
@@ -41,6 +141,10 @@ namespace fmo {
             static void free(T* aligned) {
                 if (aligned == nullptr) return;
                 auto offset = ((int8_t*)aligned)[-1];
+                if (offset == 0) {
+                    pageFree(aligned);
+                    return;
+                }
                 auto orig = uintptr_t(aligned) + offset;
                 std::free((void*)orig);
             }
@@ -97,6 +201,67 @@ namespace fmo {
             return false;
         }
     }
+
+    /// Provides the number of memory blocks allocated by aligned allocators so far, in all
+    /// threads. Image data is allocated this way, so this is effectively the number of image
+    /// allocations.
+    inline int64_t numAlignedAllocations() {
+        return detail::alignedAllocations().load(std::memory_order_relaxed);
+    }
+
+    /// Provides the number of memory blocks mapped directly from the OS due to AllocPolicy::PAGES
+    /// or AllocPolicy::HUGE_PAGES so far, in all threads.
+    inline int64_t numMappedAllocations() {
+        return detail::mappedAllocations().load(std::memory_order_relaxed);
+    }
+
+    /// Number and total size of heap allocations.
+    struct AllocCounts {
+        int64_t count = 0; ///< number of allocations
+        int64_t bytes = 0; ///< number of bytes requested
+    };
+
+    inline AllocCounts operator-(const AllocCounts& l, const AllocCounts& r) {
+        AllocCounts result;
+        result.count = l.count - r.count;
+        result.bytes = l.bytes - r.bytes;
+        return result;
+    }
+
+    inline AllocCounts& operator+=(AllocCounts& l, const AllocCounts& r) {
+        l.count += r.count;
+        l.bytes += r.bytes;
+        return l;
+    }
+
+    /// Provides the number and size of allocations made so far, in all threads. Blocks obtained
+    /// from aligned allocators, such as image data, are always included; calls to operator new
+    /// only if the program opts in using FMO_COUNT_ALLOCATIONS. Buffers that OpenCV allocates
+    /// internally using cv::fastMalloc() are not included. Take the difference of two readings to
+    /// attribute allocations to a piece of code.
+    inline AllocCounts heapAllocations() {
+        AllocCounts result;
+        result.count = detail::heapAllocations().load(std::memory_order_relaxed) +
+                       detail::alignedAllocations().load(std::memory_order_relaxed);
+        result.bytes = detail::heapAllocatedBytes().load(std::memory_order_relaxed) +
+                       detail::alignedAllocatedBytes().load(std::memory_order_relaxed);
+        return result;
+    }
+
+    /// Checks whether calls to operator new are being counted. Any program that uses
+    /// FMO_COUNT_ALLOCATIONS has allocated memory before main() is entered.
+    inline bool heapAllocationsCounted() {
+        return detail::heapAllocations().load(std::memory_order_relaxed) > 0;
+    }
 }
 
+/// Replaces the global operator new and operator delete with versions that count heap
+/// allocations, see fmo::heapAllocations(). Meant for tests and benchmarks. To opt in, place the
+/// macro at global scope in exactly one source file of the program.
+#define FMO_COUNT_ALLOCATIONS                                                                      \
+    void* operator new(std::size_t bytes) { return fmo::detail::countedNew(bytes); }               \
+    void* operator new[](std::size_t bytes) { return fmo::detail::countedNew(bytes); }             \
+    void operator delete(void* ptr) noexcept { std::free(ptr); }                                   \
+    void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
 #endif // FMO_ALLOCATOR_HPP
@@ -1,7 +1,16 @@
 #ifndef FMO_BENCHMARK_HPP
 #define FMO_BENCHMARK_HPP
 
+#include <array>
+#include <cstdint>
+#include <fmo/allocator.hpp>
+#include <fmo/common.hpp>
+#include <fmo/image.hpp>
+#include <fmo/perfcounters.hpp>
+#include <fmo/stats.hpp>
 #include <functional>
+#include <iosfwd>
+#include <string>
 #include <vector>
 
 namespace fmo {
@@ -9,6 +18,175 @@ namespace fmo {
     using stop_t = bool(*)();
     using bench_t = void(*)();
 
+    /// The input of a parameterized benchmark.
+    struct BenchParams {
+        /// Flags marking the parameters that a benchmark depends on.
+        enum Axis : int {
+            DIMS = 1,
+            FORMAT = 2,
+            HEIGHT = 4,
+            THREADS = 8,
+            COUNT = 16,
+        };
+
+        Dims dims;            ///< input resolution
+        Format format;        ///< input format
+        int processingHeight; ///< see Algorithm::Config::maxImageHeight
+        int numThreads;       ///< number of OpenCV threads, zero keeps the current setting
+        int count;            ///< number of items fed to a stage, e.g. strips or objects
+    };
+
+    /// Prepares the inputs of a parameterized benchmark and returns the measured function. An empty
+    /// function is returned if the combination of parameters is not supported. The time spent in
+    /// the setup function is not measured.
+    using setup_t = std::function<void()> (*)(const BenchParams&);
+
+    /// Selects the benchmarks to run and the parameters to run them with. Each parameterized
+    /// benchmark runs once for every combination of the parameters it depends on. Benchmarks that
+    /// depend on the item count additionally report how their duration scales with the count.
+    struct BenchOptions {
+        std::vector<std::string> filters;            ///< substrings of names to run, empty: all
+        int repetitions = 1;                         ///< times each measurement is repeated
+        int warmUp = Stats::DEFAULT_WARM_UP;         ///< calls preceding the measured calls
+        int numSamples = Stats::DEFAULT_SORT_PERIOD; ///< number of measured calls
+        int cpu = -1;                                ///< CPU to pin the benchmark thread to, or -1
+        double maxSeconds = 10;                      ///< measured time after which sampling stops
+        std::vector<Dims> resolutions = {{1920, 1080}};
+        std::vector<Format> formats = {Format::GRAY, Format::YUV420SP};
+        std::vector<int> processingHeights = {300};
+        std::vector<int> threads = {0};
+        /// Item counts, spaced so that benchmarks limited to small inputs still fit a scaling
+        /// exponent to at least three of them.
+        std::vector<int> counts = {10, 30, 100, 300, 1000, 3000, 10000};
+    };
+
+    /// The outcome of a single measurement.
+    struct BenchResult {
+        std::string name;
+        int axes;           ///< parameters that the benchmark depends on, see BenchParams::Axis
+        BenchParams params; ///< values of the parameters listed in axes
+        int repetition;
+        int64_t numPixels;  ///< pixels processed in a single call, zero if not applicable
+        int64_t numCalls;   ///< number of measured calls
+        double q50Ms;
+        double q95Ms;
+        double q99Ms;
+        double meanMs;
+        double minMs;
+        double maxMs;
+        bool haveCounters;  ///< whether any hardware performance counter is available
+        /// Per-call averages, always collected with a single OpenCV thread.
+        std::array<double, PerfCounters::NUM_EVENTS> counters;
+        std::vector<int64_t> samplesNs; ///< duration of each measured call
+    };
+
+    /// Outcome of comparing a benchmark with the same benchmark in a baseline.
+    struct BenchComparison {
+        enum Verdict {
+            SAME,        ///< no significant change
+            REGRESSION,  ///< significantly slower
+            IMPROVEMENT, ///< significantly faster
+            NEW,         ///< not present in the baseline
+            MISSING,     ///< present only in the baseline
+        };
+
+        std::string label; ///< name and parameters of the benchmark
+        Verdict verdict;
+        double baseQ50Ms;  ///< median duration in the baseline
+        double q50Ms;      ///< median duration in the new results
+        double change;     ///< relative change of the median, positive when slower
+        double pValue;     ///< see mannWhitneyP()
+    };
+
+    /// Fits the relationship t = c * n^k between the item count n and the median duration t of
+    /// the given results, using least squares in log-log space, and returns the exponent k. The
+    /// results should differ only in the item count. Returns zero if there are fewer than two
+    /// distinct counts.
+    double scalingExponent(const std::vector<BenchResult>& results);
+
+    /// Writes the results as a JSON array of objects, one per measurement.
+    void writeJson(std::ostream& out, const std::vector<BenchResult>& results);
+
+    /// Writes the results as CSV with a header row. Parameters that a benchmark does not depend on
+    /// are left empty.
+    void writeCsv(std::ostream& out, const std::vector<BenchResult>& results);
+
+    /// Writes the results, including the duration of each call, in a text format that can be read
+    /// back using loadBaseline().
+    void saveBaseline(std::ostream& out, const std::vector<BenchResult>& results);
+
+    /// Reads results written by saveBaseline(). Hardware counter values are not stored. Baselines
+    /// saved before the item count was recorded are read with a count of zero.
+    std::vector<BenchResult> loadBaseline(std::istream& in);
+
+    /// Selects the results of a baseline that a run with the given options measures again, i.e.
+    /// those whose name passes the filters and whose parameters, for the axes the benchmark
+    /// depends on, are among the values listed in the options. Use it before compareResults() so
+    /// that a narrower run does not report the rest of the baseline as missing.
+    std::vector<BenchResult> selectBaseline(const std::vector<BenchResult>& baseline,
+                                            const BenchOptions& options);
+
+    /// Compares results with a baseline, pooling the samples of all repetitions of a benchmark.
+    /// A benchmark regresses (improves) if its samples are slower (faster) with significance
+    /// "alpha" according to the Mann-Whitney U test, and its median changes by more than
+    /// "threshold", e.g. 0.05 for 5 %. Benchmarks are listed in the order of the new results,
+    /// followed by the benchmarks that are present only in the baseline.
+    std::vector<BenchComparison> compareResults(const std::vector<BenchResult>& baseline,
+                                                const std::vector<BenchResult>& results,
+                                                double threshold, double alpha);
+
+    /// Selects the algorithms and sequence variants for benchmarkAlgorithms().
+    struct AlgorithmBenchOptions {
+        std::vector<std::string> filters;  ///< substrings of algorithm names to run, empty: all
+        int warmUp = Stats::DEFAULT_WARM_UP; ///< frames processed before the measured frames
+        int numFrames = 300; ///< number of measured frames, the sequence is looped if shorter
+        std::vector<Dims> resolutions = {{640, 480}, {1280, 720}, {1920, 1080}};
+        std::vector<Format> formats = {Format::BGR}; ///< GRAY, BGR or YUV
+    };
+
+    /// The outcome of running a single algorithm over a sequence.
+    struct AlgorithmBenchResult {
+        std::string name; ///< algorithm name, see Algorithm::listFactories()
+        Dims dims;        ///< source resolution
+        Format format;    ///< source format
+        int numFrames;    ///< number of measured frames
+        double fps;       ///< frames per second, given the mean duration of a frame
+        double q50Ms;     ///< median duration of setInputView() and getOutput()
+        double q95Ms;
+        std::vector<std::string> stageNames;
+        std::vector<double> stageMeanMs; ///< mean duration of each stage, see Profiler
+        size_t peakMemory;               ///< largest Algorithm::getMemoryUsage() in bytes
+        double detectionsPerFrame;
+        bool haveAllocs;                 ///< whether heap allocations are counted
+        AllocCounts inputAllocs;         ///< heap allocations in all setInputView() calls
+        AllocCounts outputAllocs;        ///< heap allocations in all getOutput() calls
+        std::vector<AllocCounts> stageAllocs; ///< heap allocations in each stage, all frames
+    };
+
+    /// Runs every registered algorithm over a sequence of frames at each selected resolution and
+    /// format, reporting frames per second, the mean duration of each processing stage and the
+    /// peak memory held in image buffers. If the program counts heap allocations (see
+    /// FMO_COUNT_ALLOCATIONS), the allocations made by setInputView(), getOutput() and each stage
+    /// in the measured frames, image buffers included, are reported as well. The frames are
+    /// resized and converted before the measurements start and are passed using setInputView()
+    /// with setKeepInput() disabled. Each measurement is appended to "results".
+    ///
+    /// @param sequence BGR frames of any resolution, e.g. decoded from a recorded clip.
+    ///
+    /// @return False if the benchmark has been interrupted, e.g. by stopFunc or an exception, in
+    /// which case the results are incomplete.
+    bool benchmarkAlgorithms(const std::vector<Image>& sequence,
+                             const AlgorithmBenchOptions& options,
+                             std::vector<AlgorithmBenchResult>& results, log_t logFunc,
+                             stop_t stopFunc);
+
+    /// Writes the results as a JSON array of objects, one per algorithm and sequence variant.
+    void writeJson(std::ostream& out, const std::vector<AlgorithmBenchResult>& results);
+
+    /// Writes the results as CSV with a header row. Stage durations are listed in a single column
+    /// as "name=ms" pairs separated by semicolons, since each algorithm has different stages.
+    void writeCsv(std::ostream& out, const std::vector<AlgorithmBenchResult>& results);
+
     struct Registry {
         Registry(const Registry&) = delete;
 
@@ -16,14 +194,52 @@ namespace fmo {
 
         static Registry& get();
 
-        void add(const char* name, bench_t func) { mFuncs.emplace_back(name, func); }
+        /// @param numPixels Number of pixels processed in a single call of the function, used to
+        /// report per-pixel hardware counter values. Zero if not applicable.
+        void add(const char* name, bench_t func, int64_t numPixels) {
+            mFuncs.push_back({name, func, numPixels, nullptr, 0});
+        }
+
+        /// Adds a parameterized benchmark. The number of processed pixels is given by the input
+        /// resolution.
+        ///
+        /// @param axes Parameters that the benchmark depends on, see BenchParams::Axis.
+        void add(const char* name, setup_t setup, int axes) {
+            mFuncs.push_back({name, nullptr, 0, setup, axes});
+        }
+
+        /// Runs the benchmarks selected by the options, reporting q50 / q95 / q99 of their
+        /// duration in milliseconds. If hardware performance counters are available, instructions
+        /// per cycle, cycles per pixel, memory traffic per pixel (estimated from last-level cache
+        /// misses) and branch misses per pixel are reported as well. Since only the calling thread
+        /// is counted, the counters of a benchmark that runs with more than one OpenCV thread are
+        /// collected in a separate pass with a single thread. For benchmarks that depend on the
+        /// item count, the exponent returned by scalingExponent() is reported once all counts have
+        /// been measured. Each measurement is appended to "results".
+        ///
+        /// @return False if the run has been interrupted, e.g. by stopFunc or an exception, in
+        /// which case the results are incomplete.
+        bool run(const BenchOptions& options, std::vector<BenchResult>& results, log_t logFunc,
+                 stop_t stopFunc) const;
 
+        /// Runs all benchmarks with the default options.
         void runAll(log_t logFunc, stop_t stopFunc) const;
 
+        /// Logs the names of all benchmarks, one per line, with the parameters they depend on.
+        void list(log_t logFunc) const;
+
     private:
         Registry() = default;
 
-        std::vector<std::pair<const char*, bench_t>> mFuncs;
+        struct Entry {
+            const char* name;
+            bench_t func;
+            int64_t numPixels;
+            setup_t setup;
+            int axes;
+        };
+
+        std::vector<Entry> mFuncs;
     };
 
     struct Benchmark {
@@ -33,7 +249,9 @@ namespace fmo {
 
         Benchmark& operator=(const Benchmark&) = delete;
 
-        Benchmark(const char* name, bench_t);
+        Benchmark(const char* name, bench_t func, int64_t numPixels = 0);
+
+        Benchmark(const char* name, setup_t setup, int axes);
     };
 }
 
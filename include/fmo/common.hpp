@@ -21,8 +21,18 @@ namespace fmo {
         YUV,
         INT32,
         YUV420SP,
+        YUYV, ///< packed 4:2:2, bytes Y0 U Y1 V
+        UYVY, ///< packed 4:2:2, bytes U Y0 V Y1
+        P010, ///< semi-planar 4:2:0 like YUV420SP, 16-bit samples with 10 significant high bits
     };
 
+    /// Provides the name of a format, e.g. "YUV420SP" for Format::YUV420SP.
+    const char* formatName(Format format);
+
+    /// Finds a format by its name, as provided by formatName(). Returns Format::UNKNOWN if there is
+    /// no such format.
+    Format formatFromName(const char* name);
+
     /// Image location.
     struct Pos {
         int x, y;
@@ -114,10 +124,12 @@ namespace fmo {
         /// Provides access to image data.
         virtual const uint8_t* data() const = 0;
 
-        /// Provides access to the part of image data where UVis stored. Only for YUV420SP images.
+        /// Provides access to the part of image data where UVis stored. Only for YUV420SP and P010
+        /// images.
         virtual uint8_t* uvData() = 0;
 
-        /// Provides access to the part of image data where UVis stored. Only for YUV420SP images.
+        /// Provides access to the part of image data where UVis stored. Only for YUV420SP and P010
+        /// images.
         virtual const uint8_t* uvData() const = 0;
 
         /// Resizes the image to match the desired format and dimensions.
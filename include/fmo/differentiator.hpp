@@ -3,6 +3,7 @@
 
 #include <fmo/common.hpp>
 #include <fmo/image.hpp>
+#include <fmo/imagepool.hpp>
 
 namespace fmo {
 
@@ -23,7 +24,8 @@ namespace fmo {
             Config();
         };
 
-        Differentiator(const Config& config);
+        /// @param pool If not null, the scratch image is obtained from this pool.
+        Differentiator(const Config& config, ImagePool* pool = nullptr);
 
         /// Computes first-order absolute difference image in various formats. The inputs must have
         /// the same format and size. The output is resized to match the size of the inputs and its
@@ -35,8 +37,15 @@ namespace fmo {
         /// the noise fraction in the range mCfg.noiseMin to mCfg.noiseMax.
         void reportAmountOfNoise(int noise);
 
+        /// Provides the current threshold.
+        uint8_t thresh() const { return mThresh; }
+
+        /// Provides the number of bytes held by the scratch image.
+        size_t memoryUsage() const { return mAbsDiff.capacity(); }
+
     private:
         const Config mCfg;       ///< configuration object, received upon construction
+        ImagePool* mPool;        ///< source of scratch images, may be null
         Image mAbsDiff;          ///< cached absolute difference image
         uint8_t mThresh;         ///< current threshold
         std::vector<int> mNoise; ///< recent noise amounts
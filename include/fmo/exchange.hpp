@@ -2,8 +2,12 @@
 #define FMO_EXCHANGE_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <fmo/stats.hpp>
 #include <mutex>
+#include <thread>
 
 namespace fmo {
     /// Exchanges date in a multi-threaded scenario between a periodical producer and one or more
@@ -59,6 +63,156 @@ namespace fmo {
         bool mHave = false;
         bool mExit = false;
     };
+
+    /// A 32-bit atomic word that a thread can sleep on until its value changes. Uses futex on
+    /// Linux and a condition variable elsewhere.
+    struct WaitWord {
+        WaitWord(const WaitWord&) = delete;
+        WaitWord& operator=(const WaitWord&) = delete;
+        WaitWord(uint32_t value) : value(value) {}
+
+        /// Blocks while the value is equal to expected. May return spuriously.
+        void wait(uint32_t expected);
+
+        /// Wakes up all threads blocked in wait(). Must be called after the value changes.
+        void wakeAll();
+
+        std::atomic<uint32_t> value;
+
+    private:
+        std::mutex mMutex;
+        std::condition_variable mCondition;
+    };
+
+    /// A lock-free alternative to Exchange for a single producer and a single consumer, based on
+    /// a triple buffer. The producer writes into a back buffer and publishes it by swapping its
+    /// index with the middle buffer, so it never waits for the consumer. Like in Exchange, payload
+    /// gets dropped if it's not consumed before next payload arrives. A consumer waiting for data
+    /// spins first, then yields, then sleeps, see setWaitPolicy().
+    template <typename T>
+    struct TripleExchange {
+        TripleExchange(const TripleExchange&) = delete;
+        TripleExchange& operator=(const TripleExchange&) = delete;
+
+        /// Create a new exchange. The constructor arguments are forwarded to the constructor of
+        /// each of the three payloads.
+        template <typename... Args>
+        TripleExchange(const Args&... args)
+            : mSlots{{{args...}, 0}, {{args...}, 0}, {{args...}, 0}} {}
+
+        /// Sets how long the consumer waits actively before going to sleep.
+        ///
+        /// @param spinCount Number of polling attempts in a busy loop.
+        /// @param yieldCount Number of polling attempts after yielding the processor.
+        void setWaitPolicy(int spinCount, int yieldCount) {
+            mSpinCount = spinCount;
+            mYieldCount = yieldCount;
+        }
+
+        /// Provides the back buffer, to be filled by the producer and published using send(). To
+        /// be called from the producer thread only.
+        T& sendBuffer() { return mSlots[mBack].payload; }
+
+        /// Publishes the back buffer to the consumer. Previous payload is discarded if it hasn't
+        /// been received yet. To be called from the producer thread only.
+        void send() {
+            mSlots[mBack].sendNs = nanoTime();
+            uint32_t old = mState.value.load(std::memory_order_relaxed);
+            uint32_t desired;
+            do {
+                desired = mBack | FRESH | (old & EXIT);
+            } while (!mState.value.compare_exchange_weak(old, desired, std::memory_order_acq_rel,
+                                                         std::memory_order_relaxed));
+            mBack = old & INDEX;
+            mNumSent.fetch_add(1, std::memory_order_relaxed);
+            if ((old & FRESH) != 0) { mNumDropped.fetch_add(1, std::memory_order_relaxed); }
+            if ((old & WAITING) != 0) { mState.wakeAll(); }
+        }
+
+        /// Sends new data to the consumer. Data is stored by swapping.
+        void swapSend(T& payload) {
+            using std::swap;
+            swap(sendBuffer(), payload);
+            send();
+        }
+
+        /// Get the most recent payload deposited using send(). If there is no new, previously
+        /// unreceived payload available, the method will wait until there's new data or the exit()
+        /// method is called. Data is received by swapping. To be called from the consumer thread
+        /// only.
+        ///
+        /// @param sendNs If not null, receives the time at which the payload was sent, as returned
+        /// by nanoTime().
+        /// @return True if a payload has been received, false if exit() has been called.
+        bool swapReceive(T& payload, int64_t* sendNs = nullptr) {
+            uint32_t old = waitForData();
+            if ((old & EXIT) != 0) return false;
+
+            while (!mState.value.compare_exchange_weak(old, mFront | (old & EXIT),
+                                                       std::memory_order_acq_rel,
+                                                       std::memory_order_relaxed)) {}
+            mFront = old & INDEX;
+
+            using std::swap;
+            swap(mSlots[mFront].payload, payload);
+            if (sendNs != nullptr) *sendNs = mSlots[mFront].sendNs;
+            return true;
+        }
+
+        /// Set the internal exit flag and wake up the waiting thread.
+        void exit() {
+            mState.value.fetch_or(EXIT, std::memory_order_acq_rel);
+            mState.wakeAll();
+        }
+
+        /// Provides the number of payloads sent so far.
+        int64_t numSent() const { return mNumSent.load(std::memory_order_relaxed); }
+
+        /// Provides the number of payloads that were overwritten before being received.
+        int64_t numDropped() const { return mNumDropped.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr uint32_t INDEX = 0x3;   ///< index of the middle buffer
+        static constexpr uint32_t FRESH = 0x4;   ///< the middle buffer hasn't been received yet
+        static constexpr uint32_t WAITING = 0x8; ///< the consumer is sleeping
+        static constexpr uint32_t EXIT = 0x10;   ///< exit() has been called
+
+        struct Slot {
+            T payload;
+            int64_t sendNs;
+        };
+
+        /// Waits until the state has either the FRESH or the EXIT flag, returns the state.
+        uint32_t waitForData() {
+            uint32_t state = mState.value.load(std::memory_order_acquire);
+            for (int i = 0; (state & (FRESH | EXIT)) == 0; i++) {
+                if (i < mSpinCount) {
+                    // busy wait
+                } else if (i < mSpinCount + mYieldCount) {
+                    std::this_thread::yield();
+                } else {
+                    // announce sleeping, the producer wakes the consumer up after a change
+                    uint32_t waiting = state | WAITING;
+                    if (state == waiting ||
+                        mState.value.compare_exchange_strong(state, waiting,
+                                                             std::memory_order_acq_rel)) {
+                        mState.wait(waiting);
+                    }
+                }
+                state = mState.value.load(std::memory_order_acquire);
+            }
+            return state;
+        }
+
+        Slot mSlots[3];
+        WaitWord mState{2};     ///< index of the middle buffer and flags
+        int mBack = 0;          ///< index of the back buffer, owned by the producer
+        int mFront = 1;         ///< index of the front buffer, owned by the consumer
+        int mSpinCount = 1000;  ///< see setWaitPolicy()
+        int mYieldCount = 100;  ///< see setWaitPolicy()
+        std::atomic<int64_t> mNumSent{0};
+        std::atomic<int64_t> mNumDropped{0};
+    };
 }
 
 #endif // FMO_EXCHANGE_HPP
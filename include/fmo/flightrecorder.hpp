@@ -0,0 +1,141 @@
+#ifndef FMO_FLIGHTRECORDER_HPP
+#define FMO_FLIGHTRECORDER_HPP
+
+#include <fmo/image.hpp>
+#include <fmo/profiler.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fmo {
+    /// Keeps the processing-level inputs and per-stage timings of the last NUM_FRAMES frames and
+    /// writes them to disk whenever a frame takes longer than a threshold, so that pathological
+    /// frames can be reproduced offline. The recorder is disabled unless a threshold is set using
+    /// configure(); while disabled, its methods only test a flag. Once the buffers have been
+    /// allocated, nothing is allocated until a frame is dumped.
+    ///
+    /// A slow frame only copies the kept frames to an in-memory dump, which is written by a
+    /// background thread, so the disk is never touched while a frame is being processed. If the
+    /// writer is still busy with earlier dumps, the new one is dropped. Write failures are logged
+    /// to the standard error output and counted, never thrown.
+    ///
+    /// A dump of the N-th frame since configure() consists of "fmo-frame-N.txt", listing the frame
+    /// time, the stage durations, the difference threshold and the strip count of each kept frame,
+    /// and of the lossless images "fmo-frame-N-K.png", the K-th being the processing-level input
+    /// of the K-th frame listed, oldest first. Use load() to read a dump back and replayInput() to
+    /// turn the kept images into inputs for an algorithm with the same name, with
+    /// Config::maxImageHeight set to the height of the images and Config::diff.thresh set to the
+    /// recorded difference threshold of the oldest frame.
+    struct FlightRecorder {
+        /// Number of frames kept, enough for algorithms that compare the last three frames.
+        static constexpr int NUM_FRAMES = 3;
+        /// Dumps stop after this many, so that a slow machine does not fill up the disk.
+        static constexpr int MAX_DUMPS = 16;
+
+        /// Information about a single frame.
+        struct Snapshot {
+            int frameNum = -1;             ///< algorithm frame number, -1 if no input was kept
+            Image input;                   ///< processing-level input image
+            int diffThresh = 0;            ///< difference threshold used in the frame
+            int numStrips = 0;             ///< number of strips detected in the frame
+            int64_t totalNs = 0;           ///< frame time in nanoseconds
+            std::vector<int64_t> stagesNs; ///< duration of each profiler stage in nanoseconds
+        };
+
+        /// Contents of a single dump.
+        struct Recording {
+            float thresholdMs = 0;               ///< threshold that the last frame exceeded
+            std::vector<std::string> stageNames; ///< names of the stages in Snapshot::stagesNs
+            std::vector<Snapshot> frames;        ///< kept frames, oldest first
+        };
+
+        FlightRecorder();
+        ~FlightRecorder();
+
+        /// Enables the recorder.
+        ///
+        /// @param thresholdMs Frames that take longer than this value in milliseconds are dumped.
+        /// Use zero to disable.
+        /// @param dir Directory to write the dumps to.
+        /// @param profiler Profiler of the algorithm, which will be set up to keep the duration
+        /// of the stages of the last frame.
+        void configure(float thresholdMs, const std::string& dir, Profiler& profiler);
+
+        /// Checks whether a threshold has been set.
+        bool enabled() const { return mThresholdNs > 0; }
+
+        /// To be called as soon as the processing of a frame starts.
+        void frameStart() {
+            if (enabled()) frameStartImpl();
+        }
+
+        /// To be called once the input has been decimated to the processing level. Keeps a copy of
+        /// the processing-level input.
+        void keepInput(const Mat& input, int frameNum) {
+            if (enabled()) keepInputImpl(input, frameNum);
+        }
+
+        /// To be called as soon as the processing of a frame ends. Hands the kept frames over to
+        /// the writer thread if the frame time exceeds the threshold.
+        ///
+        /// @return True if the frames have been handed over.
+        bool frameEnd(const Profiler& profiler, int diffThresh, int numStrips) {
+            if (!enabled()) return false;
+            return frameEndImpl(profiler, diffThresh, numStrips);
+        }
+
+        /// Waits until the writer thread has written all dumps handed over so far.
+        void flush();
+
+        /// Provides the number of dumps written so far.
+        int numDumps() const;
+
+        /// Provides the number of dumps that could not be written, either because of an I/O error
+        /// or because the writer thread was busy.
+        int numFailures() const;
+
+        /// Provides the path of the text file of the last dump written.
+        std::string lastDump() const;
+
+        /// Provides the description of the last failure, empty if there was none.
+        std::string lastError() const;
+
+        /// Reads a dump back, including the images.
+        ///
+        /// @param file Path to the text file of the dump, as provided by lastDump().
+        static Recording load(const std::string& file);
+
+        /// Scales a kept image up twice using nearest-neighbor interpolation, so that an algorithm
+        /// configured as described above decimates it back to the recorded processing level.
+        static void replayInput(const Snapshot& snapshot, Image& dst);
+
+    private:
+        struct Dump;
+        struct Writer;
+
+        void frameStartImpl();
+        void keepInputImpl(const Mat& input, int frameNum);
+        bool frameEndImpl(const Profiler& profiler, int diffThresh, int numStrips);
+        void dump(const Profiler& profiler);
+        void succeeded(const std::string& file);
+        void failed(const std::string& error);
+
+        // data
+        int64_t mThresholdNs = 0;
+        int64_t mStartNs = 0;
+        std::string mDir;
+        Snapshot mSnapshots[NUM_FRAMES];
+        int64_t mNumFrames = 0;          ///< total number of frames started
+        int mNumHandedOver = 0;          ///< number of dumps passed to the writer, up to MAX_DUMPS
+        std::unique_ptr<Dump> mPending;  ///< buffers of the next dump, swapped with the writer
+        std::unique_ptr<Writer> mWriter; ///< started by the first dump, stopped by flush()
+        mutable std::mutex mStatusMutex; ///< guards the members below, updated by the writer
+        int mNumDumps = 0;
+        int mNumFailures = 0;
+        std::string mLastDump;
+        std::string mLastError;
+    };
+}
+
+#endif // FMO_FLIGHTRECORDER_HPP
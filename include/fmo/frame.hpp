@@ -0,0 +1,120 @@
+#ifndef FMO_FRAME_HPP
+#define FMO_FRAME_HPP
+
+#include <atomic>
+#include <fmo/image.hpp>
+#include <memory>
+
+namespace fmo {
+    struct FramePool;
+    struct FramePoolState;
+
+    /// A read-only handle to an image stored in a FramePool. Copying a frame does not copy the
+    /// image data, it only increments a reference count. The image buffer is returned to the pool
+    /// when the last handle is destroyed. Handles may be passed between threads.
+    struct Frame {
+        ~Frame() { release(); }
+        Frame() = default;
+
+        Frame(const Frame& rhs) noexcept : mBuffer(rhs.mBuffer) { acquire(); }
+
+        Frame& operator=(const Frame& rhs) noexcept {
+            Frame copy{rhs};
+            swap(copy);
+            return *this;
+        }
+
+        Frame(Frame&& rhs) noexcept { swap(rhs); }
+
+        Frame& operator=(Frame&& rhs) noexcept {
+            swap(rhs);
+            return *this;
+        }
+
+        /// Swaps the contents of the two Frame instances.
+        void swap(Frame& rhs) noexcept { std::swap(mBuffer, rhs.mBuffer); }
+
+        /// Swaps the contents of the two Frame instances.
+        friend void swap(Frame& lhs, Frame& rhs) noexcept { lhs.swap(rhs); }
+
+        /// Releases the image buffer, leaving the frame empty.
+        void reset() noexcept {
+            Frame empty;
+            swap(empty);
+        }
+
+        /// Checks whether the frame refers to an image.
+        explicit operator bool() const { return mBuffer != nullptr; }
+
+        /// Provides access to the image. The frame must not be empty.
+        const Image& image() const { return mBuffer->image; }
+
+        /// Provides the number of handles that refer to the same image.
+        int useCount() const { return mBuffer ? mBuffer->refs.load() : 0; }
+
+        /// Provides an image that refers to the frame's buffer instead of copying it, e.g. to be
+        /// passed to Algorithm::setInputSwap(). The image holds a reference to the frame until it
+        /// releases the buffer, see Image::adopt(). The image data must not be modified. The frame
+        /// must not be empty.
+        Image share() const;
+
+    private:
+        friend struct FramePool;
+        friend struct FramePoolState;
+
+        struct Buffer {
+            Image image;
+            std::atomic<int> refs{0};
+            std::shared_ptr<FramePoolState> pool;
+        };
+
+        Frame(Buffer* buffer) noexcept : mBuffer(buffer) { acquire(); }
+
+        void acquire() const noexcept {
+            if (mBuffer) mBuffer->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release() noexcept;
+
+        Buffer* mBuffer = nullptr;
+    };
+
+    /// Recycles image buffers for frames of a given format and size. A frame is published once
+    /// using publish() and then shared by several readers without copying. The pool grows when
+    /// all buffers are in use and never shrinks. Buffers in use when the pool is destroyed are
+    /// deallocated as soon as they are released.
+    struct FramePool {
+        FramePool(const FramePool&) = delete;
+        FramePool& operator=(const FramePool&) = delete;
+        ~FramePool();
+
+        /// Creates an empty pool for images of the given format and dimensions.
+        FramePool(Format format, Dims dims);
+
+        /// Obtains a free buffer, lets the fill function write the image data into it, and
+        /// returns the buffer as a read-only frame.
+        ///
+        /// @param fill A function taking Image&. The image already has the format and dimensions
+        /// of the pool.
+        template <typename Fill>
+        Frame publish(Fill&& fill) {
+            Frame::Buffer* buffer = take();
+            Frame frame{buffer};
+            fill(buffer->image);
+            return frame;
+        }
+
+        /// Provides the number of buffers that have been allocated by the pool.
+        int numAllocated() const;
+
+        /// Provides the number of buffers that are ready to be reused.
+        int numFree() const;
+
+    private:
+        Frame::Buffer* take();
+
+        std::shared_ptr<FramePoolState> mState;
+    };
+}
+
+#endif // FMO_FRAME_HPP
@@ -0,0 +1,94 @@
+#ifndef FMO_GOVERNOR_HPP
+#define FMO_GOVERNOR_HPP
+
+#include <array>
+#include <cstdint>
+#include <fmo/stats.hpp>
+
+namespace fmo {
+    /// Monitors the processing time of each frame and decides when an algorithm should switch to
+    /// a coarser or a finer processing level, so that the 95% quantile of frame time stays within a
+    /// budget. A decision is made once every WINDOW frames. The level is the number of decimation
+    /// steps in addition to the ones that the algorithm would normally perform; it never drops
+    /// below zero. The governor is disabled unless a budget is set using configure().
+    struct LatencyGovernor {
+        /// Number of frames between decisions.
+        static constexpr int WINDOW = 30;
+        /// Switching to a coarser level is not allowed if the processing height would drop below
+        /// this value.
+        static constexpr int MIN_HEIGHT = 60;
+
+        /// Information about a change of the processing level.
+        struct Switch {
+            int frameNum = 0;  ///< number of frames measured before the switch
+            int oldLevel = 0;  ///< level before the switch
+            int newLevel = 0;  ///< level after the switch
+            float q95Ms = 0.f; ///< 95% quantile of frame time that caused the switch
+        };
+
+        /// Source of the time stamps taken by frameStart() and frameEnd(), in nanoseconds.
+        using now_t = int64_t (*)();
+
+        /// Enables the governor.
+        ///
+        /// @param budgetMs Target 95% quantile of frame time in milliseconds. Use zero to disable.
+        /// @param hysteresis Switching to a finer level is only allowed when the 95% quantile is
+        /// below budgetMs multiplied by this value. A finer level has four times as many pixels,
+        /// so values around 0.25 and below prevent oscillation.
+        /// @param height Processing height at level zero, limits the maximum level.
+        void configure(float budgetMs, float hysteresis, int height);
+
+        /// Checks whether a budget has been set.
+        bool enabled() const { return mBudgetNs > 0; }
+
+        /// Replaces the clock used by frameStart() and frameEnd(), e.g. to simulate frame times in
+        /// tests. The default is nanoTime().
+        void setClock(now_t now) { mNow = now; }
+
+        /// To be called as soon as the processing of a frame starts.
+        void frameStart() {
+            if (enabled()) mStartNs = mNow();
+        }
+
+        /// To be called as soon as the processing of a frame ends.
+        ///
+        /// @return True if the level has changed and the algorithm should switch.
+        bool frameEnd() {
+            if (!enabled()) return false;
+            return add(mNow() - mStartNs);
+        }
+
+        /// Adds a measured frame time.
+        ///
+        /// @return True if the level has changed and the algorithm should switch.
+        bool add(int64_t frameNs);
+
+        /// Provides the current level.
+        int level() const { return mLevel; }
+
+        /// Provides the maximum allowed level.
+        int maxLevel() const { return mMaxLevel; }
+
+        /// Provides the number of level changes so far.
+        int numSwitches() const { return mNumSwitches; }
+
+        /// Provides information about the last level change.
+        const Switch& lastSwitch() const { return mLastSwitch; }
+
+    private:
+        // data
+        now_t mNow = nanoTime;
+        int64_t mBudgetNs = 0;
+        int64_t mFinerNs = 0;
+        int64_t mStartNs = 0;
+        int mLevel = 0;
+        int mMaxLevel = 0;
+        int mNumFrames = 0;
+        int mNumSwitches = 0;
+        int mNumSamples = 0;
+        std::array<int64_t, WINDOW> mSamples;
+        Switch mLastSwitch;
+    };
+}
+
+#endif // FMO_GOVERNOR_HPP
@@ -3,26 +3,34 @@
 
 #include <fmo/common.hpp>
 #include <fmo/allocator.hpp>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace fmo {
     /// Stores an image in contiguous memory. Has value semantics, i.e. copying aninstance of Image
-    /// will perform a copy of the entire image data.
+    /// will perform a copy of the entire image data. Optionally, each row can be padded so that
+    /// every row starts at an aligned address, see setRowAlign(). Use skip() to advance to the
+    /// next row. Instead of owning its data, an image may also adopt a buffer provided by the
+    /// caller, see adopt().
     struct Image final : public Mat {
         using iterator = uint8_t*;
         using const_iterator = const uint8_t*;
 
-        ~Image() = default;
+        /// Type of a function that hands an adopted buffer back to its owner. Receives the data
+        /// pointer passed to adopt(). Must not throw.
+        using Release = std::function<void(uint8_t* data)>;
+
+        ~Image() { releaseAdopted(); }
         Image() = default;
 
-        /// Copies the contents from another image.
-        Image(const Image& rhs) { assign(rhs.mFormat, rhs.mDims, rhs.mData.data()); }
+        /// Copies the contents from another image, including row padding.
+        Image(const Image& rhs) { copyFrom(rhs); }
 
-        /// Copies the contents from another image.
+        /// Copies the contents from another image, including row padding.
         Image& operator=(const Image& rhs) {
-            assign(rhs.mFormat, rhs.mDims, rhs.mData.data());
+            if (&rhs != this) copyFrom(rhs);
             return *this;
         }
 
@@ -41,32 +49,68 @@ namespace fmo {
         /// Copies an image from memory.
         Image(Format format, Dims dims, const uint8_t* data) { assign(format, dims, data); }
 
-        /// Copies an image from memory.
+        /// Copies an image from memory. The source rows must not be padded.
         void assign(Format format, Dims dims, const uint8_t* data);
 
+        /// Adopts an image in memory owned by the caller, see adopt().
+        Image(Format format, Dims dims, uint8_t* data, Release release) {
+            adopt(format, dims, data, std::move(release));
+        }
+
+        /// Uses an image in memory owned by the caller without copying it, e.g. a buffer received
+        /// from a decoder or a camera API. The buffer must not be padded and must remain valid
+        /// until the release function is called. This happens as soon as the image no longer uses
+        /// the buffer: when it is destroyed, cleared, resized to a different format or size, or
+        /// assigned to. Swapping passes the buffer, along with the release function, to the other
+        /// image. Copies of an adopted image own their data.
+        void adopt(Format format, Dims dims, uint8_t* data, Release release);
+
+        /// Checks whether the image uses a buffer provided by adopt().
+        bool adopted() const { return mAdopted != nullptr; }
+
         /// Creates an image with specified format and dimensions.
         Image(Format format, Dims dims) { resize(format, dims); }
 
-        /// The number of bytes in the image.
-        size_t size() const { return mData.size(); }
+        /// Creates an image with specified format and dimensions, padding each row to a multiple of
+        /// rowAlign bytes.
+        Image(Format format, Dims dims, size_t rowAlign) {
+            setRowAlign(rowAlign);
+            resize(format, dims);
+        }
+
+        /// Sets the alignment of rows used by subsequent calls to resize(). Each row will be
+        /// padded to a multiple of rowAlign bytes. With rowAlign set to 32 or 64, every row starts
+        /// at an address suitable for aligned vector loads. The default value of 1 means no
+        /// padding. The value of the padding bytes is undefined.
+        void setRowAlign(size_t rowAlign);
+
+        /// Provides the row alignment set by setRowAlign().
+        size_t rowAlign() const { return mRowAlign; }
+
+        /// The number of bytes in the image, including the padding.
+        size_t size() const { return (mAdopted != nullptr) ? mAdoptedSize : mData.size(); }
+
+        /// The number of bytes allocated by the image, which may exceed size(). Adopted buffers are
+        /// owned by the caller and are not included.
+        size_t capacity() const { return mData.capacity(); }
 
         /// Provides iterator access to the underlying data.
-        iterator begin() { return mData.data(); }
+        iterator begin() { return data(); }
 
         /// Provides iterator access to the underlying data.
-        const_iterator begin() const { return mData.data(); }
+        const_iterator begin() const { return data(); }
 
         /// Provides iterator access to the underlying data.
-        friend iterator begin(Image& img) { return img.mData.data(); }
+        friend iterator begin(Image& img) { return img.data(); }
 
         /// Provides iterator access to the underlying data.
-        friend const_iterator begin(const Image& img) { return img.mData.data(); }
+        friend const_iterator begin(const Image& img) { return img.data(); }
 
         /// Provides iterator access to the underlying data.
-        iterator end() { return begin() + mData.size(); }
+        iterator end() { return begin() + size(); }
 
         /// Provides iterator access to the underlying data.
-        const_iterator end() const { return begin() + mData.size(); }
+        const_iterator end() const { return begin() + size(); }
 
         /// Provides iterator access to the underlying data.
         friend iterator end(Image& img) { return img.end(); }
@@ -79,13 +123,21 @@ namespace fmo {
             mData.swap(rhs.mData);
             std::swap(mDims, rhs.mDims);
             std::swap(mFormat, rhs.mFormat);
+            std::swap(mRowAlign, rhs.mRowAlign);
+            std::swap(mPitch, rhs.mPitch);
+            std::swap(mAdopted, rhs.mAdopted);
+            std::swap(mAdoptedSize, rhs.mAdoptedSize);
+            mRelease.swap(rhs.mRelease);
         }
 
-        /// Removes all data and sets the size to zero. Does not deallocate any memory.
+        /// Removes all data and sets the size to zero. Does not deallocate any memory, but releases
+        /// an adopted buffer.
         void clear() noexcept {
+            releaseAdopted();
             mData.clear();
             mDims = {0, 0};
             mFormat = Format::UNKNOWN;
+            mPitch = 0;
         }
 
         /// Swaps the contents of the two Image instances.
@@ -95,20 +147,26 @@ namespace fmo {
         virtual Region region(Pos pos, Dims dims) override;
 
         /// The number of bytes to advance if one needs to access the next row.
-        virtual size_t skip() const override { return mDims.width; }
+        virtual size_t skip() const override { return mPitch; }
 
         /// Provides access to image data.
-        virtual uint8_t* data() override { return mData.data(); }
+        virtual uint8_t* data() override {
+            return (mAdopted != nullptr) ? mAdopted : mData.data();
+        }
 
         /// Provides access to image data.
-        virtual const uint8_t* data() const override { return mData.data(); }
+        virtual const uint8_t* data() const override {
+            return (mAdopted != nullptr) ? mAdopted : mData.data();
+        }
 
-        /// Provides access to the part of image data where UVis stored. Only for YUV420SP images.
-        virtual uint8_t* uvData() override { return data() + (mDims.width * mDims.height); }
+        /// Provides access to the part of image data where UVis stored. Only for YUV420SP and P010
+        /// images.
+        virtual uint8_t* uvData() override { return data() + (mPitch * mDims.height); }
 
-        /// Provides access to the part of image data where UVis stored. Only for YUV420SP images.
+        /// Provides access to the part of image data where UVis stored. Only for YUV420SP and P010
+        /// images.
         virtual const uint8_t* uvData() const override {
-            return data() + (mDims.width * mDims.height);
+            return data() + (mPitch * mDims.height);
         }
 
         /// Resizes the image to match the desired format and dimensions. When the size increases,
@@ -123,7 +181,15 @@ namespace fmo {
         virtual cv::Mat wrap() const override;
 
     private:
+        void copyFrom(const Image& rhs);
+        void releaseAdopted() noexcept;
+
         std::vector<uint8_t, fmo::detail::aligned_allocator<uint8_t, 32>> mData;
+        size_t mRowAlign = 1;        ///< see setRowAlign()
+        size_t mPitch = 0;           ///< number of bytes in a row, including padding
+        uint8_t* mAdopted = nullptr; ///< buffer provided by adopt(), used instead of mData
+        size_t mAdoptedSize = 0;     ///< number of bytes in the adopted buffer
+        Release mRelease;            ///< hands the adopted buffer back to its owner
     };
 }
 
@@ -0,0 +1,62 @@
+#ifndef FMO_IMAGEPOOL_HPP
+#define FMO_IMAGEPOOL_HPP
+
+#include <fmo/common.hpp>
+#include <fmo/image.hpp>
+#include <vector>
+
+namespace fmo {
+    /// Recycles image buffers, keyed by format, dimensions and row alignment. Instead of resizing
+    /// an image, which reallocates whenever the size grows, use acquire() to obtain a buffer of
+    /// the right size from the pool. Buffers are exchanged by swapping, so that once the pool
+    /// holds a buffer for every format and size in use, no more allocations take place. Not
+    /// thread-safe.
+    struct ImagePool {
+        /// Counters describing the efficiency of the pool.
+        struct Stats {
+            int64_t hits = 0;   ///< requests satisfied without an allocation
+            int64_t misses = 0; ///< requests that required an allocation
+        };
+
+        /// Creates an empty pool that allocates according to the global policy, see
+        /// getAllocPolicy().
+        ImagePool() : mAllocPolicy(getAllocPolicy()) {}
+        ImagePool(const ImagePool&) = delete;
+        ImagePool& operator=(const ImagePool&) = delete;
+
+        /// Makes sure that the image has the given format and dimensions. If it doesn't, the
+        /// current buffer of the image is returned to the pool and replaced by a pooled buffer of
+        /// the given format and dimensions, keeping the row alignment of the image. The contents of
+        /// the image are undefined afterwards, unless the image already had the right format and
+        /// dimensions.
+        void acquire(Image& image, Format format, Dims dims);
+
+        /// Returns the buffer of the image to the pool, leaving the image empty. Adopted buffers
+        /// are released to their owner instead, see Image::adopt().
+        void release(Image& image);
+
+        /// Provides the hit and miss counters.
+        const Stats& stats() const { return mStats; }
+
+        /// Provides the number of buffers ready to be reused.
+        int numFree() const { return int(mFree.size()); }
+
+        /// Provides the number of bytes held by the buffers ready to be reused.
+        size_t numFreeBytes() const;
+
+        /// Selects where buffers allocated by the pool from now on will come from. Use
+        /// AllocPolicy::HUGE_PAGES for pools that hold large images, e.g. full-resolution frames,
+        /// to reduce TLB misses.
+        void setAllocPolicy(AllocPolicy policy) { mAllocPolicy = policy; }
+
+        /// Provides the policy selected by setAllocPolicy().
+        AllocPolicy allocPolicy() const { return mAllocPolicy; }
+
+    private:
+        std::vector<Image> mFree; ///< buffers ready to be reused
+        Stats mStats;
+        AllocPolicy mAllocPolicy;
+    };
+}
+
+#endif // FMO_IMAGEPOOL_HPP
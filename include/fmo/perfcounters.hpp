@@ -0,0 +1,53 @@
+#ifndef FMO_PERFCOUNTERS_HPP
+#define FMO_PERFCOUNTERS_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace fmo {
+    /// Hardware performance counters of the calling thread, opened using perf_event_open() on
+    /// Linux. Counters that the CPU, the kernel or its settings do not provide are reported as
+    /// unavailable and read as zero; on other systems, no counter is available. Only user-space
+    /// events of the thread that created the object are counted, so work done in other threads,
+    /// e.g. by cv::parallel_for_(), is not included.
+    struct PerfCounters {
+        enum Event {
+            CYCLES,        ///< CPU cycles
+            INSTRUCTIONS,  ///< retired instructions
+            L1D_MISSES,    ///< L1 data cache read misses
+            LLC_MISSES,    ///< last-level cache misses, i.e. memory accesses
+            BRANCH_MISSES, ///< mispredicted branches
+            NUM_EVENTS
+        };
+
+        /// Counter values, indexed by Event.
+        using Values = std::array<int64_t, NUM_EVENTS>;
+
+        /// Size of a cache line in bytes, used to estimate memory traffic from LLC misses.
+        static constexpr int CACHE_LINE = 64;
+
+        /// Opens and starts all available counters.
+        PerfCounters();
+        ~PerfCounters();
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        /// Checks whether any counter is available.
+        bool available() const;
+
+        /// Checks whether a given counter is available.
+        bool available(Event event) const { return mFds[event] != -1; }
+
+        /// Reads the current values of the counters. The values only make sense as differences
+        /// between two reads.
+        void read(Values& out) const;
+
+        /// Provides a short name of an event.
+        static const char* name(Event event);
+
+    private:
+        std::array<int, NUM_EVENTS> mFds;
+    };
+}
+
+#endif // FMO_PERFCOUNTERS_HPP
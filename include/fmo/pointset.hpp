@@ -65,6 +65,151 @@ namespace fmo {
         auto lastUnique = std::unique(begin(out), end(out), pointSetCompEq);
         out.erase(lastUnique, end(out));
     }
+
+    /// A horizontal run of points in an image: all points at row y with x in range [xBegin, xEnd).
+    struct Span {
+        int y;      ///< row
+        int xBegin; ///< first column
+        int xEnd;   ///< one past the last column
+
+        /// The number of points in the span.
+        int size() const { return xEnd - xBegin; }
+    };
+
+    /// Comparison function for SpanSet -- less than.
+    inline bool spanSetCompLt(const Span& l, const Span& r) {
+        return l.y < r.y || (l.y == r.y && l.xBegin < r.xBegin);
+    }
+
+    /// A set of points in an image, stored as horizontal runs. As an invariant, the set must be
+    /// sorted according to spanSetCompLt, and the spans must be non-empty and must neither overlap
+    /// nor touch each other. Memory and comparison time is proportional to the number of rows
+    /// rather than to the number of points.
+    using SpanSet = std::vector<Span>;
+
+    /// Sorts the spans and joins the ones that overlap or touch, so that the set meets the
+    /// invariants of SpanSet. Empty spans are removed.
+    inline void spanSetNormalize(SpanSet& s) {
+        std::sort(begin(s), end(s), spanSetCompLt);
+        auto out = begin(s);
+
+        for (auto in = begin(s); in != end(s); in++) {
+            if (in->xEnd <= in->xBegin) continue;
+            if (out != begin(s)) {
+                auto& last = *(out - 1);
+                if (last.y == in->y && last.xEnd >= in->xBegin) {
+                    last.xEnd = std::max(last.xEnd, in->xEnd);
+                    continue;
+                }
+            }
+            *out++ = *in;
+        }
+
+        s.erase(out, end(s));
+    }
+
+    /// Calculates the number of points in a span set.
+    inline int spanSetSize(const SpanSet& s) {
+        int result = 0;
+        for (auto& span : s) { result += span.size(); }
+        return result;
+    }
+
+    /// Converts a point set to a span set.
+    inline void spanSetFromPoints(const PointSet& points, SpanSet& out) {
+        out.clear();
+        for (auto& pt : points) {
+            if (!out.empty() && out.back().y == pt.y && out.back().xEnd == pt.x) {
+                out.back().xEnd++;
+            } else {
+                out.push_back({pt.y, pt.x, pt.x + 1});
+            }
+        }
+    }
+
+    /// Converts a span set to a point set.
+    inline void spanSetToPoints(const SpanSet& s, PointSet& out) {
+        out.clear();
+        for (auto& span : s) {
+            for (int x = span.xBegin; x < span.xEnd; x++) { out.push_back({x, span.y}); }
+        }
+    }
+
+    /// Compares two span sets, the span equivalent of pointSetCompare(). Assumes that both span
+    /// sets meet the invariants of SpanSet. For each maximal piece of a span in s1 but not in s2,
+    /// extra1 is called. For each maximal piece of a span in s2 but not in s1, extra2 is called.
+    /// For each piece in both s1 and s2, match is called. The pieces are reported in order.
+    template <typename Func1, typename Func2, typename Func3>
+    void spanSetCompare(const fmo::SpanSet& s1, const fmo::SpanSet& s2, Func1 extra1,
+                        Func2 extra2, Func3 match) {
+        auto i1 = begin(s1);
+        auto i1e = end(s1);
+        auto i2 = begin(s2);
+        auto i2e = end(s2);
+        Span a = (i1 != i1e) ? *i1 : Span{};
+        Span b = (i2 != i2e) ? *i2 : Span{};
+
+        while (i1 != i1e && i2 != i2e) {
+            if (a.y < b.y || (a.y == b.y && a.xEnd <= b.xBegin)) {
+                // the rest of a precedes b
+                extra1(a);
+                if (++i1 != i1e) a = *i1;
+            } else if (b.y < a.y || (a.y == b.y && b.xEnd <= a.xBegin)) {
+                // the rest of b precedes a
+                extra2(b);
+                if (++i2 != i2e) b = *i2;
+            } else if (a.xBegin < b.xBegin) {
+                // a and b overlap, a starts first
+                extra1(Span{a.y, a.xBegin, b.xBegin});
+                a.xBegin = b.xBegin;
+            } else if (b.xBegin < a.xBegin) {
+                // a and b overlap, b starts first
+                extra2(Span{b.y, b.xBegin, a.xBegin});
+                b.xBegin = a.xBegin;
+            } else {
+                // a and b overlap and start at the same column
+                int xEnd = std::min(a.xEnd, b.xEnd);
+                match(Span{a.y, a.xBegin, xEnd});
+                a.xBegin = xEnd;
+                b.xBegin = xEnd;
+                if (a.xBegin == a.xEnd && ++i1 != i1e) a = *i1;
+                if (b.xBegin == b.xEnd && ++i2 != i2e) b = *i2;
+            }
+        }
+
+        if (i1 != i1e) {
+            extra1(a);
+            while (++i1 != i1e) extra1(*i1);
+        }
+
+        if (i2 != i2e) {
+            extra2(b);
+            while (++i2 != i2e) extra2(*i2);
+        }
+    }
+
+    /// Calculates the intersection-over-union of two span sets. Assumes that both span sets meet
+    /// the invariants of SpanSet. Returns zero if both sets are empty.
+    inline double spanSetIou(const SpanSet& s1, const SpanSet& s2) {
+        int intersection = 0;
+        int union_ = 0;
+        auto mismatch = [&](const Span& s) { union_ += s.size(); };
+        auto match = [&](const Span& s) {
+            intersection += s.size();
+            union_ += s.size();
+        };
+        spanSetCompare(s1, s2, mismatch, mismatch, match);
+        if (union_ == 0) return 0.;
+        return double(intersection) / double(union_);
+    }
+
+    /// Merge spans in the input vector into a single span set.
+    template <typename Iterator>
+    inline void spanSetMerge(Iterator first, Iterator last, SpanSet& out) {
+        out.clear();
+        for (Iterator i = first; i != last; i++) { out.insert(end(out), begin(*i), end(*i)); }
+        spanSetNormalize(out);
+    }
 }
 
 #endif
@@ -18,7 +18,7 @@ namespace fmo {
     /// Converts the image "src" to a given color format and saves the result to "dst". One could
     /// pass the same object as both "src" and "dst", but doing so is ineffective, unless the
     /// conversion is YUV420SP to GRAY. Only some conversions are supported, namely: GRAY to BGR,
-    /// BGR to GRAY, YUV420SP to BGR, YUV420SP to GRAY.
+    /// BGR to GRAY, YUV420SP to BGR, YUV420SP to GRAY, and YUYV, UYVY or P010 to BGR or GRAY.
     void convert(const Mat& src, Mat& dst, Format format);
 
     /// Selects pixels that have a value less than the specified value; these are set to 0xFF while
@@ -36,6 +36,12 @@ namespace fmo {
     /// Resizes an image so that each dimension is divided by two.
     void subsample(const Mat& src, Mat& dst);
 
+    /// Resizes an image so that each dimension is divided by two and converts it to a given color
+    /// format in a single pass, so that only the pixels of the output are converted. Supported
+    /// conversions are BGR, YUYV, UYVY or P010 to GRAY or YUV, and YUV420SP to GRAY; if "format"
+    /// is the source format, this is the same as subsample(src, dst).
+    void subsample(const Mat& src, Mat& dst, Format format);
+
     /// Calculates the per-pixel median of three images.
     void median3(const Image& src1, const Image& src2, const Image& src3, Image& dst);
 }
@@ -0,0 +1,155 @@
+#ifndef FMO_PROFILER_HPP
+#define FMO_PROFILER_HPP
+
+#include <fmo/allocator.hpp>
+#include <fmo/perfcounters.hpp>
+#include <fmo/stats.hpp>
+#include <fmo/trace.hpp>
+#include <initializer_list>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fmo {
+    /// Measures the duration of the individual stages of a procedure that is executed repeatedly,
+    /// such as the processing of a single frame. The stages are named using setStages() and they
+    /// must be executed in the same order every time. The profiler is disabled by default; while
+    /// disabled, the start(), lap() and stop() methods only test a flag. Regardless of whether the
+    /// profiler is enabled, each stage is recorded as a span while Trace is enabled.
+    struct Profiler {
+        /// Quantiles are updated after this many samples.
+        static constexpr int SORT_PERIOD = 100;
+        /// The number of initial samples that are ignored.
+        static constexpr int WARM_UP = 10;
+
+        Profiler();
+        Profiler(const Profiler&) = delete;
+        Profiler& operator=(const Profiler&) = delete;
+
+        /// Specifies stage names, in the order of execution. Removes all measurements. The names
+        /// must have static storage duration, so that they can be used in trace spans.
+        void setStages(std::initializer_list<const char*> names);
+
+        /// Enables or disables the measurements.
+        void enable(bool enabled) { mEnabled = enabled; }
+
+        /// Checks whether measurements are enabled.
+        bool enabled() const { return mEnabled; }
+
+        /// Enables or disables reading hardware performance counters at the stage boundaries while
+        /// measurements are enabled. The counters only cover the thread that calls start(). See
+        /// PerfCounters.
+        ///
+        /// @return True if at least one counter is available. Otherwise, counters stay disabled.
+        bool enableCounters(bool enabled);
+
+        /// Enables or disables keeping the duration of each stage of the last procedure, which is
+        /// cheaper than measuring quantiles. See lastNs().
+        void setRecording(bool recording) { mRecording = recording; }
+
+        /// To be called at the beginning of the procedure, before the first stage starts.
+        void start() {
+            // whether the stages are measured or traced is decided once per procedure
+            mActive = mEnabled | mRecording | Trace::enabled();
+            if (mActive) startImpl();
+        }
+
+        /// To be called as soon as a stage ends. The next stage is assumed to start immediately.
+        void lap() {
+            if (mActive) lapImpl();
+        }
+
+        /// To be called at the end of the procedure, after the last stage ends.
+        void stop() {
+            if (mActive) stopImpl();
+        }
+
+        /// Provides the number of stages.
+        int numStages() const { return int(mStages.size()); }
+
+        /// Provides the name of a stage.
+        const std::string& stageName(int stage) const { return mStages[stage]->name; }
+
+        /// Provides duration quantiles of a given stage in milliseconds. The quantiles are zero
+        /// until SORT_PERIOD samples have been collected.
+        const Quantiles<float>& quantilesMs(int stage) const { return mStages[stage]->quantiles; }
+
+        /// Provides duration quantiles of the whole procedure in milliseconds.
+        const Quantiles<float>& totalQuantilesMs() const { return mTotal.quantiles; }
+
+        /// Provides the duration of a stage in the last procedure in nanoseconds. Updated while
+        /// measurements, recording or tracing are enabled.
+        int64_t lastNs(int stage) const { return mStages[stage]->lastNs; }
+
+        /// Provides the duration of the whole last procedure in nanoseconds.
+        int64_t totalLastNs() const { return mTotal.lastNs; }
+
+        /// Provides the heap allocations made during a stage of the last procedure, in all
+        /// threads. Updated like lastNs(). Includes calls to operator new only if the program
+        /// counts them, see heapAllocations().
+        const AllocCounts& lastAllocs(int stage) const { return mStages[stage]->lastAllocs; }
+
+        /// Provides the heap allocations made during the whole last procedure.
+        const AllocCounts& totalLastAllocs() const { return mTotal.lastAllocs; }
+
+        /// Provides the sums of the performance counters of a stage over all measured procedures.
+        const PerfCounters::Values& counterSums(int stage) const {
+            return mStages[stage]->counterSums;
+        }
+
+        /// Provides the number of procedures that the sums of performance counters cover.
+        int64_t numCounted() const { return mTotal.numCounted; }
+
+        /// Writes a table with the q50, q95 and q99 duration of each stage. Unlike quantilesMs(),
+        /// which favors recent samples, the quantiles cover all samples taken after the warm-up
+        /// with equal weight, so that the table summarizes the whole run.
+        /// If counters are enabled, the mean number of cycles, instructions per cycle and
+        /// last-level cache misses are added.
+        void print(std::ostream& out) const;
+
+    private:
+        struct Stage {
+            Stage(const char* aName);
+
+            /// Adds a new sample, updates quantiles if necessary.
+            void add(int64_t startNs, int64_t endNs, bool measure);
+
+            const char* cName;
+            std::string name;
+            Stats stats;
+            Histogram overall;      ///< every sample after the warm-up, never decayed
+            int64_t numSamples = 0; ///< number of samples including the warm-up
+            Quantiles<float> quantiles;
+            int64_t lastNs = 0;
+            AllocCounts lastAllocs;
+            PerfCounters::Values counterSums{};
+            int64_t numCounted = 0;
+
+            /// Adds the difference of two counter readings.
+            void count(const PerfCounters::Values& start, const PerfCounters::Values& end);
+        };
+
+        void startImpl();
+        void lapImpl();
+        void stopImpl();
+
+        // data
+        bool mEnabled = false;
+        bool mRecording = false;
+        bool mActive = false;
+        int mNextStage = 0;
+        int64_t mStartNs = 0;
+        int64_t mLastNs = 0;
+        AllocCounts mStartAllocs;
+        AllocCounts mLastAllocs;
+        std::unique_ptr<PerfCounters> mCounters;
+        PerfCounters::Values mStartCounts{};
+        PerfCounters::Values mLastCounts{};
+        PerfCounters::Values mCounts{};
+        std::vector<std::unique_ptr<Stage>> mStages;
+        Stage mTotal;
+    };
+}
+
+#endif // FMO_PROFILER_HPP
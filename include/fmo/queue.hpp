@@ -0,0 +1,166 @@
+#ifndef FMO_QUEUE_HPP
+#define FMO_QUEUE_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <fmo/stats.hpp>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace fmo {
+    /// Determines what happens when a payload is sent to a full queue.
+    enum class QueuePolicy {
+        BLOCK,          ///< the producer waits until there is space
+        DROP_OLDEST,    ///< the oldest queued payload is discarded to make space
+        DROP_NEWEST,    ///< the sent payload is discarded
+        KEEP_EVERY_KTH, ///< every k-th payload replaces the oldest one, the rest are discarded
+    };
+
+    /// Configuration of a queue.
+    struct QueueConfig {
+        int capacity = 2;                             ///< maximum number of queued payloads
+        QueuePolicy policy = QueuePolicy::DROP_OLDEST; ///< behavior when the queue is full
+        int keepPeriod = 2; ///< k in QueuePolicy::KEEP_EVERY_KTH, counted while the queue is full
+    };
+
+    /// Counters describing the traffic in a queue.
+    struct QueueStats {
+        int64_t enqueued = 0; ///< number of payloads that entered the queue
+        int64_t dropped = 0;  ///< number of payloads that were discarded, sent or queued
+        int maxDepth = 0;     ///< maximum number of payloads queued at once
+    };
+
+    /// Passes data in a multi-threaded scenario from a producer to one or more consumers. Unlike
+    /// Exchange, up to QueueConfig::capacity payloads are kept in order and the behavior of a full
+    /// queue is selected by QueueConfig::policy. All slots are allocated in the constructor and
+    /// data is passed by swapping, so no allocations take place afterwards. It is assumed that the
+    /// payload is cheap to swap.
+    template <typename T>
+    struct Queue {
+        Queue(const Queue&) = delete;
+        Queue& operator=(const Queue&) = delete;
+
+        /// Create a new queue. The payload in each slot is constructed using the remaining
+        /// constructor arguments.
+        template <typename... Args>
+        Queue(const QueueConfig& cfg, const Args&... args) : mCfg(cfg) {
+            if (mCfg.capacity < 1 || mCfg.keepPeriod < 1) {
+                throw std::runtime_error("Queue: bad config");
+            }
+            mSlots.reserve(mCfg.capacity);
+            for (int i = 0; i < mCfg.capacity; i++) { mSlots.emplace_back(args...); }
+        }
+
+        /// Sends new data to the consumers. Data is stored by swapping, the payload is left with
+        /// the contents of a free slot. If the queue is full, the configured policy is applied.
+        ///
+        /// @return True if the payload has been queued, false if it has been discarded or the
+        /// exit() method has been called.
+        bool swapSend(T& payload) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            if (mExit) return false;
+
+            if (mSize != mCfg.capacity) {
+                mNumWhileFull = 0;
+            } else {
+                switch (mCfg.policy) {
+                case QueuePolicy::BLOCK:
+                    mWait.wait(lock, [this]() { return mSize != mCfg.capacity || mExit; });
+                    if (mExit) return false;
+                    break;
+                case QueuePolicy::DROP_OLDEST:
+                    popFront();
+                    mStats.dropped++;
+                    break;
+                case QueuePolicy::DROP_NEWEST:
+                    mStats.dropped++;
+                    return false;
+                case QueuePolicy::KEEP_EVERY_KTH:
+                    mStats.dropped++;
+                    if (++mNumWhileFull % mCfg.keepPeriod != 0) return false;
+                    popFront();
+                    break;
+                }
+            }
+
+            Slot& slot = mSlots[(mHead + mSize) % mCfg.capacity];
+            using std::swap;
+            swap(slot.payload, payload);
+            slot.enqueueNs = nanoTime();
+            mSize++;
+            mStats.enqueued++;
+            mStats.maxDepth = std::max(mStats.maxDepth, mSize);
+            mWait.notify_all();
+            return true;
+        }
+
+        /// Get the oldest queued payload. If the queue is empty, the method will block until
+        /// there's new data or the exit() method is called. Data is received by swapping. After
+        /// exit() has been called, the remaining payloads can still be received.
+        ///
+        /// @param enqueueNs If not null, receives the time at which the payload entered the queue,
+        /// as returned by nanoTime(). Used to measure queueing latency.
+        /// @return True if a payload has been received, false if the queue is empty and exit() has
+        /// been called.
+        bool swapReceive(T& payload, int64_t* enqueueNs = nullptr) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWait.wait(lock, [this]() { return mSize != 0 || mExit; });
+            if (mSize == 0) return false;
+
+            Slot& slot = mSlots[mHead];
+            using std::swap;
+            swap(slot.payload, payload);
+            if (enqueueNs != nullptr) *enqueueNs = slot.enqueueNs;
+            popFront();
+            mWait.notify_all();
+            return true;
+        }
+
+        /// Set the internal exit flag and wake up all waiting threads.
+        void exit() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mExit = true;
+            mWait.notify_all();
+        }
+
+        /// Provides the number of payloads currently in the queue.
+        int depth() const {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mSize;
+        }
+
+        /// Provides the traffic counters.
+        QueueStats stats() const {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mStats;
+        }
+
+    private:
+        struct Slot {
+            template <typename... Args>
+            Slot(const Args&... args) : payload(args...) {}
+
+            T payload;
+            int64_t enqueueNs = 0;
+        };
+
+        void popFront() {
+            mHead = (mHead + 1) % mCfg.capacity;
+            mSize--;
+        }
+
+        const QueueConfig mCfg;
+        std::vector<Slot> mSlots;
+        mutable std::mutex mMutex;
+        std::condition_variable mWait;
+        QueueStats mStats;
+        int mHead = 0;
+        int mSize = 0;
+        int mNumWhileFull = 0;
+        bool mExit = false;
+    };
+}
+
+#endif // FMO_QUEUE_HPP
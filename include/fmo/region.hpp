@@ -26,10 +26,12 @@ namespace fmo {
         /// Provides access to image data.
         virtual const uint8_t* data() const override { return mData; }
 
-        /// Provides access to the part of image data where UVis stored. Only for YUV420SP images.
+        /// Provides access to the part of image data where UVis stored. Only for YUV420SP and P010
+        /// images.
         virtual uint8_t* uvData() override { return mUvData; }
 
-        /// Provides access to the part of image data where UVis stored. Only for YUV420SP images.
+        /// Provides access to the part of image data where UVis stored. Only for YUV420SP and P010
+        /// images.
         virtual const uint8_t* uvData() const override { return mUvData; }
 
         /// Resizes the region to match the desired format and dimensions. A region cannot mustn't
@@ -0,0 +1,100 @@
+#ifndef FMO_SCENE_HPP
+#define FMO_SCENE_HPP
+
+#include <array>
+#include <fmo/common.hpp>
+#include <fmo/image.hpp>
+#include <fmo/pointset.hpp>
+#include <iosfwd>
+#include <vector>
+
+namespace fmo {
+
+    /// Renders a synthetic video of fast-moving objects, together with the ground truth. The
+    /// background is a static random texture, the objects are discs that move along straight lines
+    /// and bounce off the edges of the image. Each object is blurred along the path it travels
+    /// while the shutter is open. The output is reproducible: the same configuration always yields
+    /// the same frames.
+    struct SceneGenerator {
+        /// A disc moving at a constant speed.
+        struct Object {
+            float x;                    ///< initial position of the center, in pixels
+            float y;                    ///< initial position of the center, in pixels
+            float speed;                ///< distance traveled in one frame, in pixels
+            float direction;            ///< direction of motion, in radians
+            float radius;               ///< radius of the disc, in pixels
+            std::array<uint8_t, 3> bgr; ///< color of the disc
+        };
+
+        struct Config {
+            /// Dimensions of the rendered frames.
+            Dims dims;
+            /// Format of the rendered frames. Any format except INT32 is supported.
+            Format format;
+            /// Number of randomly placed objects, used if the list of objects is empty.
+            int numObjects;
+            /// Range of the speed of the random objects, in pixels per frame.
+            float minSpeed;
+            float maxSpeed;
+            /// Range of the radius of the random objects, in pixels.
+            float minRadius;
+            float maxRadius;
+            /// Amplitude of the background texture, from 0 (flat) to 127.
+            float texture;
+            /// Standard deviation of the camera noise added to each sample, in levels.
+            float noise;
+            /// Fraction of the frame time during which the shutter is open. Determines the length
+            /// of the motion blur.
+            float exposure;
+            /// Seed of the random number generator.
+            uint32_t seed;
+            /// Objects to render. If empty, numObjects random objects are generated.
+            std::vector<Object> objects;
+
+            Config();
+        };
+
+        SceneGenerator(const Config& config);
+
+        /// Renders the next frame into the output image. The ground truth is returned as one span
+        /// set per object, covering the pixels that the object touches during the exposure.
+        void next(Image& out, std::vector<SpanSet>& truth);
+
+        /// Advances to the next frame, providing the ground truth but skipping the rendering.
+        void next(std::vector<SpanSet>& truth);
+
+        /// Provides the number of frames generated so far.
+        int frameNum() const { return mFrameNum; }
+
+        /// Provides the configuration, received upon construction.
+        const Config& config() const { return mCfg; }
+
+        /// Provides the objects, along with their current positions and directions.
+        const std::vector<Object>& objects() const { return mObjects; }
+
+    private:
+        void step(Image* out, std::vector<SpanSet>& truth);
+        void renderObject(const Object& obj, SpanSet& truth, bool render);
+        void addNoise();
+        void encode(Image& out) const;
+
+        // data
+        const Config mCfg;               ///< configuration object, received upon construction
+        std::vector<Object> mObjects;    ///< objects at the start of the current frame
+        Image mBackground;               ///< static BGR background
+        Image mFrame;                    ///< BGR frame being rendered
+        std::vector<int8_t> mNoiseTable; ///< samples of the camera noise
+        uint32_t mState;                 ///< state of the random number generator
+        int mFrameNum = 0;               ///< number of frames generated so far
+    };
+
+    /// Writes the ground truth of a sequence in the run-length encoded text format read by the
+    /// desktop application: the image dimensions, the number of frames, a frame offset of zero and
+    /// the number of objects, followed by a line per object. Each line starts with a one-based
+    /// frame number and the number of runs; the runs alternate between background and object
+    /// pixels, in row-major order, starting with the background.
+    void writeGroundTruth(std::ostream& out, Dims dims,
+                          const std::vector<std::vector<SpanSet>>& frames);
+}
+
+#endif // FMO_SCENE_HPP
@@ -76,11 +76,94 @@ namespace fmo {
         T q50, q95, q99;
     };
 
+    /**
+     * A fixed-memory histogram of non-negative 64-bit integers, such as durations in nanoseconds,
+     * with logarithmically spaced buckets. Values below SUB_COUNT are counted exactly; larger
+     * values share a bucket with values that differ by less than 1 / HALF_COUNT (about 1.6%),
+     * and values of MAX_VALUE and above share the last bucket. Adding a value takes constant time
+     * and never allocates memory. Quantile queries scan the buckets between the smallest and the
+     * largest value. Histograms filled in different threads can be combined using merge(); the
+     * calls themselves are not synchronized.
+     */
+    struct Histogram {
+        static constexpr int SUB_BITS = 7;
+        static constexpr int MAX_BITS = 40;
+        static constexpr int SUB_COUNT = 1 << SUB_BITS;
+        static constexpr int HALF_COUNT = SUB_COUNT / 2;
+        static constexpr int NUM_BUCKETS = SUB_COUNT + (MAX_BITS - SUB_BITS) * HALF_COUNT;
+        static constexpr int64_t MAX_VALUE = int64_t(1) << MAX_BITS;
+
+        Histogram();
+
+        /**
+         * Removes all samples.
+         */
+        void clear();
+
+        /**
+         * Counts a sample. Negative values are counted as zero, but they do affect min() and
+         * mean().
+         */
+        void add(int64_t val);
+
+        /**
+         * Adds all samples of another histogram to this one.
+         */
+        void merge(const Histogram& other);
+
+        /**
+         * Halves the count in each bucket, so that older samples gradually lose influence. The
+         * minimum, maximum and mean are adjusted to the remaining samples approximately.
+         */
+        void decay();
+
+        /**
+         * @return The number of samples.
+         */
+        uint64_t count() const { return mCount; }
+
+        /**
+         * @return The smallest sample, or zero if there are no samples.
+         */
+        int64_t min() const { return (mCount == 0) ? 0 : mMin; }
+
+        /**
+         * @return The largest sample, or zero if there are no samples.
+         */
+        int64_t max() const { return (mCount == 0) ? 0 : mMax; }
+
+        /**
+         * @return The arithmetic mean of the samples, or zero if there are no samples.
+         */
+        double mean() const { return (mCount == 0) ? 0. : mSum / double(mCount); }
+
+        /**
+         * @param q Quantile to find, between 0 and 1.
+         * @return A value from the bucket that holds the q-quantile, or zero if there are no
+         * samples. The value never lies outside the range of min() and max().
+         */
+        int64_t quantile(double q) const;
+
+    private:
+        static int index(int64_t val);
+        static int64_t lowerBound(int index);
+        static int64_t upperBound(int index);
+
+        std::vector<uint64_t> mCounts;
+        uint64_t mCount;
+        double mSum;
+        int64_t mMin;
+        int64_t mMax;
+        int mLowIndex;  ///< the lowest non-empty bucket
+        int mHighIndex; ///< the highest non-empty bucket
+    };
+
     /**
      * Provides robust statistic measurements of fuzzy quantities, such as execution time. The data
      * type of the measurements is fixed to 64-bit signed integer. Use the add() method to add new
-     * samples. The add() method may trigger calculation of quantiles, which are afterwards
-     * retrievable using the quantiles() method.
+     * samples. The add() method periodically updates the quantiles, which are afterwards
+     * retrievable using the quantiles() method. Samples are counted in a Histogram, which is
+     * decayed so that it represents roughly the last 2 * sortPeriod samples.
      */
     struct Stats {
         static constexpr int DEFAULT_SORT_PERIOD = 1000;
@@ -92,8 +175,8 @@ namespace fmo {
 
         /**
          * @param sortPeriod The calculation of quantiles is triggered periodically, after
-         * sortPeriod samples are added. A maximum of 2 * sortPeriod samples will be retained over
-         * time.
+         * sortPeriod samples are added. Samples older than about 2 * sortPeriod samples lose their
+         * influence over time.
          * @param warmUpFrames The number of initial samples that will be ignored.
          */
         Stats(int sortPeriod = DEFAULT_SORT_PERIOD, int warmUp = DEFAULT_WARM_UP);
@@ -106,8 +189,8 @@ namespace fmo {
         void reset(int64_t defVal);
 
         /**
-         * Inserts a sample to an internal vector. Each time sortPeriod (see constructor) samples
-         * are added, new quantiles are calculated. This can be detected using the return value of
+         * Counts a sample in the histogram. Each time sortPeriod (see constructor) samples are
+         * added, new quantiles are calculated. This can be detected using the return value of
          * this method.
          *
          * @return True if the quantiles have just been updated. Use the quantiles() method to
@@ -121,18 +204,18 @@ namespace fmo {
          */
         const Quantiles<int64_t>& quantiles() const { return mQuantiles; }
 
-    private:
         /**
-         * Discard half of the elements in the underlying sorted or partially sorted vector so that
-         * the statistics are not affected.
+         * @return The histogram of recent samples, for arbitrary quantiles, the minimum, the
+         * maximum, the mean, or for merging with other histograms.
          */
-        void subsample();
+        const Histogram& histogram() const { return mHistogram; }
 
-        const int mStorageSize;
+    private:
         const int mSortPeriod;
         const int mWarmUpFrames;
-        std::vector<int64_t> mVec;
         int mWarmUpCounter;
+        int mSinceUpdate;
+        Histogram mHistogram;
         Quantiles<int64_t> mQuantiles;
     };
 
@@ -164,6 +247,11 @@ namespace fmo {
          */
         const Quantiles<float>& quantilesHz() const { return mQuantilesHz; }
 
+        /**
+         * @return The histogram of recent frame times in nanoseconds.
+         */
+        const Histogram& histogram() const { return mStats.histogram(); }
+
     private:
         void updateMyQuantiles();
 
@@ -205,6 +293,11 @@ namespace fmo {
          */
         const Quantiles<float>& quantilesMs() const { return mQuantilesMs; }
 
+        /**
+         * @return The histogram of recent execution times in nanoseconds.
+         */
+        const Histogram& histogram() const { return mStats.histogram(); }
+
     private:
         void updateMyQuantiles();
 
@@ -212,6 +305,17 @@ namespace fmo {
         int64_t mStartTimeNs;
         Quantiles<float> mQuantilesMs;
     };
+
+    /**
+     * Performs the two-sided Mann-Whitney U test (Wilcoxon rank-sum test), which makes no
+     * assumption about the shape of the distributions and is insensitive to outliers. The normal
+     * approximation with a correction for ties is used, so each set should hold at least about 20
+     * samples.
+     *
+     * @return The probability that samples as different as "a" and "b" would be drawn from a
+     * single distribution. One if either set is empty.
+     */
+    double mannWhitneyP(const std::vector<int64_t>& a, const std::vector<int64_t>& b);
 }
 
 #endif // FMO_STATS_HPP
@@ -35,7 +35,8 @@ namespace fmo {
 
     /// Detects vertical strips by iterating over all pixels in a binary image. Strip is a non-empty
     /// image region with a width of 1 pixel in the processing resolution. In the original
-    /// resolution, strips are wider.
+    /// resolution, strips are wider. The image may have any width, but its rows must be padded to
+    /// a multiple of 8 bytes; the content of the padding is ignored.
     struct StripGen {
         /// Detects vertical strips in the binary image img. Strips shorter than minHeight will be
         /// discarded as noise. The vertical gap between two strips (that are not considered noise)
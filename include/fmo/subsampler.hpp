@@ -3,15 +3,24 @@
 
 #include <fmo/common.hpp>
 #include <fmo/image.hpp>
+#include <fmo/imagepool.hpp>
+#include <vector>
 
 namespace fmo {
-    /// Similar to subsample(), but also allows to subsample YUV420SP images, in which case an YUV
-    /// image is created.
+    /// Similar to subsample(), but also allows to subsample YUV420SP, YUYV, UYVY and P010 images,
+    /// in which case an YUV image is created.
     struct Subsampler {
+        /// @param pool If not null, scratch images are obtained from this pool.
+        Subsampler(ImagePool* pool = nullptr) : mPool(pool) {}
+
         /// Performs decimation, as when subsample() is called, but with additional support for
-        /// YUV420SP inputs.
+        /// YUV420SP, YUYV, UYVY and P010 inputs.
         void operator()(const Mat& src, Mat& dst);
 
+        /// Performs decimation and converts the result to "format" in the same pass, see
+        /// subsample(src, dst, format). Format::UNKNOWN keeps the format chosen by nextFormat().
+        void operator()(const Mat& src, Mat& dst, Format format);
+
         /// Provides the dimensions of the output, given that the decimation input has dimensions
         /// "dims".
         Dims nextDims(Dims dims);
@@ -19,12 +28,32 @@ namespace fmo {
         /// Provides the format of the output, given that the decimation input has format "before".
         Format nextFormat(Format before);
 
+        /// Provides the format of the output, given that the decimation input has format "before"
+        /// and that conversion to "requested" has been asked for, see Format::UNKNOWN.
+        Format nextFormat(Format before, Format requested) {
+            return (requested == Format::UNKNOWN) ? nextFormat(before) : requested;
+        }
+
         /// Provides the pixel size in the output, given that the decimation input has pixel size
         /// "before".
         int nextPixelSize(int before) { return before * 2; }
 
+        /// Decimates the image "levels" times, producing the same result as repeated calls to
+        /// operator(), the first of which converts to "format". The image is processed in
+        /// horizontal bands of "bandRows" output rows, so that only a band of each intermediate
+        /// level is ever held in memory. If a pool has been provided, the output is obtained from
+        /// it.
+        void decimate(const Mat& src, Image& dst, int levels, Format format, int bandRows = 8);
+
+        /// Provides the number of bytes held by scratch images.
+        size_t memoryUsage() const;
+
     private:
+        void prepare(Image& image, Dims dims);
+
+        ImagePool* mPool;
         Image y, u, v;
+        std::vector<Image> mBands; ///< scratch images for the intermediate levels of decimate()
     };
 }
 
@@ -0,0 +1,66 @@
+#ifndef FMO_TRACE_HPP
+#define FMO_TRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <fmo/stats.hpp>
+#include <iosfwd>
+
+namespace fmo {
+    /// Collects a timeline of named time intervals (spans), to be viewed in a trace viewer such as
+    /// chrome://tracing. Each thread writes to its own ring buffer of CAPACITY events, without
+    /// locking; when a buffer is full, the oldest events are overwritten. A thread allocates its
+    /// buffer when it records its first event. Tracing is disabled by default, in which case
+    /// spans only test a flag.
+    struct Trace {
+        /// Number of events retained per thread.
+        static constexpr size_t CAPACITY = 1 << 14;
+
+        /// Enables or disables the recording of spans.
+        static void enable(bool enabled);
+
+        /// Checks whether spans are being recorded.
+        static bool enabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+        /// Adds a span to the buffer of the calling thread. The name must be a string with static
+        /// storage duration, e.g. a string literal.
+        static void record(const char* name, int64_t startNs, int64_t endNs);
+
+        /// Provides the total number of retained events.
+        static size_t numEvents();
+
+        /// Removes all events. Must not be called while other threads record spans.
+        static void clear();
+
+        /// Writes all retained events in the Chrome trace-event JSON format. Should not be called
+        /// while other threads record spans, otherwise some of the events may be inconsistent.
+        static void writeJson(std::ostream& out);
+
+    private:
+        static std::atomic<bool> sEnabled;
+    };
+
+    /// Records the lifetime of the object as a span, if tracing is enabled during construction.
+    struct TraceSpan {
+        /// @param name A string with static storage duration, e.g. a string literal.
+        TraceSpan(const char* name) {
+            if (Trace::enabled()) {
+                mName = name;
+                mStartNs = nanoTime();
+            }
+        }
+
+        ~TraceSpan() {
+            if (mName != nullptr) Trace::record(mName, mStartNs, nanoTime());
+        }
+
+        TraceSpan(const TraceSpan&) = delete;
+        TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+        const char* mName = nullptr;
+        int64_t mStartNs = 0;
+    };
+}
+
+#endif // FMO_TRACE_HPP
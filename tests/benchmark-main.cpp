@@ -1,7 +1,362 @@
+#include <opencv2/core/version.hpp>
+
+#if CV_MAJOR_VERSION == 2
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#elif CV_MAJOR_VERSION == 3
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fmo/allocator.hpp>
 #include <fmo/benchmark.hpp>
+#include <fmo/processing.hpp>
+#include <fmo/region.hpp>
+#include <fmo/scene.hpp>
+#include <fmo/trace.hpp>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    void printUsage(const char* name) {
+        std::cerr
+            << "usage: " << name << " [options]\n"
+            << "  --filter <names>      comma-separated substrings of benchmark names to run\n"
+            << "  --list                list benchmarks and the parameters they depend on\n"
+            << "  --repeat <n>          repeat each measurement n times\n"
+            << "  --warm-up <n>         number of unmeasured calls before each measurement\n"
+            << "  --samples <n>         number of measured calls, or frames with --algorithms\n"
+            << "  --max-seconds <s>     measured time after which sampling stops, default: 10\n"
+            << "  --cpu <n>             pin the benchmark thread to CPU n\n"
+            << "  --resolutions <list>  input resolutions: vga, hd, fullhd, 4k or WxH\n"
+            << "  --formats <list>      input formats, e.g. GRAY,BGR,YUV420SP\n"
+            << "  --heights <list>      processing heights of algorithms\n"
+            << "  --threads <list>      numbers of OpenCV threads, 0 keeps the default\n"
+            << "  --counts <list>       input sizes of benchmarks that measure scaling\n"
+            << "  --json <file>         write results in the JSON format\n"
+            << "  --csv <file>          write results in the CSV format\n"
+            << "  --trace <file>        write a timeline in the Chrome trace-event format\n"
+            << "  --algorithms          run all algorithms over a clip or generated scene\n"
+            << "  --clip <file>         video file for --algorithms\n"
+            << "  --clip-frames <n>     number of frames decoded or generated, default: 60\n"
+            << "  --scene-objects <n>   number of objects in the generated scene, default: 1\n"
+            << "  --save <file>         save results as a baseline for --baseline\n"
+            << "  --baseline <file>     compare with a saved baseline, failing on regressions or\n"
+            << "                        benchmarks missing from the results\n"
+            << "  --threshold <pct>     smallest change of the median to report, default: 5\n"
+            << "  --alpha <p>           significance level of the comparison, default: 0.01\n";
+    }
+
+    std::vector<std::string> split(const std::string& list) {
+        std::vector<std::string> result;
+        std::istringstream in{list};
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            if (!item.empty()) result.push_back(item);
+        }
+        return result;
+    }
+
+    int toInt(const std::string& str) {
+        char* end;
+        long value = std::strtol(str.c_str(), &end, 10);
+        if (str.empty() || *end != '\0') throw std::runtime_error("bad number: " + str);
+        return int(value);
+    }
+
+    fmo::Dims toDims(const std::string& str) {
+        if (str == "vga") return {640, 480};
+        if (str == "hd") return {1280, 720};
+        if (str == "fullhd") return {1920, 1080};
+        if (str == "4k") return {3840, 2160};
+        auto x = str.find('x');
+        if (x == std::string::npos) throw std::runtime_error("bad resolution: " + str);
+        return {toInt(str.substr(0, x)), toInt(str.substr(x + 1))};
+    }
+
+    fmo::Format toFormat(const std::string& str) {
+        fmo::Format format = fmo::formatFromName(str.c_str());
+        if (format == fmo::Format::UNKNOWN) throw std::runtime_error("bad format: " + str);
+        return format;
+    }
+
+    template <typename T, typename Func>
+    std::vector<T> parseList(const std::string& list, Func func) {
+        std::vector<T> result;
+        for (auto& item : split(list)) { result.push_back(func(item)); }
+        return result;
+    }
+
+    double toDouble(const std::string& str) {
+        char* end;
+        double value = std::strtod(str.c_str(), &end);
+        if (str.empty() || *end != '\0') throw std::runtime_error("bad number: " + str);
+        return value;
+    }
+
+    /// Prints the comparison with a baseline. Returns true if any benchmark has regressed or is
+    /// missing from the new results.
+    bool printComparison(const std::vector<fmo::BenchComparison>& comparisons) {
+        int numRegressions = 0;
+        int numMissing = 0;
+        std::cout << "Comparison with baseline (median ms, change, p-value):\n";
+        for (auto& c : comparisons) {
+            char buf[64];
+            const char* verdict = "";
+            switch (c.verdict) {
+            case fmo::BenchComparison::REGRESSION:
+                verdict = "  REGRESSION";
+                numRegressions++;
+                break;
+            case fmo::BenchComparison::IMPROVEMENT:
+                verdict = "  improvement";
+                break;
+            case fmo::BenchComparison::NEW:
+                std::snprintf(buf, sizeof(buf), "%.3f (not in baseline)", c.q50Ms);
+                std::cout << c.label << ": " << buf << '\n';
+                continue;
+            case fmo::BenchComparison::MISSING:
+                std::snprintf(buf, sizeof(buf), "%.3f -> not measured", c.baseQ50Ms);
+                std::cout << c.label << ": " << buf << "  MISSING\n";
+                numMissing++;
+                continue;
+            default:
+                break;
+            }
+
+            std::snprintf(buf, sizeof(buf), "%.3f -> %.3f (%+.1f %%, p = %.2g)", c.baseQ50Ms,
+                          c.q50Ms, 100. * c.change, c.pValue);
+            std::cout << c.label << ": " << buf << verdict << '\n';
+        }
+
+        std::cout << numRegressions << " regression(s) found.\n";
+        if (numMissing > 0) std::cout << numMissing << " benchmark(s) missing.\n";
+        return numRegressions > 0 || numMissing > 0;
+    }
+
+    /// Decodes at most maxFrames frames of a video file.
+    std::vector<fmo::Image> loadClip(const std::string& path, int maxFrames) {
+        cv::VideoCapture cap{path};
+        if (!cap.isOpened()) throw std::runtime_error("failed to open video " + path);
+
+        std::vector<fmo::Image> frames;
+        cv::Mat mat;
+        while (int(frames.size()) < maxFrames && cap.read(mat) && !mat.empty()) {
+            if (mat.type() != CV_8UC3) throw std::runtime_error("unsupported video format");
+            fmo::Dims dims{mat.cols, mat.rows};
+            fmo::Region region{fmo::Format::BGR, {0, 0}, dims, mat.data, nullptr, mat.step};
+            frames.emplace_back();
+            fmo::copy(region, frames.back());
+        }
+        return frames;
+    }
+
+    /// Renders a synthetic scene with fast-moving objects.
+    std::vector<fmo::Image> makeScene(int numObjects, int numFrames) {
+        fmo::SceneGenerator::Config config;
+        config.dims = {1920, 1080};
+        config.numObjects = numObjects;
+        fmo::SceneGenerator generator{config};
+        std::vector<fmo::SpanSet> truth;
+        std::vector<fmo::Image> frames;
+        frames.resize(size_t(numFrames));
+        for (auto& frame : frames) { generator.next(frame, truth); }
+        return frames;
+    }
+
+    template <typename Result>
+    void writeFile(const char* path,
+                   void (*func)(std::ostream&, const std::vector<Result>&),
+                   const std::vector<Result>& results) {
+        std::ofstream out{path};
+        if (!out) throw std::runtime_error(std::string("failed to open ") + path);
+        func(out, results);
+    }
+}
+
+// count heap allocations, so that --algorithms reports them
+FMO_COUNT_ALLOCATIONS
+
+int main(int argc, char** argv) {
+    fmo::BenchOptions options;
+    const char* tracePath = nullptr;
+    const char* jsonPath = nullptr;
+    const char* csvPath = nullptr;
+    const char* savePath = nullptr;
+    const char* baselinePath = nullptr;
+    double threshold = 0.05;
+    double alpha = 0.01;
+    const char* clipPath = nullptr;
+    int clipFrames = 60;
+    int sceneObjects = 1;
+    bool algorithms = false;
+    bool list = false;
+    bool haveSamples = false;
+    bool haveResolutions = false;
+    bool haveFormats = false;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--list" || arg == "--algorithms") {
+                list = list || arg == "--list";
+                algorithms = algorithms || arg == "--algorithms";
+                continue;
+            }
+            if (i + 1 >= argc) throw std::runtime_error("unknown option or missing value: " + arg);
+
+            std::string value = argv[++i];
+            if (arg == "--filter") {
+                options.filters = split(value);
+            } else if (arg == "--repeat") {
+                options.repetitions = toInt(value);
+            } else if (arg == "--warm-up") {
+                options.warmUp = toInt(value);
+            } else if (arg == "--samples") {
+                options.numSamples = toInt(value);
+                haveSamples = true;
+            } else if (arg == "--max-seconds") {
+                options.maxSeconds = toDouble(value);
+            } else if (arg == "--cpu") {
+                options.cpu = toInt(value);
+            } else if (arg == "--resolutions") {
+                options.resolutions = parseList<fmo::Dims>(value, toDims);
+                haveResolutions = true;
+            } else if (arg == "--formats") {
+                options.formats = parseList<fmo::Format>(value, toFormat);
+                haveFormats = true;
+            } else if (arg == "--heights") {
+                options.processingHeights = parseList<int>(value, toInt);
+            } else if (arg == "--threads") {
+                options.threads = parseList<int>(value, toInt);
+            } else if (arg == "--counts") {
+                options.counts = parseList<int>(value, toInt);
+            } else if (arg == "--json") {
+                jsonPath = argv[i];
+            } else if (arg == "--csv") {
+                csvPath = argv[i];
+            } else if (arg == "--trace") {
+                tracePath = argv[i];
+            } else if (arg == "--clip") {
+                clipPath = argv[i];
+            } else if (arg == "--clip-frames") {
+                clipFrames = toInt(value);
+            } else if (arg == "--scene-objects") {
+                sceneObjects = toInt(value);
+            } else if (arg == "--save") {
+                savePath = argv[i];
+            } else if (arg == "--baseline") {
+                baselinePath = argv[i];
+            } else if (arg == "--threshold") {
+                threshold = toDouble(value) / 100.;
+            } else if (arg == "--alpha") {
+                alpha = toDouble(value);
+            } else {
+                throw std::runtime_error("unknown option: " + arg);
+            }
+        }
+
+        if (options.repetitions < 1 || options.warmUp < 0 || options.numSamples < 1 ||
+            clipFrames < 1 || sceneObjects < 0) {
+            throw std::runtime_error("counts must be positive");
+        }
+        if (algorithms && (savePath != nullptr || baselinePath != nullptr)) {
+            throw std::runtime_error("--save and --baseline cannot be used with --algorithms");
+        }
+    } catch (std::exception& e) {
+        std::cerr << e.what() << '\n';
+        printUsage(argv[0]);
+        return -1;
+    }
+
+    auto log = [](const char* cStr) { std::cout << cStr; };
+    if (list) {
+        fmo::Registry::get().list(log);
+        return 0;
+    }
+
+    if (algorithms) {
+        fmo::AlgorithmBenchOptions algOptions;
+        algOptions.filters = options.filters;
+        algOptions.warmUp = options.warmUp;
+        if (haveSamples) algOptions.numFrames = options.numSamples;
+        if (haveResolutions) algOptions.resolutions = options.resolutions;
+        if (haveFormats) algOptions.formats = options.formats;
+
+        std::vector<fmo::Image> sequence;
+        try {
+            sequence = (clipPath != nullptr) ? loadClip(clipPath, clipFrames)
+                                             : makeScene(sceneObjects, clipFrames);
+        } catch (std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return -1;
+        }
+
+        fmo::Trace::enable(tracePath != nullptr);
+        std::vector<fmo::AlgorithmBenchResult> results;
+        bool finished =
+            fmo::benchmarkAlgorithms(sequence, algOptions, results, log, []() { return false; });
+
+        try {
+            if (jsonPath != nullptr) writeFile(jsonPath, fmo::writeJson, results);
+            if (csvPath != nullptr) writeFile(csvPath, fmo::writeCsv, results);
+            if (tracePath != nullptr) {
+                std::ofstream out{tracePath};
+                fmo::Trace::writeJson(out);
+            }
+        } catch (std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return -1;
+        }
+        return finished ? 0 : 1;
+    }
+
+    // load the baseline before running, so that a bad file is reported early
+    std::vector<fmo::BenchResult> baseline;
+    if (baselinePath != nullptr) {
+        try {
+            std::ifstream in{baselinePath};
+            if (!in) throw std::runtime_error("failed to open file");
+            baseline = fmo::loadBaseline(in);
+        } catch (std::exception& e) {
+            std::cerr << "while reading '" << baselinePath << "': " << e.what() << '\n';
+            return -1;
+        }
+    }
+
+    fmo::Trace::enable(tracePath != nullptr);
+    std::vector<fmo::BenchResult> results;
+    bool finished = fmo::Registry::get().run(options, results, log, []() { return false; });
+
+    try {
+        if (jsonPath != nullptr) writeFile(jsonPath, fmo::writeJson, results);
+        if (csvPath != nullptr) writeFile(csvPath, fmo::writeCsv, results);
+        // a partial baseline would make the next comparison report missing benchmarks
+        if (savePath != nullptr && finished) writeFile(savePath, fmo::saveBaseline, results);
+        if (tracePath != nullptr) {
+            std::ofstream out{tracePath};
+            fmo::Trace::writeJson(out);
+        }
+    } catch (std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+
+    // the results of an interrupted run are exported for inspection, but the run fails
+    if (!finished) return 1;
 
-int main() {
-    fmo::Registry::get().runAll([](const char* cStr) { std::cout << cStr; },
-                                []() { return false; });
+    if (baselinePath != nullptr) {
+        // benchmarks excluded by the options are not reported as missing
+        baseline = fmo::selectBaseline(baseline, options);
+        auto comparisons = fmo::compareResults(baseline, results, threshold, alpha);
+        if (printComparison(comparisons)) return 1;
+    }
 }
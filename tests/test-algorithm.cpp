@@ -0,0 +1,445 @@
+#include "../catch/catch.hpp"
+#include "test-tools.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fmo/algorithm.hpp>
+#include <fmo/allocator.hpp>
+#include <fmo/region.hpp>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+    int64_t syntheticNs = 0;
+    int64_t syntheticFrameNs = 0;
+
+    /// Advances by the synthetic frame time on every reading, so that each frame, measured from
+    /// its start to its end, takes exactly syntheticFrameNs.
+    int64_t syntheticClock() { return syntheticNs += syntheticFrameNs; }
+
+    /// Renders a black frame with a white bar that moves by a large distance every frame.
+    void renderMovingBar(fmo::Image& image, int frameNum) {
+        auto dims = image.dims();
+        std::fill(image.data(), image.data() + image.size(), uint8_t(0x00));
+        int x0 = 20 + (90 * frameNum) % (dims.width - 120);
+        int y0 = dims.height / 2 - 6;
+
+        for (int y = y0; y < y0 + 12; y++) {
+            uint8_t* row = image.data() + y * image.skip();
+            std::fill(row + x0, row + x0 + 80, uint8_t(0xFF));
+        }
+    }
+}
+
+SCENARIO("obtaining output from algorithms", "[algorithm]") {
+    GIVEN("an instance of every algorithm, processing a GRAY video") {
+        // getOutput() is called twice per frame, like in the desktop application
+        fmo::Dims dims{640, 480};
+        fmo::Algorithm::Config config;
+        fmo::Image input;
+
+        for (auto& name : fmo::Algorithm::listFactories()) {
+            config.name = name;
+            auto algorithm = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+            fmo::Algorithm::Output output1;
+            fmo::Algorithm::Output output2;
+            output1.detections.reserve(16);
+            output2.detections.reserve(16);
+            int64_t numAllocated = 0;
+
+            for (int i = 0; i < 20; i++) {
+                input.resize(fmo::Format::GRAY, dims);
+                renderMovingBar(input, i);
+                algorithm->setInputSwap(input);
+
+                int64_t numBefore = fmo::heapAllocations().count;
+                algorithm->getOutput(output1);
+                algorithm->getOutput(output2);
+                if (i >= 10) { numAllocated += fmo::heapAllocations().count - numBefore; }
+
+                // repeated calls must report the same detections
+                REQUIRE(output1.detections == output2.detections);
+            }
+
+            // no allocations are allowed in the steady state
+            INFO(name);
+            REQUIRE(numAllocated == 0);
+        }
+    }
+}
+
+SCENARIO("image allocations in the steady state", "[algorithm]") {
+    GIVEN("an instance of every algorithm, processing a GRAY video") {
+        fmo::Dims dims{640, 480};
+        fmo::Algorithm::Config config;
+        fmo::Image input;
+
+        for (auto& name : fmo::Algorithm::listFactories()) {
+            config.name = name;
+            auto algorithm = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+            int64_t numBefore = 0;
+
+            for (int i = 0; i < 20; i++) {
+                if (i == 10) { numBefore = fmo::numAlignedAllocations(); }
+                input.resize(fmo::Format::GRAY, dims);
+                renderMovingBar(input, i);
+                algorithm->setInputSwap(input);
+            }
+
+            // all image buffers must be reused after a warm-up
+            INFO(name);
+            REQUIRE(fmo::numAlignedAllocations() == numBefore);
+        }
+    }
+}
+
+SCENARIO("heap allocations in the steady state", "[algorithm]") {
+    GIVEN("an instance of every algorithm, processing a looped GRAY sequence") {
+        // after a warm-up, every buffer has seen the largest frame of the sequence
+        fmo::Dims dims{640, 480};
+        const int sequenceLength = 4;
+        const int numWarmUp = 3 * sequenceLength;
+        fmo::Algorithm::Config config;
+        fmo::Image input;
+        REQUIRE(fmo::heapAllocationsCounted());
+
+        for (auto& name : fmo::Algorithm::listFactories()) {
+            config.name = name;
+            auto algorithm = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+            algorithm->setProfiling(true);
+            auto& profiler = algorithm->getProfiler();
+            fmo::Algorithm::Output output;
+            output.detections.reserve(16);
+            fmo::AllocCounts inputAllocs;
+            fmo::AllocCounts outputAllocs;
+            std::vector<fmo::AllocCounts> stageAllocs(size_t(profiler.numStages()));
+
+            for (int i = 0; i < numWarmUp + 2 * sequenceLength; i++) {
+                input.resize(fmo::Format::GRAY, dims);
+                renderMovingBar(input, i % sequenceLength);
+                fmo::AllocCounts allocs0 = fmo::heapAllocations();
+                algorithm->setInputSwap(input);
+                fmo::AllocCounts allocs1 = fmo::heapAllocations();
+                algorithm->getOutput(output);
+                fmo::AllocCounts allocs2 = fmo::heapAllocations();
+                if (i < numWarmUp) continue;
+
+                inputAllocs += allocs1 - allocs0;
+                outputAllocs += allocs2 - allocs1;
+                for (int s = 0; s < profiler.numStages(); s++) {
+                    stageAllocs[size_t(s)] += profiler.lastAllocs(s);
+                }
+            }
+
+            // neither the frame processing nor any of its stages may allocate
+            INFO(name);
+            REQUIRE(inputAllocs.count == 0);
+            REQUIRE(outputAllocs.count == 0);
+            for (int s = 0; s < profiler.numStages(); s++) {
+                INFO(profiler.stageName(s));
+                REQUIRE(stageAllocs[size_t(s)].count == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("providing the input as a read-only view", "[algorithm]") {
+    GIVEN("two instances of every algorithm, one receiving owned images, one receiving views") {
+        fmo::Dims dims{640, 480};
+        fmo::Algorithm::Config config;
+        fmo::Image input;
+        fmo::Image frame;
+        fmo::Image large{fmo::Format::GRAY, {700, 500}};
+
+        for (auto& name : fmo::Algorithm::listFactories()) {
+            config.name = name;
+            auto swapped = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+            auto viewed = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+            viewed->setKeepInput(false);
+            fmo::Algorithm::Output output1;
+            fmo::Algorithm::Output output2;
+            INFO(name);
+
+            for (int i = 0; i < 20; i++) {
+                frame.resize(fmo::Format::GRAY, dims);
+                renderMovingBar(frame, i);
+                input = frame;
+                swapped->setInputSwap(input);
+
+                // a region of a larger image has a row stride that differs from the width
+                fmo::Region view = large.region({30, 10}, dims);
+                for (int y = 0; y < dims.height; y++) {
+                    const uint8_t* src = frame.data() + y * frame.skip();
+                    std::copy(src, src + dims.width, view.data() + y * view.skip());
+                }
+                viewed->setInputView(view);
+
+                // the results must be identical
+                swapped->getOutput(output1);
+                viewed->getOutput(output2);
+                REQUIRE(output1.detections.size() == output2.detections.size());
+                for (size_t j = 0; j < output1.detections.size(); j++) {
+                    auto& obj1 = output1.detections[j]->object;
+                    auto& obj2 = output2.detections[j]->object;
+                    REQUIRE(obj1.center.x == obj2.center.x);
+                    REQUIRE(obj1.center.y == obj2.center.y);
+                }
+            }
+
+            REQUIRE(viewed->getDebugImage().dims() == dims);
+            REQUIRE_THROWS(viewed->setInputView(large));
+        }
+    }
+}
+
+SCENARIO("retaining source-resolution inputs", "[algorithm]") {
+    GIVEN("explorer-v3 receiving owned images, views, and views with the input kept") {
+        fmo::Dims dims{640, 480};
+        fmo::Algorithm::Config config;
+        config.name = "explorer-v3";
+        auto swapped = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+        auto viewed = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+        auto kept = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+        kept->setKeepInput(true);
+        fmo::Image input;
+        fmo::Image frame;
+
+        for (int i = 0; i < 10; i++) {
+            frame.resize(fmo::Format::GRAY, dims);
+            renderMovingBar(frame, i);
+            input = frame;
+            swapped->setInputSwap(input);
+            viewed->setInputView(frame);
+            kept->setInputView(frame);
+        }
+        swapped->getDebugImage();
+        viewed->getDebugImage();
+        kept->getDebugImage();
+
+        THEN("views retain no source image by default and a single one if the input is kept") {
+            size_t sourceBytes = size_t(dims.width) * size_t(dims.height);
+            REQUIRE(viewed->getMemoryUsage() + 3 * sourceBytes <= swapped->getMemoryUsage());
+            REQUIRE(kept->getMemoryUsage() == viewed->getMemoryUsage() + sourceBytes);
+        }
+    }
+}
+
+SCENARIO("streaming the input in lean memory mode", "[algorithm]") {
+    GIVEN("two instances of the algorithms that support it, one of them lean") {
+        // two decimation levels, one of them intermediate
+        fmo::Dims dims{1280, 960};
+        fmo::Algorithm::Config config;
+        fmo::Algorithm::Config leanConfig;
+        leanConfig.leanMemory = true;
+        fmo::Image input;
+        fmo::Image frame;
+
+        for (auto name : {"median-v1", "explorer-v3"}) {
+            config.name = name;
+            leanConfig.name = name;
+            auto regular = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+            auto lean = fmo::Algorithm::make(leanConfig, fmo::Format::GRAY, dims);
+            fmo::Algorithm::Output output1;
+            fmo::Algorithm::Output output2;
+            INFO(name);
+
+            for (int i = 0; i < 20; i++) {
+                frame.resize(fmo::Format::GRAY, dims);
+                renderMovingBar(frame, i);
+                input = frame;
+                regular->setInputSwap(input);
+                input = frame;
+                lean->setInputSwap(input);
+
+                // the results must be identical
+                regular->getOutput(output1);
+                lean->getOutput(output2);
+                REQUIRE(output1.detections.size() == output2.detections.size());
+                for (size_t j = 0; j < output1.detections.size(); j++) {
+                    auto& obj1 = output1.detections[j]->object;
+                    auto& obj2 = output2.detections[j]->object;
+                    REQUIRE(obj1.center.x == obj2.center.x);
+                    REQUIRE(obj1.center.y == obj2.center.y);
+                }
+            }
+
+            // neither the source images nor the intermediate level are retained
+            size_t sourceBytes = size_t(dims.width) * size_t(dims.height);
+            REQUIRE(lean->getMemoryUsage() > 0);
+            REQUIRE(lean->getMemoryUsage() + sourceBytes < regular->getMemoryUsage());
+        }
+    }
+}
+
+SCENARIO("adapting the processing level to a latency budget", "[algorithm]") {
+    GIVEN("the algorithms that support it, with a 10 ms budget and a synthetic clock") {
+        fmo::Dims dims{640, 480};
+        fmo::Algorithm::Config config;
+        config.latencyBudget = 10.f;
+        fmo::Image input;
+        fmo::Algorithm::Output output;
+        const int window = fmo::LatencyGovernor::WINDOW;
+
+        for (auto name : {"median-v1", "explorer-v3"}) {
+            config.name = name;
+            auto algorithm = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+            algorithm->setGovernorClock(syntheticClock);
+            auto& governor = algorithm->getGovernor();
+            int frameNum = 0;
+            INFO(name);
+
+            auto run = [&](float frameMs, int numFrames) {
+                syntheticFrameNs = int64_t(frameMs * 1e6f);
+                for (int i = 0; i < numFrames; i++) {
+                    input.resize(fmo::Format::GRAY, dims);
+                    renderMovingBar(input, frameNum++);
+                    algorithm->setInputSwap(input);
+                    algorithm->getOutput(output);
+                }
+            };
+
+            // over budget: the level rises once per window up to the maximum
+            REQUIRE(governor.maxLevel() >= 2);
+            run(20.f, window);
+            REQUIRE(governor.level() == 1);
+            run(20.f, window * (governor.maxLevel() + 1));
+            REQUIRE(governor.level() == governor.maxLevel());
+
+            // within the hysteresis band: the level is kept
+            run(5.f, window);
+            REQUIRE(governor.level() == governor.maxLevel());
+
+            // well below budget: the level recovers down to zero
+            run(1.f, window * governor.maxLevel());
+            REQUIRE(governor.level() == 0);
+            REQUIRE(governor.numSwitches() == 2 * governor.maxLevel());
+            REQUIRE(governor.lastSwitch().q95Ms == Approx(1.f));
+        }
+    }
+}
+
+SCENARIO("dumping slow frames with the flight recorder", "[algorithm]") {
+    GIVEN("the algorithms that support it, with a threshold that every frame exceeds") {
+        fmo::Dims dims{640, 480};
+        fmo::Algorithm::Config config;
+        config.flightRecorderThreshold = 1e-3f;
+        fmo::Image input;
+        const int numFrames = 5;
+
+        for (auto name : {"median-v1", "explorer-v3"}) {
+            TempDir dir;
+            config.name = name;
+            config.flightRecorderDir = dir.path();
+            auto algorithm = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+            INFO(name);
+
+            for (int i = 0; i < numFrames; i++) {
+                input.resize(fmo::Format::GRAY, dims);
+                renderMovingBar(input, i);
+                algorithm->setInputSwap(input);
+            }
+
+            // each frame is dumped together with the preceding ones
+            auto& recorder = algorithm->getFlightRecorder();
+            recorder.flush();
+            REQUIRE(recorder.numFailures() == 0);
+            REQUIRE(recorder.numDumps() == numFrames);
+            REQUIRE(recorder.lastDump() == dir.path() + "/fmo-frame-5.txt");
+
+            std::ifstream in{recorder.lastDump()};
+            std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+            REQUIRE(text.find("diff-thresh ") != std::string::npos);
+            REQUIRE(text.find("num-strips ") != std::string::npos);
+            REQUIRE(text.find("stage-ms ") != std::string::npos);
+            REQUIRE(text.find("image fmo-frame-5-2.png") != std::string::npos);
+        }
+    }
+    GIVEN("a directory that does not exist") {
+        fmo::Algorithm::Config config;
+        config.name = "explorer-v3";
+        config.flightRecorderThreshold = 1e-3f;
+        config.flightRecorderDir = "./fmo-no-such-directory";
+        fmo::Dims dims{640, 480};
+        auto algorithm = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+        fmo::Image input;
+
+        THEN("failures are counted instead of thrown") {
+            for (int i = 0; i < 3; i++) {
+                input.resize(fmo::Format::GRAY, dims);
+                renderMovingBar(input, i);
+                REQUIRE_NOTHROW(algorithm->setInputSwap(input));
+            }
+
+            auto& recorder = algorithm->getFlightRecorder();
+            recorder.flush();
+            REQUIRE(recorder.numDumps() == 0);
+            REQUIRE(recorder.numFailures() == 3);
+            REQUIRE(recorder.lastError().find("fmo-no-such-directory") != std::string::npos);
+        }
+    }
+}
+
+SCENARIO("replaying frames dumped by the flight recorder", "[algorithm]") {
+    GIVEN("a dump of a slow frame, read back using FlightRecorder::load()") {
+        fmo::Dims dims{640, 480};
+        fmo::Algorithm::Config config;
+        config.name = "explorer-v3";
+        config.flightRecorderThreshold = 1e-3f;
+        TempDir dir;
+        config.flightRecorderDir = dir.path();
+        fmo::Image input;
+        const int numFrames = 4;
+
+        auto algorithm = fmo::Algorithm::make(config, fmo::Format::GRAY, dims);
+        for (int i = 0; i < numFrames; i++) {
+            input.resize(fmo::Format::GRAY, dims);
+            renderMovingBar(input, i);
+            algorithm->setInputSwap(input);
+        }
+        algorithm->getFlightRecorder().flush();
+        auto recording = fmo::FlightRecorder::load(dir.path() + "/fmo-frame-4.txt");
+
+        THEN("the recorded frames are intact") {
+            REQUIRE(recording.thresholdMs == Approx(config.flightRecorderThreshold));
+            REQUIRE(recording.frames.size() == size_t(fmo::FlightRecorder::NUM_FRAMES));
+            REQUIRE(recording.stageNames.size() == size_t(algorithm->getProfiler().numStages()));
+            for (size_t i = 0; i < recording.frames.size(); i++) {
+                auto& frame = recording.frames[i];
+                REQUIRE(frame.frameNum == numFrames - fmo::FlightRecorder::NUM_FRAMES + 1 + int(i));
+                REQUIRE(frame.input.format() == fmo::Format::GRAY);
+                REQUIRE(frame.input.dims().height <= dims.height);
+                REQUIRE(frame.stagesNs.size() == recording.stageNames.size());
+                REQUIRE(frame.totalNs > 0);
+            }
+        }
+
+        WHEN("the frames are fed to a new instance, set up as documented") {
+            auto& oldest = recording.frames.front();
+            TempDir replayDir;
+            fmo::Algorithm::Config replayConfig = config;
+            replayConfig.flightRecorderDir = replayDir.path();
+            replayConfig.maxImageHeight = oldest.input.dims().height;
+            replayConfig.diff.thresh = uint8_t(oldest.diffThresh);
+            fmo::Image replayInput;
+            fmo::FlightRecorder::replayInput(oldest, replayInput);
+            auto replay = fmo::Algorithm::make(replayConfig, fmo::Format::GRAY, replayInput.dims());
+
+            for (auto& frame : recording.frames) {
+                fmo::FlightRecorder::replayInput(frame, replayInput);
+                replay->setInputSwap(replayInput);
+            }
+
+            THEN("the algorithm processes the same images at the same level") {
+                replay->getFlightRecorder().flush();
+                auto replayed = fmo::FlightRecorder::load(replayDir.path() + "/fmo-frame-3.txt");
+                REQUIRE(replayed.frames.size() == recording.frames.size());
+                for (size_t i = 0; i < recording.frames.size(); i++) {
+                    auto& expected = recording.frames[i].input;
+                    auto& actual = replayed.frames[i].input;
+                    REQUIRE(actual.dims() == expected.dims());
+                    REQUIRE(exact_match(actual, expected));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,151 @@
+#include "../catch/catch.hpp"
+#include <fmo/benchmark.hpp>
+#include <sstream>
+
+namespace {
+    fmo::BenchResult makeResult(const char* name, int64_t baseNs, int repetition) {
+        fmo::BenchResult result{};
+        result.name = name;
+        result.axes = fmo::BenchParams::DIMS | fmo::BenchParams::FORMAT;
+        result.params = {{640, 480}, fmo::Format::YUV420SP, 300, 0, 0};
+        result.repetition = repetition;
+        result.numPixels = 640 * 480;
+        for (int i = 0; i < 100; i++) { result.samplesNs.push_back(baseNs + (i * 37) % 101); }
+        return result;
+    }
+}
+
+SCENARIO("comparing benchmark results with a baseline", "[benchmark]") {
+    GIVEN("a baseline with two repetitions of two benchmarks") {
+        std::vector<fmo::BenchResult> baseline;
+        baseline.push_back(makeResult("kernel, fast", 1000, 0));
+        baseline.push_back(makeResult("kernel, fast", 1000, 1));
+        baseline.push_back(makeResult("algorithm", 5000, 0));
+        baseline.push_back(makeResult("algorithm", 5000, 1));
+        baseline.push_back(makeResult("stage", 2000, 0));
+        baseline.back().axes = fmo::BenchParams::COUNT;
+        baseline.back().params.count = 1000;
+
+        WHEN("the baseline is saved and loaded") {
+            std::stringstream stream;
+            fmo::saveBaseline(stream, baseline);
+            auto loaded = fmo::loadBaseline(stream);
+
+            THEN("names, parameters and samples are preserved") {
+                REQUIRE(loaded.size() == baseline.size());
+                for (size_t i = 0; i < loaded.size(); i++) {
+                    REQUIRE(loaded[i].name == baseline[i].name);
+                    REQUIRE(loaded[i].axes == baseline[i].axes);
+                    REQUIRE(loaded[i].params.dims == baseline[i].params.dims);
+                    REQUIRE(loaded[i].params.format == fmo::Format::YUV420SP);
+                    REQUIRE(loaded[i].params.count == baseline[i].params.count);
+                    REQUIRE(loaded[i].repetition == baseline[i].repetition);
+                    REQUIRE(loaded[i].samplesNs == baseline[i].samplesNs);
+                    REQUIRE(loaded[i].numCalls == 100);
+                }
+            }
+        }
+
+        WHEN("a baseline saved before item counts were recorded is loaded") {
+            std::stringstream stream;
+            stream << "/FMO/BENCHMARK/BASELINE/V1/\n1\nkernel, fast\n"
+                   << (fmo::BenchParams::DIMS | fmo::BenchParams::FORMAT)
+                   << " 640 480 YUV420SP 300 0 0 307200 3\n1000 1010 1020 \n";
+            auto loaded = fmo::loadBaseline(stream);
+
+            THEN("the results are read with a zero count") {
+                REQUIRE(loaded.size() == 1);
+                REQUIRE(loaded[0].name == "kernel, fast");
+                REQUIRE(loaded[0].params.dims == baseline[0].params.dims);
+                REQUIRE(loaded[0].params.count == 0);
+                REQUIRE(loaded[0].numPixels == 640 * 480);
+                REQUIRE(loaded[0].samplesNs == std::vector<int64_t>({1000, 1010, 1020}));
+            }
+        }
+
+        WHEN("one benchmark becomes slower, one slightly faster and one changes its count") {
+            std::vector<fmo::BenchResult> results;
+            results.push_back(makeResult("kernel, fast", 1100, 0));
+            results.push_back(makeResult("algorithm", 4990, 0));
+            results.push_back(makeResult("new", 100, 0));
+            results.push_back(baseline.back());
+            results.back().params.count = 10;
+            auto comparisons = fmo::compareResults(baseline, results, 0.05, 0.01);
+
+            THEN("the change beyond the threshold and the missing count are reported") {
+                REQUIRE(comparisons.size() == 5);
+                REQUIRE(comparisons[0].label == "kernel, fast [640x480 YUV420SP]");
+                REQUIRE(comparisons[0].verdict == fmo::BenchComparison::REGRESSION);
+                REQUIRE(comparisons[0].change == Approx(0.1).epsilon(0.01));
+                REQUIRE(comparisons[1].verdict == fmo::BenchComparison::SAME);
+                REQUIRE(comparisons[2].verdict == fmo::BenchComparison::NEW);
+                REQUIRE(comparisons[3].label == "stage [n10]");
+                REQUIRE(comparisons[3].verdict == fmo::BenchComparison::NEW);
+                REQUIRE(comparisons[4].label == "stage [n1000]");
+                REQUIRE(comparisons[4].verdict == fmo::BenchComparison::MISSING);
+                REQUIRE(comparisons[4].baseQ50Ms > 0);
+            }
+        }
+
+        WHEN("a run measures fewer parameter values than the baseline holds") {
+            fmo::BenchOptions options;
+            options.resolutions = {{640, 480}};
+            options.formats = {fmo::Format::GRAY};
+            options.counts = {10, 1000};
+            auto selected = fmo::selectBaseline(baseline, options);
+
+            std::vector<fmo::BenchResult> results;
+            results.push_back(baseline.back());
+            auto comparisons = fmo::compareResults(selected, results, 0.05, 0.01);
+
+            THEN("only the benchmarks it measures again are compared") {
+                REQUIRE(selected.size() == 1);
+                REQUIRE(selected[0].name == "stage");
+                REQUIRE(comparisons.size() == 1);
+                REQUIRE(comparisons[0].verdict == fmo::BenchComparison::SAME);
+            }
+
+            THEN("filters are applied as well") {
+                options.formats = {fmo::Format::YUV420SP};
+                options.filters = {"kernel"};
+                selected = fmo::selectBaseline(baseline, options);
+                REQUIRE(selected.size() == 2);
+                REQUIRE(selected[0].name == "kernel, fast");
+                REQUIRE(selected[1].name == "kernel, fast");
+            }
+        }
+
+        WHEN("the results equal the baseline") {
+            auto comparisons = fmo::compareResults(baseline, baseline, 0.05, 0.01);
+
+            THEN("nothing changes") {
+                REQUIRE(comparisons.size() == 3);
+                for (auto& c : comparisons) {
+                    REQUIRE(c.verdict == fmo::BenchComparison::SAME);
+                    REQUIRE(c.pValue == Approx(1.));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("estimating how a benchmark scales with the item count", "[benchmark]") {
+    GIVEN("results of a quadratic stage at several counts") {
+        std::vector<fmo::BenchResult> results;
+        for (int count : {10, 100, 1000}) {
+            fmo::BenchResult result{};
+            result.axes = fmo::BenchParams::COUNT;
+            result.params.count = count;
+            result.q50Ms = 3e-5 * count * count;
+            results.push_back(result);
+        }
+
+        THEN("the exponent is two") { REQUIRE(fmo::scalingExponent(results) == Approx(2.)); }
+
+        WHEN("only a single count is available") {
+            results.resize(1);
+
+            THEN("the exponent is zero") { REQUIRE(fmo::scalingExponent(results) == 0.); }
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#include "../catch/catch.hpp"
+#include <algorithm>
+#include <fmo/exchange.hpp>
+#include <thread>
+#include <vector>
+
+SCENARIO("passing the latest value through a triple buffer", "[exchange]") {
+    GIVEN("a triple exchange") {
+        fmo::TripleExchange<int> exchange{-1};
+        WHEN("several payloads are sent before receiving") {
+            for (int i = 0; i < 5; i++) {
+                int value = i;
+                exchange.swapSend(value);
+            }
+            THEN("only the latest one is received") {
+                int value = -1;
+                int64_t sendNs = -1;
+                REQUIRE(exchange.swapReceive(value, &sendNs));
+                REQUIRE(value == 4);
+                REQUIRE(sendNs >= 0);
+                REQUIRE(exchange.numSent() == 5);
+                REQUIRE(exchange.numDropped() == 4);
+            }
+        }
+        WHEN("a payload is written directly into the send buffer") {
+            exchange.sendBuffer() = 42;
+            exchange.send();
+            THEN("it is received") {
+                int value = -1;
+                REQUIRE(exchange.swapReceive(value));
+                REQUIRE(value == 42);
+            }
+        }
+        WHEN("exit() is called") {
+            exchange.exit();
+            THEN("receiving does not block") {
+                int value = -1;
+                REQUIRE(!exchange.swapReceive(value));
+            }
+        }
+    }
+    GIVEN("a producer thread and a consumer thread") {
+        // test both the spinning and the sleeping consumer
+        for (int spinCount : {1000, 0}) {
+            fmo::TripleExchange<int> exchange{-1};
+            exchange.setWaitPolicy(spinCount, spinCount / 10);
+            const int numValues = 1000;
+            std::vector<int> received;
+            std::thread consumer([&]() {
+                int value;
+                while (exchange.swapReceive(value)) {
+                    received.push_back(value);
+                    if (value == numValues - 1) break;
+                }
+            });
+
+            for (int i = 0; i < numValues; i++) {
+                int value = i;
+                exchange.swapSend(value);
+                if (i % 100 == 0) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+            }
+
+            consumer.join();
+
+            INFO(spinCount);
+            REQUIRE(!received.empty());
+            REQUIRE(received.back() == numValues - 1);
+            REQUIRE(std::is_sorted(begin(received), end(received)));
+            REQUIRE(std::adjacent_find(begin(received), end(received)) == end(received));
+            REQUIRE(exchange.numSent() == numValues);
+            REQUIRE(exchange.numDropped() + int64_t(received.size()) == numValues);
+        }
+    }
+}
@@ -0,0 +1,84 @@
+#include "../catch/catch.hpp"
+#include <fmo/frame.hpp>
+#include <thread>
+
+SCENARIO("sharing frames from a pool", "[frame]") {
+    GIVEN("a frame pool") {
+        fmo::Dims dims{8, 4};
+        fmo::FramePool pool{fmo::Format::GRAY, dims};
+        REQUIRE(pool.numAllocated() == 0);
+        WHEN("a frame is published") {
+            auto frame = pool.publish([](fmo::Image& image) {
+                std::fill(image.begin(), image.end(), uint8_t(7));
+            });
+            THEN("the frame holds the data written by the fill function") {
+                REQUIRE(frame);
+                REQUIRE(frame.image().format() == fmo::Format::GRAY);
+                REQUIRE(frame.image().dims().width == dims.width);
+                REQUIRE(frame.image().dims().height == dims.height);
+                REQUIRE(*frame.image().data() == 7);
+                REQUIRE(frame.useCount() == 1);
+                REQUIRE(pool.numAllocated() == 1);
+            }
+            THEN("copies share the image data") {
+                fmo::Frame copy1 = frame;
+                fmo::Frame copy2;
+                copy2 = copy1;
+                REQUIRE(copy2.image().data() == frame.image().data());
+                REQUIRE(frame.useCount() == 3);
+                copy1.reset();
+                REQUIRE(!copy1);
+                REQUIRE(frame.useCount() == 2);
+            }
+            THEN("the buffer returns to the pool when the last reference is released") {
+                const uint8_t* data = frame.image().data();
+                fmo::Frame copy = frame;
+                frame.reset();
+                REQUIRE(pool.numFree() == 0);
+                copy.reset();
+                REQUIRE(pool.numFree() == 1);
+
+                auto next = pool.publish([](fmo::Image&) {});
+                REQUIRE(next.image().data() == data);
+                REQUIRE(pool.numAllocated() == 1);
+            }
+            THEN("an image shared from the frame refers to the same data") {
+                fmo::Image image = frame.share();
+                REQUIRE(image.adopted());
+                REQUIRE(image.data() == frame.image().data());
+                REQUIRE(frame.useCount() == 2);
+                frame.reset();
+                REQUIRE(*image.data() == 7);
+                REQUIRE(pool.numFree() == 0);
+                image.clear();
+                REQUIRE(pool.numFree() == 1);
+            }
+            THEN("the last reference may be released by another thread") {
+                std::thread reader([copy = frame]() mutable { copy.reset(); });
+                frame.reset();
+                reader.join();
+                REQUIRE(pool.numFree() == 1);
+            }
+        }
+        WHEN("several frames are in use") {
+            auto frame1 = pool.publish([](fmo::Image&) {});
+            auto frame2 = pool.publish([](fmo::Image&) {});
+            THEN("each has its own buffer") {
+                REQUIRE(frame1.image().data() != frame2.image().data());
+                REQUIRE(pool.numAllocated() == 2);
+                REQUIRE(pool.numFree() == 0);
+            }
+        }
+    }
+    GIVEN("a frame that outlives its pool") {
+        fmo::Frame frame;
+        {
+            fmo::FramePool pool{fmo::Format::GRAY, {4, 4}};
+            frame = pool.publish([](fmo::Image& image) { *image.data() = 3; });
+        }
+        THEN("the frame remains valid") {
+            REQUIRE(*frame.image().data() == 3);
+            frame.reset();
+        }
+    }
+}
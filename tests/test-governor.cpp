@@ -0,0 +1,69 @@
+#include "../catch/catch.hpp"
+#include <fmo/governor.hpp>
+
+namespace {
+    /// Feeds a full window of identical frame times to the governor.
+    bool addWindow(fmo::LatencyGovernor& governor, float frameMs) {
+        bool switched = false;
+        for (int i = 0; i < fmo::LatencyGovernor::WINDOW; i++) {
+            switched = governor.add(int64_t(frameMs * 1e6f));
+            if (i != fmo::LatencyGovernor::WINDOW - 1) { REQUIRE(!switched); }
+        }
+        return switched;
+    }
+}
+
+SCENARIO("adapting the processing level to a latency budget", "[governor]") {
+    GIVEN("a default governor") {
+        fmo::LatencyGovernor governor;
+        THEN("it is disabled") {
+            REQUIRE(!governor.enabled());
+            REQUIRE(!governor.frameEnd());
+            REQUIRE(governor.level() == 0);
+        }
+    }
+    GIVEN("a governor with a 10 ms budget at 480 rows") {
+        fmo::LatencyGovernor governor;
+        governor.configure(10.f, 0.2f, 480);
+        THEN("the maximum level keeps the height above MIN_HEIGHT") {
+            REQUIRE(governor.enabled());
+            REQUIRE(governor.maxLevel() == 3);
+        }
+        WHEN("frames are over budget") {
+            for (int i = 0; i < 5; i++) { addWindow(governor, 20.f); }
+            THEN("the level goes up to the maximum and stops") {
+                REQUIRE(governor.level() == 3);
+                REQUIRE(governor.numSwitches() == 3);
+                REQUIRE(governor.lastSwitch().oldLevel == 2);
+                REQUIRE(governor.lastSwitch().newLevel == 3);
+                REQUIRE(governor.lastSwitch().frameNum == 3 * fmo::LatencyGovernor::WINDOW);
+                REQUIRE(governor.lastSwitch().q95Ms == Approx(20.f));
+            }
+        }
+        WHEN("only a few frames in a window are over budget") {
+            for (int i = 0; i < fmo::LatencyGovernor::WINDOW; i++) {
+                governor.add(int64_t((i == 0 ? 50.f : 5.f) * 1e6f));
+            }
+            THEN("the level stays the same") { REQUIRE(governor.level() == 0); }
+        }
+        WHEN("the level is raised and frames become fast") {
+            REQUIRE(addWindow(governor, 20.f));
+            REQUIRE(addWindow(governor, 20.f));
+            REQUIRE(governor.level() == 2);
+
+            THEN("frames within the hysteresis band keep the level") {
+                REQUIRE(!addWindow(governor, 5.f));
+                REQUIRE(governor.level() == 2);
+            }
+            THEN("frames below the hysteresis band lower the level down to zero") {
+                REQUIRE(addWindow(governor, 1.f));
+                REQUIRE(governor.level() == 1);
+                REQUIRE(governor.lastSwitch().newLevel == 1);
+                REQUIRE(addWindow(governor, 1.f));
+                REQUIRE(!addWindow(governor, 1.f));
+                REQUIRE(governor.level() == 0);
+                REQUIRE(governor.numSwitches() == 4);
+            }
+        }
+    }
+}
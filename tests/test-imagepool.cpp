@@ -0,0 +1,143 @@
+#include "../catch/catch.hpp"
+#include <fmo/imagepool.hpp>
+
+SCENARIO("recycling image buffers", "[imagepool]") {
+    GIVEN("an empty pool") {
+        fmo::ImagePool pool;
+        fmo::Image image;
+        WHEN("an image is acquired") {
+            pool.acquire(image, fmo::Format::GRAY, {16, 8});
+            THEN("a buffer is allocated") {
+                REQUIRE(image.format() == fmo::Format::GRAY);
+                REQUIRE(image.dims() == (fmo::Dims{16, 8}));
+                REQUIRE(pool.stats().misses == 1);
+                REQUIRE(pool.stats().hits == 0);
+            }
+            THEN("acquiring the same format and size is a hit") {
+                const uint8_t* data = image.data();
+                pool.acquire(image, fmo::Format::GRAY, {16, 8});
+                REQUIRE(image.data() == data);
+                REQUIRE(pool.stats().hits == 1);
+            }
+            THEN("switching sizes back and forth stops allocating") {
+                const uint8_t* data = image.data();
+                pool.acquire(image, fmo::Format::GRAY, {8, 4});
+                REQUIRE(pool.numFree() == 1);
+                int64_t numAllocations = fmo::numAlignedAllocations();
+
+                pool.acquire(image, fmo::Format::GRAY, {16, 8});
+                REQUIRE(image.data() == data);
+                pool.acquire(image, fmo::Format::GRAY, {8, 4});
+                pool.acquire(image, fmo::Format::GRAY, {16, 8});
+                REQUIRE(fmo::numAlignedAllocations() == numAllocations);
+                REQUIRE(pool.stats().misses == 2);
+                REQUIRE(pool.stats().hits == 3);
+            }
+            THEN("a released buffer is reused by another image") {
+                const uint8_t* data = image.data();
+                pool.release(image);
+                REQUIRE(image.size() == 0);
+                fmo::Image other;
+                pool.acquire(other, fmo::Format::GRAY, {16, 8});
+                REQUIRE(other.data() == data);
+                REQUIRE(pool.numFree() == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("allocating large image buffers from pages", "[imagepool]") {
+    const fmo::Dims large{1920, 1080};
+    GIVEN("pools with policies that map pages") {
+        for (auto policy : {fmo::AllocPolicy::PAGES, fmo::AllocPolicy::HUGE_PAGES}) {
+            INFO(int(policy));
+            fmo::ImagePool pool;
+            REQUIRE(pool.allocPolicy() == fmo::AllocPolicy::MALLOC);
+            pool.setAllocPolicy(policy);
+
+            // large images are mapped and page-aligned, unless mapping is not available
+            fmo::Image image;
+            int64_t numMapped = fmo::numMappedAllocations();
+            pool.acquire(image, fmo::Format::GRAY, large);
+#if defined(__unix__) || defined(__APPLE__)
+            REQUIRE(fmo::numMappedAllocations() == numMapped + 1);
+            REQUIRE(uintptr_t(image.data()) % 4096 == 0);
+#endif
+            std::fill(image.begin(), image.end(), uint8_t(0xAB));
+            REQUIRE(image.data()[image.size() - 1] == 0xAB);
+
+            // small images come from the heap
+            fmo::Image small;
+            numMapped = fmo::numMappedAllocations();
+            pool.acquire(small, fmo::Format::GRAY, {16, 8});
+            REQUIRE(fmo::numMappedAllocations() == numMapped);
+        }
+    }
+    GIVEN("a global policy that maps pages") {
+        fmo::setAllocPolicy(fmo::AllocPolicy::PAGES);
+        fmo::ImagePool pool;
+        fmo::Image image{fmo::Format::GRAY, large};
+        fmo::setAllocPolicy(fmo::AllocPolicy::MALLOC);
+        THEN("it applies to new pools and images") {
+            REQUIRE(pool.allocPolicy() == fmo::AllocPolicy::PAGES);
+#if defined(__unix__) || defined(__APPLE__)
+            REQUIRE(uintptr_t(image.data()) % 4096 == 0);
+#endif
+        }
+    }
+}
+
+SCENARIO("adopting externally owned buffers", "[imagepool]") {
+    GIVEN("an image that adopts a buffer") {
+        std::vector<uint8_t> buffer(16 * 8, uint8_t(5));
+        int numReleased = 0;
+        auto release = [&](uint8_t* data) {
+            REQUIRE(data == buffer.data());
+            numReleased++;
+        };
+        fmo::Image image{fmo::Format::GRAY, {16, 8}, buffer.data(), release};
+        THEN("the buffer is used without copying") {
+            REQUIRE(image.adopted());
+            REQUIRE(image.data() == buffer.data());
+            REQUIRE(image.size() == buffer.size());
+            REQUIRE(image.skip() == 16);
+            REQUIRE(numReleased == 0);
+        }
+        THEN("swapping passes the buffer to the other image") {
+            fmo::Image other;
+            other.swap(image);
+            REQUIRE(!image.adopted());
+            REQUIRE(other.data() == buffer.data());
+            image.clear();
+            REQUIRE(numReleased == 0);
+            other.clear();
+            REQUIRE(numReleased == 1);
+        }
+        THEN("copies own their data") {
+            fmo::Image copy = image;
+            REQUIRE(!copy.adopted());
+            REQUIRE(copy.data() != buffer.data());
+            REQUIRE(copy.data()[0] == 5);
+        }
+        THEN("resizing to the same format and size keeps the buffer") {
+            image.resize(fmo::Format::GRAY, {16, 8});
+            REQUIRE(image.data() == buffer.data());
+            REQUIRE(numReleased == 0);
+        }
+        THEN("resizing to a different size releases the buffer") {
+            image.resize(fmo::Format::GRAY, {8, 8});
+            REQUIRE(!image.adopted());
+            REQUIRE(numReleased == 1);
+        }
+        THEN("returning the image to a pool releases the buffer") {
+            fmo::ImagePool pool;
+            pool.release(image);
+            REQUIRE(numReleased == 1);
+            REQUIRE(pool.numFree() == 0);
+        }
+        THEN("the buffer is released when the image is destroyed") {
+            { fmo::Image temp = std::move(image); }
+            REQUIRE(numReleased == 1);
+        }
+    }
+}
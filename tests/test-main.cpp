@@ -1,2 +1,6 @@
 #define CATCH_CONFIG_MAIN
 #include "../catch/catch.hpp"
+#include <fmo/allocator.hpp>
+
+// count all heap allocations made by this program, see fmo::heapAllocations()
+FMO_COUNT_ALLOCATIONS
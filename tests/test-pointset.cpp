@@ -0,0 +1,84 @@
+#include "../catch/catch.hpp"
+#include <fmo/pointset.hpp>
+
+namespace fmo {
+    bool operator==(const fmo::Span& l, const fmo::Span& r) {
+        return l.y == r.y && l.xBegin == r.xBegin && l.xEnd == r.xEnd;
+    }
+}
+
+SCENARIO("converting between point sets and span sets", "[pointset]") {
+    GIVEN("a sorted point set") {
+        fmo::PointSet points{{3, 0}, {4, 0}, {5, 0}, {7, 0}, {0, 1}, {1, 1}, {9, 2}};
+        WHEN("it is converted to spans") {
+            fmo::SpanSet spans;
+            fmo::spanSetFromPoints(points, spans);
+            THEN("runs in each row become spans") {
+                fmo::SpanSet expected{{0, 3, 6}, {0, 7, 8}, {1, 0, 2}, {2, 9, 10}};
+                REQUIRE(spans == expected);
+                REQUIRE(fmo::spanSetSize(spans) == int(points.size()));
+            }
+            THEN("converting back yields the original points") {
+                fmo::PointSet back;
+                fmo::spanSetToPoints(spans, back);
+                REQUIRE(back.size() == points.size());
+                REQUIRE(std::equal(begin(back), end(back), begin(points), fmo::pointSetCompEq));
+            }
+        }
+    }
+    GIVEN("unordered, overlapping, touching and empty spans") {
+        fmo::SpanSet spans{{1, 5, 8}, {0, 2, 4}, {1, 0, 3}, {1, 3, 5}, {0, 9, 9}, {0, 3, 6}};
+        WHEN("spanSetNormalize() is called") {
+            fmo::spanSetNormalize(spans);
+            THEN("spans are sorted and joined") {
+                fmo::SpanSet expected{{0, 2, 6}, {1, 0, 8}};
+                REQUIRE(spans == expected);
+            }
+        }
+    }
+}
+
+SCENARIO("comparing span sets", "[pointset]") {
+    GIVEN("two overlapping span sets") {
+        fmo::SpanSet s1{{0, 0, 4}, {1, 2, 6}, {2, 0, 2}, {2, 4, 10}};
+        fmo::SpanSet s2{{0, 2, 3}, {1, 0, 10}, {2, 1, 5}, {3, 0, 1}};
+        WHEN("spanSetCompare() is called") {
+            int extra1 = 0;
+            int extra2 = 0;
+            int match = 0;
+            fmo::spanSetCompare(s1, s2, [&](const fmo::Span& s) { extra1 += s.size(); },
+                                [&](const fmo::Span& s) { extra2 += s.size(); },
+                                [&](const fmo::Span& s) { match += s.size(); });
+            THEN("the results agree with pointSetCompare()") {
+                fmo::PointSet p1, p2;
+                fmo::spanSetToPoints(s1, p1);
+                fmo::spanSetToPoints(s2, p2);
+                int pExtra1 = 0;
+                int pExtra2 = 0;
+                int pMatch = 0;
+                fmo::pointSetCompare(p1, p2, [&](fmo::Pos) { pExtra1++; },
+                                     [&](fmo::Pos) { pExtra2++; }, [&](fmo::Pos) { pMatch++; });
+                REQUIRE(extra1 == pExtra1);
+                REQUIRE(extra2 == pExtra2);
+                REQUIRE(match == pMatch);
+                REQUIRE(match == 1 + 4 + 2);
+            }
+        }
+        WHEN("spanSetIou() is called") {
+            THEN("the result is the ratio of intersection and union") {
+                REQUIRE(fmo::spanSetIou(s1, s2) == Approx(7. / 25.));
+                REQUIRE(fmo::spanSetIou(s1, s1) == Approx(1.));
+                REQUIRE(fmo::spanSetIou(s1, {}) == Approx(0.));
+            }
+        }
+        WHEN("spanSetMerge() is called") {
+            std::vector<fmo::SpanSet> sets{s1, s2};
+            fmo::SpanSet merged;
+            fmo::spanSetMerge(begin(sets), end(sets), merged);
+            THEN("the result is the union") {
+                fmo::SpanSet expected{{0, 0, 4}, {1, 0, 10}, {2, 0, 10}, {3, 0, 1}};
+                REQUIRE(merged == expected);
+            }
+        }
+    }
+}
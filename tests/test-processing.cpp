@@ -1,5 +1,11 @@
 #include "../catch/catch.hpp"
+#include <algorithm>
+#include <array>
+#include <fmo/region.hpp>
+#include <fmo/strip.hpp>
 #include <fmo/subsampler.hpp>
+#include <random>
+#include <vector>
 #include "test-data.hpp"
 #include "test-tools.hpp"
 
@@ -73,6 +79,33 @@ SCENARIO("performing complex operations", "[image][processing]") {
                 }
             }
         }
+        GIVEN("a random BGR source image with odd dimensions") {
+            fmo::Image src{fmo::Format::BGR, {11, 7}};
+            std::mt19937 re{5489};
+            std::uniform_int_distribution<int> random{0, 255};
+            std::generate(src.begin(), src.end(), [&]() { return uint8_t(random(re)); });
+            WHEN("subsample() converts the image while decimating it") {
+                THEN("result matches conversion followed by decimation") {
+                    for (fmo::Format format : {fmo::Format::GRAY, fmo::Format::YUV}) {
+                        fmo::subsample(src, dst, format);
+                        fmo::Image converted, expected;
+                        fmo::convert(src, converted, format);
+                        fmo::subsample(converted, expected);
+                        INFO(int(format));
+                        REQUIRE(dst.format() == format);
+                        REQUIRE((dst.dims() == fmo::Dims{5, 3}));
+                        REQUIRE(almost_exact_match(dst, expected, 2));
+                    }
+                }
+            }
+            WHEN("an unsupported conversion is requested") {
+                fmo::Image gray;
+                fmo::convert(src, gray, fmo::Format::GRAY);
+                THEN("subsample() throws") {
+                    REQUIRE_THROWS(fmo::subsample(gray, dst, fmo::Format::YUV));
+                }
+            }
+        }
         GIVEN("random GRAY source images") {
             fmo::Image src1{fmo::Format::GRAY, IM_4x2_DIMS, IM_4x2_RANDOM_1.data()};
             fmo::Image src2{fmo::Format::GRAY, IM_4x2_DIMS, IM_4x2_RANDOM_2.data()};
@@ -88,3 +121,140 @@ SCENARIO("performing complex operations", "[image][processing]") {
         }
     }
 }
+
+SCENARIO("decimating camera formats without a full-resolution conversion", "[processing]") {
+    // a 4x2 image with luma 10, 20, ..., 80 and two pairs of chroma samples per row
+    const std::array<uint8_t, 16> yuyv = {{10, 100, 20, 200, 30, 110, 40, 210,  //
+                                           50, 120, 60, 220, 70, 130, 80, 230}};
+    const std::array<uint8_t, 16> uyvy = {{100, 10, 200, 20, 110, 30, 210, 40,  //
+                                           120, 50, 220, 60, 130, 70, 230, 80}};
+    const std::array<uint16_t, 12> p010 = {{10 << 8, 20 << 8, 30 << 8, 40 << 8,     //
+                                            50 << 8, 60 << 8, 70 << 8, 80 << 8,     //
+                                            110 << 8, 210 << 8, 120 << 8, 220 << 8}};
+    const std::array<uint8_t, 6> expectedYuv = {{35, 210, 110, 55, 220, 120}};
+    const std::array<uint8_t, 2> expectedGray = {{35, 55}};
+    fmo::Dims dims{4, 2};
+    fmo::Image dst;
+    fmo::Subsampler sub;
+
+    GIVEN("images in YUYV, UYVY and P010 formats") {
+        std::vector<fmo::Image> images;
+        images.emplace_back(fmo::Format::YUYV, dims, yuyv.data());
+        images.emplace_back(fmo::Format::UYVY, dims, uyvy.data());
+        images.emplace_back(fmo::Format::P010, dims, (const uint8_t*)p010.data());
+        WHEN("Subsampler is used") {
+            THEN("the result is a YUV image") {
+                for (auto& src : images) {
+                    INFO(int(src.format()));
+                    REQUIRE(sub.nextFormat(src.format()) == fmo::Format::YUV);
+                    sub(src, dst);
+                    REQUIRE(dst.format() == fmo::Format::YUV);
+                    REQUIRE((dst.dims() == fmo::Dims{2, 1}));
+                    REQUIRE(exact_match(dst, expectedYuv));
+                }
+            }
+        }
+        WHEN("Subsampler is asked to produce GRAY") {
+            THEN("only luma is kept") {
+                for (auto& src : images) {
+                    INFO(int(src.format()));
+                    sub(src, dst, fmo::Format::GRAY);
+                    REQUIRE(dst.format() == fmo::Format::GRAY);
+                    REQUIRE(exact_match(dst, expectedGray));
+                }
+            }
+        }
+        WHEN("images are copied") {
+            THEN("the copies hold the same data") {
+                for (auto& src : images) {
+                    INFO(int(src.format()));
+                    fmo::Image copy = src;
+                    REQUIRE(copy.size() == src.size());
+                    REQUIRE(exact_match(copy, src));
+                }
+            }
+        }
+    }
+    GIVEN("a YUYV image") {
+        fmo::Image src{fmo::Format::YUYV, dims, yuyv.data()};
+        THEN("regions must start at even columns") {
+            REQUIRE_THROWS(src.region({1, 0}, {2, 1}));
+            auto region = src.region({2, 0}, {2, 2});
+            REQUIRE(region.data() == src.data() + 4);
+        }
+    }
+}
+
+SCENARIO("processing images with padded rows", "[image][processing]") {
+    GIVEN("a GRAY source image with rows padded to 32 bytes") {
+        fmo::Image src{fmo::Format::GRAY, IM_4x2_DIMS, 32};
+        src.assign(fmo::Format::GRAY, IM_4x2_DIMS, IM_4x2_GRAY.data());
+        THEN("rows start at multiples of 32 bytes") {
+            REQUIRE(src.rowAlign() == 32);
+            REQUIRE(src.skip() == 32);
+            REQUIRE(src.size() == 64);
+            REQUIRE(src.region({1, 1}, {2, 1}).data() == src.data() + 33);
+        }
+        WHEN("it is copied into an unpadded image") {
+            fmo::Image dst;
+            fmo::copy(src, dst);
+            THEN("the padding is removed") {
+                REQUIRE(dst.skip() == 4);
+                REQUIRE(exact_match(dst, IM_4x2_GRAY));
+            }
+        }
+        WHEN("it is copied by value") {
+            fmo::Image copy = src;
+            THEN("the padding is kept") {
+                REQUIRE(copy.skip() == 32);
+                REQUIRE(exact_match(copy, src));
+            }
+        }
+    }
+    GIVEN("random GRAY source images with padded rows") {
+        fmo::Image src[3];
+        const uint8_t* data[3] = {IM_4x2_RANDOM_1.data(), IM_4x2_RANDOM_2.data(),
+                                  IM_4x2_RANDOM_3.data()};
+        for (int i = 0; i < 3; i++) {
+            src[i].setRowAlign(32);
+            src[i].assign(fmo::Format::GRAY, IM_4x2_DIMS, data[i]);
+        }
+        WHEN("median3() is called with a padded destination") {
+            fmo::Image dst{fmo::Format::GRAY, IM_4x2_DIMS, 32};
+            fmo::median3(src[0], src[1], src[2], dst);
+            THEN("result is as expected") {
+                fmo::Image unpadded;
+                fmo::copy(dst, unpadded);
+                REQUIRE(exact_match(unpadded, IM_4x2_MEDIAN3));
+            }
+        }
+        WHEN("median3() is called with an unpadded destination") {
+            fmo::Image dst;
+            fmo::median3(src[0], src[1], src[2], dst);
+            THEN("result is as expected") { REQUIRE(exact_match(dst, IM_4x2_MEDIAN3)); }
+        }
+    }
+    GIVEN("a binary image of width 13 with rows padded to 32 bytes") {
+        const fmo::Dims dims{13, 6};
+        fmo::Image img{fmo::Format::GRAY, dims, 32};
+        std::fill(img.begin(), img.end(), uint8_t(0xFF));
+        for (int row = 0; row < dims.height; row++) {
+            uint8_t* data = img.data() + row * img.skip();
+            std::fill(data, data + dims.width, uint8_t(0));
+            if (row >= 1 && row < 5) { data[12] = 0xFF; }
+        }
+        WHEN("StripGen is used") {
+            fmo::StripGen stripGen;
+            std::vector<fmo::Strip> strips;
+            int noise;
+            stripGen(img, 1, 1, 2, strips, noise);
+            THEN("the last column is processed and the padding is ignored") {
+                REQUIRE(strips.size() == 1);
+                REQUIRE(strips[0].pos.x == 25);
+                REQUIRE(strips[0].pos.y == 6);
+                REQUIRE(strips[0].halfDims.height == 4);
+                REQUIRE(noise == 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,183 @@
+#include "../catch/catch.hpp"
+#include <fmo/image.hpp>
+#include <fmo/profiler.hpp>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+namespace {
+    void spin(int64_t ns) {
+        int64_t end = fmo::nanoTime() + ns;
+        while (fmo::nanoTime() < end) {}
+    }
+}
+
+SCENARIO("measuring stage durations", "[profiler]") {
+    GIVEN("a profiler with two stages") {
+        fmo::Profiler profiler;
+        profiler.setStages({"short", "long"});
+        REQUIRE(profiler.numStages() == 2);
+        REQUIRE(profiler.stageName(0) == "short");
+        REQUIRE(profiler.stageName(1) == "long");
+        int numFrames = fmo::Profiler::WARM_UP + fmo::Profiler::SORT_PERIOD;
+
+        auto run = [&]() {
+            for (int i = 0; i < numFrames; i++) {
+                profiler.start();
+                profiler.lap();
+                spin(200000);
+                profiler.lap();
+                profiler.stop();
+            }
+        };
+
+        WHEN("the profiler is disabled") {
+            run();
+            THEN("no measurements are taken") {
+                REQUIRE(profiler.quantilesMs(1).q50 == 0.f);
+                REQUIRE(profiler.totalQuantilesMs().q50 == 0.f);
+            }
+        }
+        WHEN("the profiler is enabled") {
+            profiler.enable(true);
+            run();
+            THEN("quantiles reflect stage durations") {
+                REQUIRE(profiler.quantilesMs(0).q50 < 0.2f);
+                REQUIRE(profiler.quantilesMs(1).q50 >= 0.2f);
+                REQUIRE(profiler.quantilesMs(1).q95 >= profiler.quantilesMs(1).q50);
+                REQUIRE(profiler.totalQuantilesMs().q50 >= 0.2f);
+            }
+            THEN("a table with all stages is printed") {
+                std::ostringstream out;
+                profiler.print(out);
+                REQUIRE(out.str().find("short") != std::string::npos);
+                REQUIRE(out.str().find("long") != std::string::npos);
+                REQUIRE(out.str().find("total") != std::string::npos);
+            }
+        }
+        WHEN("hardware counters are enabled") {
+            profiler.enable(true);
+            bool available = profiler.enableCounters(true);
+            run();
+            THEN("counters are summed if they are available") {
+                REQUIRE(profiler.numCounted() == (available ? numFrames : 0));
+                fmo::PerfCounters counters;
+                if (available && counters.available(fmo::PerfCounters::CYCLES)) {
+                    auto& sums = profiler.counterSums(1);
+                    REQUIRE(sums[fmo::PerfCounters::CYCLES] > 0);
+                    REQUIRE(sums[fmo::PerfCounters::CYCLES] >
+                            profiler.counterSums(0)[fmo::PerfCounters::CYCLES]);
+                }
+                std::ostringstream out;
+                profiler.print(out);
+                REQUIRE((out.str().find("IPC") != std::string::npos) == available);
+            }
+        }
+    }
+}
+
+SCENARIO("printing a short measurement", "[profiler]") {
+    GIVEN("an enabled profiler that ran fewer procedures than the sort period") {
+        fmo::Profiler profiler;
+        profiler.setStages({"sleep"});
+        profiler.enable(true);
+        for (int i = 0; i < fmo::Profiler::WARM_UP + 5; i++) {
+            profiler.start();
+            spin(200000);
+            profiler.lap();
+            profiler.stop();
+        }
+
+        THEN("the periodic quantiles are not available yet") {
+            REQUIRE(profiler.quantilesMs(0).q50 == 0.f);
+        }
+
+        THEN("the printed table reflects the samples nevertheless") {
+            std::ostringstream out;
+            profiler.print(out);
+            std::istringstream in{out.str()};
+            std::string line;
+            std::getline(in, line);
+            std::string name;
+            float q50;
+            in >> name >> q50;
+            REQUIRE(name == "sleep");
+            REQUIRE(q50 >= 0.2f);
+        }
+    }
+}
+
+SCENARIO("printing a long measurement", "[profiler]") {
+    GIVEN("an enabled profiler whose early procedures were slow and later ones fast") {
+        fmo::Profiler profiler;
+        profiler.setStages({"spin"});
+        profiler.enable(true);
+        const int numSlow = 100;
+        const int numFast = 500;
+        for (int i = 0; i < fmo::Profiler::WARM_UP + numSlow + numFast; i++) {
+            profiler.start();
+            if (i < fmo::Profiler::WARM_UP + numSlow) spin(1000000);
+            profiler.lap();
+            profiler.stop();
+        }
+
+        THEN("the periodic quantiles have forgotten the slow procedures") {
+            REQUIRE(profiler.quantilesMs(0).q95 < 0.5f);
+        }
+
+        THEN("the printed table weighs the whole run equally") {
+            std::ostringstream out;
+            profiler.print(out);
+            std::istringstream in{out.str()};
+            std::string line;
+            std::getline(in, line);
+            std::string name;
+            float q50;
+            float q95;
+            in >> name >> q50 >> q95;
+            REQUIRE(name == "spin");
+            REQUIRE(q50 < 0.5f);
+            REQUIRE(q95 >= 1.f);
+        }
+    }
+}
+
+SCENARIO("attributing heap allocations to stages", "[profiler]") {
+    GIVEN("a profiler with a stage that allocates and a stage that doesn't") {
+        fmo::Profiler profiler;
+        profiler.setStages({"allocating", "idle"});
+        profiler.setRecording(true);
+        std::unique_ptr<std::vector<int>> vec;
+
+        WHEN("a procedure is executed") {
+            profiler.start();
+            vec.reset(new std::vector<int>(1000));
+            profiler.lap();
+            profiler.lap();
+            profiler.stop();
+
+            THEN("the allocations are counted in the first stage and in total") {
+                REQUIRE(fmo::heapAllocationsCounted());
+                REQUIRE(profiler.lastAllocs(0).count == 2);
+                REQUIRE(profiler.lastAllocs(0).bytes >= int64_t(1000 * sizeof(int)));
+                REQUIRE(profiler.lastAllocs(1).count == 0);
+                REQUIRE(profiler.totalLastAllocs().count == 2);
+            }
+        }
+
+        WHEN("an image is resized") {
+            fmo::Image image;
+            profiler.start();
+            profiler.lap();
+            image.resize(fmo::Format::GRAY, {640, 480});
+            profiler.lap();
+            profiler.stop();
+
+            THEN("the image data is counted in the second stage") {
+                REQUIRE(profiler.lastAllocs(0).count == 0);
+                REQUIRE(profiler.lastAllocs(1).count == 1);
+                REQUIRE(profiler.lastAllocs(1).bytes >= int64_t(640 * 480));
+            }
+        }
+    }
+}
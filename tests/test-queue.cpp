@@ -0,0 +1,111 @@
+#include "../catch/catch.hpp"
+#include <fmo/queue.hpp>
+#include <thread>
+#include <vector>
+
+namespace {
+    fmo::QueueConfig makeConfig(fmo::QueuePolicy policy, int capacity, int keepPeriod = 2) {
+        fmo::QueueConfig cfg;
+        cfg.policy = policy;
+        cfg.capacity = capacity;
+        cfg.keepPeriod = keepPeriod;
+        return cfg;
+    }
+
+    /// Sends the values from..to-1, returns the number of accepted values.
+    int sendRange(fmo::Queue<int>& queue, int from, int to) {
+        int accepted = 0;
+        for (int i = from; i < to; i++) {
+            int value = i;
+            if (queue.swapSend(value)) { accepted++; }
+        }
+        return accepted;
+    }
+
+    /// Receives all queued values after calling exit().
+    std::vector<int> receiveAll(fmo::Queue<int>& queue) {
+        queue.exit();
+        std::vector<int> result;
+        int value;
+        while (queue.swapReceive(value)) { result.push_back(value); }
+        return result;
+    }
+}
+
+SCENARIO("passing data through a bounded queue", "[queue]") {
+    GIVEN("a queue with capacity 3 that drops the oldest payload") {
+        fmo::Queue<int> queue{makeConfig(fmo::QueuePolicy::DROP_OLDEST, 3), 0};
+        WHEN("6 payloads are sent") {
+            REQUIRE(sendRange(queue, 0, 6) == 6);
+            THEN("the newest 3 payloads are received in order") {
+                REQUIRE(queue.depth() == 3);
+                REQUIRE(receiveAll(queue) == (std::vector<int>{3, 4, 5}));
+                auto stats = queue.stats();
+                REQUIRE(stats.enqueued == 6);
+                REQUIRE(stats.dropped == 3);
+                REQUIRE(stats.maxDepth == 3);
+            }
+        }
+    }
+    GIVEN("a queue with capacity 3 that drops the newest payload") {
+        fmo::Queue<int> queue{makeConfig(fmo::QueuePolicy::DROP_NEWEST, 3), 0};
+        WHEN("6 payloads are sent") {
+            REQUIRE(sendRange(queue, 0, 6) == 3);
+            THEN("the oldest 3 payloads are received in order") {
+                REQUIRE(receiveAll(queue) == (std::vector<int>{0, 1, 2}));
+                auto stats = queue.stats();
+                REQUIRE(stats.enqueued == 3);
+                REQUIRE(stats.dropped == 3);
+            }
+        }
+    }
+    GIVEN("a queue with capacity 2 that keeps every 3rd payload") {
+        fmo::Queue<int> queue{makeConfig(fmo::QueuePolicy::KEEP_EVERY_KTH, 2, 3), 0};
+        WHEN("8 payloads are sent") {
+            REQUIRE(sendRange(queue, 0, 8) == 4);
+            THEN("every 3rd payload sent to the full queue replaces the oldest one") {
+                REQUIRE(receiveAll(queue) == (std::vector<int>{4, 7}));
+                auto stats = queue.stats();
+                REQUIRE(stats.enqueued == 4);
+                REQUIRE(stats.dropped == 6);
+            }
+        }
+    }
+    GIVEN("a queue that blocks the producer") {
+        fmo::Queue<int> queue{makeConfig(fmo::QueuePolicy::BLOCK, 2), 0};
+        WHEN("a consumer thread receives payloads slower than they are sent") {
+            std::vector<int> received;
+            bool timesValid = true;
+            std::thread consumer([&]() {
+                int value;
+                int64_t enqueueNs;
+                while (queue.swapReceive(value, &enqueueNs)) {
+                    if (enqueueNs > fmo::nanoTime()) { timesValid = false; }
+                    received.push_back(value);
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            });
+            int accepted = sendRange(queue, 0, 50);
+            queue.exit();
+            consumer.join();
+            THEN("no payload is lost") {
+                REQUIRE(accepted == 50);
+                REQUIRE(timesValid);
+                REQUIRE(received.size() == 50);
+                for (int i = 0; i < 50; i++) { REQUIRE(received[i] == i); }
+                auto stats = queue.stats();
+                REQUIRE(stats.dropped == 0);
+                REQUIRE(stats.maxDepth <= 2);
+            }
+        }
+    }
+    GIVEN("a queue after exit() has been called") {
+        fmo::Queue<int> queue{makeConfig(fmo::QueuePolicy::BLOCK, 2), 0};
+        queue.exit();
+        THEN("sending fails and receiving does not block") {
+            int value = 1;
+            REQUIRE(!queue.swapSend(value));
+            REQUIRE(!queue.swapReceive(value));
+        }
+    }
+}
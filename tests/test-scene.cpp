@@ -0,0 +1,232 @@
+#include "../catch/catch.hpp"
+#include <algorithm>
+#include <fmo/algorithm.hpp>
+#include <fmo/scene.hpp>
+#include <sstream>
+
+namespace {
+    /// Reads ground truth written by fmo::writeGroundTruth().
+    std::vector<std::vector<fmo::SpanSet>> readGroundTruth(std::istream& in, fmo::Dims dims) {
+        int width, height, numFrames, offset, numObjects;
+        in >> width >> height >> numFrames >> offset >> numObjects;
+        REQUIRE(width == dims.width);
+        REQUIRE(height == dims.height);
+        REQUIRE(offset == 0);
+
+        std::vector<std::vector<fmo::SpanSet>> frames(numFrames);
+        for (int i = 0; i < numObjects; i++) {
+            int frameNum, numRuns;
+            in >> frameNum >> numRuns;
+            frames.at(frameNum - 1).emplace_back();
+            auto& set = frames.at(frameNum - 1).back();
+            int pos = 0;
+            for (int j = 0; j < numRuns; j++) {
+                int run;
+                in >> run;
+                for (int k = pos; (j % 2 == 1) && k < pos + run; k++) {
+                    set.push_back({k / width, k % width, k % width + 1});
+                }
+                pos += run;
+            }
+            fmo::spanSetNormalize(set);
+        }
+        REQUIRE(bool(in));
+        return frames;
+    }
+
+    bool sameObjects(const std::vector<fmo::SpanSet>& a, const std::vector<fmo::SpanSet>& b) {
+        auto sameSpan = [](const fmo::Span& l, const fmo::Span& r) {
+            return l.y == r.y && l.xBegin == r.xBegin && l.xEnd == r.xEnd;
+        };
+        auto sameSet = [&](const fmo::SpanSet& l, const fmo::SpanSet& r) {
+            return l.size() == r.size() && std::equal(l.begin(), l.end(), r.begin(), sameSpan);
+        };
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), sameSet);
+    }
+
+    bool contains(const fmo::SpanSet& set, int x, int y) {
+        for (auto& span : set) {
+            if (span.y == y && span.xBegin <= x && x < span.xEnd) return true;
+        }
+        return false;
+    }
+}
+
+SCENARIO("generating synthetic scenes", "[scene]") {
+    GIVEN("a configuration with several random objects") {
+        fmo::SceneGenerator::Config config;
+        config.dims = {320, 240};
+        config.numObjects = 3;
+        config.seed = 7;
+        std::vector<fmo::SpanSet> truth1;
+        std::vector<fmo::SpanSet> truth2;
+        fmo::Image image1;
+        fmo::Image image2;
+
+        WHEN("two generators share the configuration") {
+            fmo::SceneGenerator gen1{config};
+            fmo::SceneGenerator gen2{config};
+
+            THEN("the frames and the ground truth are identical") {
+                for (int i = 0; i < 5; i++) {
+                    gen1.next(image1, truth1);
+                    gen2.next(image2, truth2);
+                    REQUIRE(std::equal(image1.begin(), image1.end(), image2.begin()));
+                    REQUIRE(sameObjects(truth1, truth2));
+                    REQUIRE(truth1.size() == 3);
+                }
+                REQUIRE(gen1.frameNum() == 5);
+            }
+        }
+
+        WHEN("one of the generators skips rendering") {
+            fmo::SceneGenerator gen1{config};
+            fmo::SceneGenerator gen2{config};
+
+            THEN("the ground truth is the same") {
+                for (int i = 0; i < 5; i++) {
+                    gen1.next(image1, truth1);
+                    gen2.next(truth2);
+                    REQUIRE(sameObjects(truth1, truth2));
+                }
+            }
+        }
+
+        WHEN("the seed is changed") {
+            fmo::SceneGenerator gen1{config};
+            config.seed = 8;
+            fmo::SceneGenerator gen2{config};
+            gen1.next(image1, truth1);
+            gen2.next(image2, truth2);
+
+            THEN("the frames differ") {
+                REQUIRE(!std::equal(image1.begin(), image1.end(), image2.begin()));
+            }
+        }
+    }
+
+    GIVEN("a flat, noiseless background and a single known object") {
+        fmo::SceneGenerator::Config config;
+        config.dims = {160, 120};
+        config.texture = 0;
+        config.noise = 0;
+        config.objects.push_back({40.f, 60.f, 30.f, 0.f, 6.f, {{255, 255, 255}}});
+        fmo::SceneGenerator gen{config};
+        std::vector<fmo::SpanSet> truth;
+        fmo::Image image;
+        gen.next(image, truth);
+
+        THEN("exactly the pixels covered by the ground truth are altered") {
+            REQUIRE(truth.size() == 1);
+            int numCovered = 0;
+            for (int y = 0; y < config.dims.height; y++) {
+                const uint8_t* row = image.data() + y * image.skip();
+                for (int x = 0; x < config.dims.width; x++) {
+                    bool altered = row[3 * x] != 128;
+                    if (altered) numCovered++;
+                    if (altered) { REQUIRE(contains(truth[0], x, y)); }
+                }
+            }
+            // the blurred disc spans the radius on both sides of a 30-pixel path
+            REQUIRE(fmo::spanSetSize(truth[0]) == Approx(12 * (30 + 3.14f * 3)).epsilon(0.1));
+            REQUIRE(numCovered > fmo::spanSetSize(truth[0]) * 9 / 10);
+        }
+
+        THEN("the object moves by its speed each frame") {
+            REQUIRE(gen.objects()[0].x == Approx(70.f));
+            REQUIRE(gen.objects()[0].y == Approx(60.f));
+        }
+    }
+
+    GIVEN("generators that differ only in the output format") {
+        fmo::SceneGenerator::Config config;
+        config.dims = {320, 240};
+        config.numObjects = 4;
+        config.format = fmo::Format::GRAY;
+        fmo::SceneGenerator gray{config};
+        config.format = fmo::Format::YUV420SP;
+        fmo::SceneGenerator nv21{config};
+        config.format = fmo::Format::P010;
+        fmo::SceneGenerator p010{config};
+        fmo::Image image1;
+        fmo::Image image2;
+        fmo::Image image3;
+        std::vector<fmo::SpanSet> truth;
+        gray.next(image1, truth);
+        nv21.next(image2, truth);
+        p010.next(image3, truth);
+
+        THEN("the luma planes are the same") {
+            REQUIRE(image2.format() == fmo::Format::YUV420SP);
+            REQUIRE(image3.format() == fmo::Format::P010);
+            for (int y = 0; y < config.dims.height; y++) {
+                const uint8_t* row1 = image1.data() + y * image1.skip();
+                const uint8_t* row2 = image2.data() + y * image2.skip();
+                const uint8_t* row3 = image3.data() + y * image3.skip();
+                for (int x = 0; x < config.dims.width; x++) {
+                    REQUIRE(row1[x] == row2[x]);
+                    REQUIRE(row1[x] == row3[2 * x + 1]);
+                }
+            }
+        }
+    }
+
+    GIVEN("the ground truth of a sequence") {
+        fmo::SceneGenerator::Config config;
+        config.dims = {200, 100};
+        config.numObjects = 2;
+        config.maxSpeed = 120.f;
+        fmo::SceneGenerator gen{config};
+        std::vector<std::vector<fmo::SpanSet>> frames(20);
+        for (auto& truth : frames) { gen.next(truth); }
+
+        WHEN("it is written and read back") {
+            std::stringstream stream;
+            fmo::writeGroundTruth(stream, config.dims, frames);
+            auto loaded = readGroundTruth(stream, config.dims);
+
+            THEN("the objects are preserved") {
+                REQUIRE(loaded.size() == frames.size());
+                for (size_t i = 0; i < frames.size(); i++) {
+                    REQUIRE(sameObjects(loaded[i], frames[i]));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("detecting objects in synthetic scenes", "[scene][algorithm]") {
+    GIVEN("a scene with a single fast-moving object") {
+        fmo::SceneGenerator::Config sceneConfig;
+        sceneConfig.dims = {640, 480};
+        sceneConfig.format = fmo::Format::GRAY;
+        sceneConfig.objects.push_back({100.f, 200.f, 40.f, 0.3f, 10.f, {{255, 255, 255}}});
+        fmo::Algorithm::Config config;
+        config.name = "explorer-v3";
+
+        WHEN("it is processed by an algorithm") {
+            fmo::SceneGenerator gen{sceneConfig};
+            auto algorithm = fmo::Algorithm::make(config, fmo::Format::GRAY, sceneConfig.dims);
+            std::vector<std::vector<fmo::SpanSet>> frames;
+            fmo::Image input;
+            fmo::Algorithm::Output output;
+            int numHits = 0;
+
+            for (int i = 0; i < 20; i++) {
+                frames.emplace_back();
+                gen.next(input, frames.back());
+                algorithm->setInputSwap(input);
+                algorithm->getOutput(output);
+                int outFrame = i + algorithm->getOutputOffset();
+                if (outFrame < 0) continue;
+
+                for (auto& detection : output.detections) {
+                    auto center = detection->object.center;
+                    if (contains(frames[outFrame][0], center.x, center.y)) numHits++;
+                }
+            }
+
+            THEN("the object is found in most frames") { REQUIRE(numHits >= 15); }
+        }
+    }
+}
@@ -0,0 +1,184 @@
+#include "../catch/catch.hpp"
+#include <cmath>
+#include <fmo/stats.hpp>
+
+namespace {
+    /// Checks that a value lies within the relative precision of the histogram.
+    bool approx(int64_t value, int64_t expected) {
+        double tolerance = double(expected) / fmo::Histogram::HALF_COUNT;
+        return std::abs(double(value - expected)) <= tolerance;
+    }
+}
+
+SCENARIO("estimating quantiles with a histogram", "[stats]") {
+    GIVEN("an empty histogram") {
+        fmo::Histogram hist;
+        REQUIRE(hist.count() == 0);
+        REQUIRE(hist.quantile(0.5) == 0);
+        REQUIRE(hist.mean() == 0.);
+
+        WHEN("small values are added") {
+            for (int i = 0; i < 100; i++) { hist.add(i); }
+
+            THEN("quantiles are exact") {
+                REQUIRE(hist.count() == 100);
+                REQUIRE(hist.min() == 0);
+                REQUIRE(hist.max() == 99);
+                REQUIRE(hist.mean() == Approx(49.5));
+                REQUIRE(hist.quantile(0.) == 0);
+                REQUIRE(hist.quantile(0.5) == 50);
+                REQUIRE(hist.quantile(0.95) == 95);
+                REQUIRE(hist.quantile(1.) == 99);
+            }
+        }
+
+        WHEN("durations from microseconds to seconds are added") {
+            const int64_t step = 10007;
+            const int num = 100000;
+            for (int i = 1; i <= num; i++) { hist.add(i * step); }
+
+            THEN("quantiles are within the relative precision") {
+                REQUIRE(hist.min() == step);
+                REQUIRE(hist.max() == num * step);
+                REQUIRE(hist.mean() == Approx(step * (num + 1) / 2.));
+                for (double q : {0.01, 0.25, 0.5, 0.9, 0.95, 0.99, 0.999}) {
+                    INFO(q);
+                    int64_t expected = (int64_t(q * num) + 1) * step;
+                    REQUIRE(approx(hist.quantile(q), expected));
+                }
+            }
+        }
+
+        WHEN("values out of range are added") {
+            hist.add(-5);
+            hist.add(int64_t(1) << 50);
+
+            THEN("they are clamped, but min and max are exact") {
+                REQUIRE(hist.min() == -5);
+                REQUIRE(hist.max() == int64_t(1) << 50);
+                REQUIRE(hist.quantile(0.) == 0);
+                REQUIRE(hist.quantile(1.) == int64_t(1) << 50);
+            }
+        }
+    }
+}
+
+SCENARIO("merging and decaying histograms", "[stats]") {
+    GIVEN("two histograms filled with disjoint halves of a sequence") {
+        fmo::Histogram hist1;
+        fmo::Histogram hist2;
+        fmo::Histogram whole;
+        for (int i = 0; i < 2000; i++) {
+            int64_t value = 1000 + 37 * i;
+            whole.add(value);
+            ((i % 2 == 0) ? hist1 : hist2).add(value);
+        }
+
+        WHEN("they are merged") {
+            hist1.merge(hist2);
+
+            THEN("the result is identical to a single histogram") {
+                REQUIRE(hist1.count() == whole.count());
+                REQUIRE(hist1.min() == whole.min());
+                REQUIRE(hist1.max() == whole.max());
+                REQUIRE(hist1.mean() == Approx(whole.mean()));
+                for (double q : {0.1, 0.5, 0.95, 0.99}) {
+                    INFO(q);
+                    REQUIRE(hist1.quantile(q) == whole.quantile(q));
+                }
+            }
+        }
+
+        WHEN("a histogram is decayed") {
+            whole.decay();
+
+            THEN("half of the samples remain") {
+                REQUIRE(whole.count() <= 1000);
+                REQUIRE(whole.count() >= 999);
+                REQUIRE(whole.min() >= 1000);
+                REQUIRE(whole.max() <= 1000 + 37 * 1999);
+                REQUIRE(approx(whole.quantile(0.5), 1000 + 37 * 1000));
+            }
+        }
+
+        WHEN("a histogram is cleared") {
+            whole.clear();
+
+            THEN("it is empty") {
+                REQUIRE(whole.count() == 0);
+                REQUIRE(whole.quantile(0.5) == 0);
+                whole.add(42);
+                REQUIRE(whole.min() == 42);
+                REQUIRE(whole.max() == 42);
+            }
+        }
+    }
+}
+
+SCENARIO("updating quantiles periodically", "[stats]") {
+    GIVEN("a Stats object") {
+        fmo::Stats stats{100, 10};
+        stats.reset(7);
+        REQUIRE(stats.quantiles().q50 == 7);
+
+        THEN("quantiles are updated after each period, following recent samples") {
+            int numUpdates = 0;
+            for (int i = 0; i < 10 + 100; i++) { numUpdates += stats.add(1000000) ? 1 : 0; }
+            REQUIRE(numUpdates == 1);
+            REQUIRE(approx(stats.quantiles().q50, 1000000));
+
+            for (int i = 0; i < 1000; i++) { numUpdates += stats.add(3000000) ? 1 : 0; }
+            REQUIRE(numUpdates == 11);
+            REQUIRE(approx(stats.quantiles().q50, 3000000));
+            REQUIRE(approx(stats.quantiles().q99, 3000000));
+            REQUIRE(stats.histogram().count() <= 200);
+        }
+    }
+}
+
+SCENARIO("comparing samples with the Mann-Whitney U test", "[stats]") {
+    GIVEN("two sets of samples") {
+        std::vector<int64_t> a;
+        std::vector<int64_t> b;
+
+        WHEN("the sets do not overlap") {
+            a = {1, 2, 3, 4, 5};
+            b = {6, 7, 8, 9, 10};
+
+            THEN("the p-value matches the normal approximation") {
+                REQUIRE(fmo::mannWhitneyP(a, b) == Approx(0.0122).epsilon(0.01));
+                REQUIRE(fmo::mannWhitneyP(b, a) == Approx(0.0122).epsilon(0.01));
+            }
+        }
+
+        WHEN("the sets are drawn from the same distribution") {
+            for (int i = 0; i < 200; i++) {
+                a.push_back((i * 37) % 101);
+                b.push_back((i * 53 + 7) % 101);
+            }
+
+            THEN("the difference is not significant") { REQUIRE(fmo::mannWhitneyP(a, b) > 0.1); }
+        }
+
+        WHEN("one set is shifted by a few percent and contains outliers") {
+            for (int i = 0; i < 200; i++) {
+                a.push_back(1000 + (i * 37) % 101);
+                b.push_back(1040 + (i * 53 + 7) % 101);
+            }
+            a[0] = 1000000;
+            a[1] = 2000000;
+
+            THEN("the difference is significant") { REQUIRE(fmo::mannWhitneyP(a, b) < 1e-6); }
+        }
+
+        WHEN("all samples are equal or a set is empty") {
+            a = {5, 5, 5};
+            b = {5, 5};
+
+            THEN("the p-value is one") {
+                REQUIRE(fmo::mannWhitneyP(a, b) == 1.);
+                REQUIRE(fmo::mannWhitneyP(a, {}) == 1.);
+            }
+        }
+    }
+}
@@ -1,9 +1,21 @@
 #ifndef FMO_TEST_TOOLS_HPP
 #define FMO_TEST_TOOLS_HPP
 
+#include <cstdio>
+#include <cstdlib>
 #include <fmo/common.hpp>
 #include <fmo/image.hpp>
 #include <fmo/processing.hpp>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#include <direct.h>
+#include <io.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
 
 template <typename Lhs, typename Rhs>
 bool exact_match(const Lhs& lhs, const Rhs& rhs) {
@@ -28,4 +40,62 @@ inline bool match_percent(const fmo::Image& lhs, const fmo::Image& rhs, double r
     return percent > require;
 }
 
+/// A new, uniquely named directory in the temporary directory of the system. The directory is
+/// removed together with the files inside once the object goes out of scope, so that the files are
+/// cleaned up even if a test fails.
+struct TempDir {
+    TempDir(const TempDir&) = delete;
+    TempDir& operator=(const TempDir&) = delete;
+
+    TempDir() {
+#if defined(_WIN32)
+        const char* base = std::getenv("TEMP");
+        std::string pattern = std::string((base != nullptr) ? base : ".") + "\\fmo-test-XXXXXX";
+        if (_mktemp_s(&pattern[0], pattern.size() + 1) != 0 || _mkdir(pattern.c_str()) != 0) {
+            throw std::runtime_error("failed to create a temporary directory");
+        }
+        mPath = pattern;
+#else
+        const char* base = std::getenv("TMPDIR");
+        std::string pattern = std::string((base != nullptr) ? base : "/tmp") + "/fmo-test-XXXXXX";
+        if (mkdtemp(&pattern[0]) == nullptr) {
+            throw std::runtime_error("failed to create a temporary directory");
+        }
+        mPath = pattern;
+#endif
+    }
+
+    ~TempDir() {
+#if defined(_WIN32)
+        _finddata_t entry;
+        intptr_t handle = _findfirst((mPath + "\\*").c_str(), &entry);
+        if (handle != -1) {
+            do {
+                if ((entry.attrib & _A_SUBDIR) == 0) {
+                    std::remove((mPath + "\\" + entry.name).c_str());
+                }
+            } while (_findnext(handle, &entry) == 0);
+            _findclose(handle);
+        }
+        _rmdir(mPath.c_str());
+#else
+        DIR* dir = opendir(mPath.c_str());
+        if (dir != nullptr) {
+            while (dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name != "." && name != "..") std::remove((mPath + "/" + name).c_str());
+            }
+            closedir(dir);
+        }
+        rmdir(mPath.c_str());
+#endif
+    }
+
+    /// Provides the path to the directory, without a trailing separator.
+    const std::string& path() const { return mPath; }
+
+private:
+    std::string mPath;
+};
+
 #endif // FMO_TEST_TOOLS_HPP
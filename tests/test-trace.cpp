@@ -0,0 +1,72 @@
+#include "../catch/catch.hpp"
+#include <fmo/profiler.hpp>
+#include <fmo/trace.hpp>
+#include <sstream>
+#include <thread>
+
+SCENARIO("recording trace spans", "[trace]") {
+    GIVEN("a cleared trace") {
+        fmo::Trace::enable(false);
+        fmo::Trace::clear();
+        REQUIRE(fmo::Trace::numEvents() == 0);
+
+        WHEN("spans are created while tracing is disabled") {
+            { fmo::TraceSpan span{"disabled"}; }
+
+            THEN("nothing is recorded") { REQUIRE(fmo::Trace::numEvents() == 0); }
+        }
+
+        WHEN("spans are created in two threads while tracing is enabled") {
+            fmo::Trace::enable(true);
+            auto work = []() {
+                for (int i = 0; i < 10; i++) { fmo::TraceSpan span{"work \"quoted\""}; }
+            };
+            std::thread thread{work};
+            work();
+            thread.join();
+            fmo::Trace::enable(false);
+
+            THEN("all spans are exported") {
+                REQUIRE(fmo::Trace::numEvents() == 20);
+                std::ostringstream out;
+                fmo::Trace::writeJson(out);
+                std::string json = out.str();
+                REQUIRE(json.find("{\"traceEvents\":[") == 0);
+                REQUIRE(json.find("\"name\":\"work \\\"quoted\\\"\"") != std::string::npos);
+                REQUIRE(json.find("\"ph\":\"X\"") != std::string::npos);
+                REQUIRE(json.find("\"dur\":-") == std::string::npos);
+                REQUIRE(json.rfind("]") != std::string::npos);
+            }
+        }
+
+        WHEN("more spans than the capacity are recorded") {
+            fmo::Trace::enable(true);
+            for (size_t i = 0; i < fmo::Trace::CAPACITY + 10; i++) {
+                fmo::Trace::record("overflow", 0, 1);
+            }
+            fmo::Trace::enable(false);
+
+            THEN("only the most recent spans are retained") {
+                REQUIRE(fmo::Trace::numEvents() == fmo::Trace::CAPACITY);
+            }
+        }
+
+        WHEN("a disabled profiler runs while tracing is enabled") {
+            fmo::Profiler profiler;
+            profiler.setStages({"first", "second"});
+            fmo::Trace::enable(true);
+            profiler.start();
+            profiler.lap();
+            profiler.lap();
+            profiler.stop();
+            fmo::Trace::enable(false);
+
+            THEN("each stage and the total is recorded, but not measured") {
+                REQUIRE(fmo::Trace::numEvents() == 3);
+                REQUIRE(profiler.totalQuantilesMs().q50 == 0.f);
+            }
+        }
+
+        fmo::Trace::clear();
+    }
+}